@@ -0,0 +1,369 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+// Benchmark & consistency check for the ways the 'events' section may be read.
+// A synthetic scenario is generated, then parsed with JSON objects built for each event (the DOM path),
+// with the events decoded from the parser callbacks (the `EventDecoder` path),
+// and with the events read from the scenario cache.
+// The fastest of several runs is reported for each, and the resulting events are compared.
+//
+// Usage: parser-bench [event count] [runs]
+
+#include "file-parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <variant>
+
+namespace {
+
+/**
+ * Write a scenario with `count` events, using a mix of every event type the parser decodes
+ *
+ * @param path
+ * Where to write the scenario
+ *
+ * @param count
+ * The number of events to generate
+ */
+void generate(const std::filesystem::path &path, std::size_t count) {
+  std::mt19937 random{42u};
+  std::uniform_real_distribution<double> unit{0.0, 1.0};
+  std::uniform_int_distribution<int> nodeId{0, 9};
+  std::uniform_int_distribution<int> colorComponent{0, 255};
+  std::uniform_int_distribution<int> step{0, 3};
+  std::uniform_int_distribution<int> type{0, 15};
+
+  const auto color = [&]() {
+    std::ostringstream out;
+    out << R"({"red":)" << colorComponent(random) << R"(,"green":)" << colorComponent(random) << R"(,"blue":)"
+        << colorComponent(random) << '}';
+    return out.str();
+  };
+
+  std::ofstream out{path};
+  out.precision(17);
+
+  long long time = 0LL;
+  out << R"({"configuration":{"module-version":{"major":1,"minor":0,"patch":14}},"nodes":[)";
+  for (auto i = 0; i < 10; i++) {
+    if (i > 0)
+      out << ',';
+    out << R"({"id":)" << i << R"(,"name":"node )" << i
+        << R"(","model":"a.obj","scale":1,"orientation":{"x":0,"y":0,"z":0},"visible":true,)"
+           R"("position":{"x":0,"y":0,"z":0}})";
+  }
+  out << R"(],"streams":[{"id":1,"name":"stream","visible":true}],"events":[)";
+
+  for (std::size_t i = 0; i < count; i++) {
+    if (i > 0)
+      out << ",\n";
+    time += step(random) * 1000LL;
+    const auto id = nodeId(random);
+
+    switch (type(random)) {
+    case 0:
+    case 1:
+    case 2:
+      out << R"({"type":"node-position","nanoseconds":)" << time << R"(,"id":)" << id << R"(,"x":)" << unit(random)
+          << R"(,"y":)" << unit(random) << R"(,"z":)" << unit(random) << '}';
+      break;
+    case 3:
+      out << R"({"type":"node-model-change","nanoseconds":)" << time << R"(,"id":)" << id << R"(,"model":")"
+          << (unit(random) < 0.5 ? "a.obj" : "b.obj") << "\"}";
+      break;
+    case 4:
+      out << R"({"type":"node-orientation","nanoseconds":)" << time << R"(,"id":)" << id << R"(,"x":1.5,"y":)"
+          << unit(random) << R"(,"z":3})";
+      break;
+    case 5:
+      out << R"({"type":"node-color","nanoseconds":)" << time << R"(,"id":)" << id << R"(,"color-type":")"
+          << (unit(random) < 0.5 ? "base" : "highlight") << '"';
+      if (unit(random) < 0.7)
+        out << R"(,"color":)" << color();
+      out << '}';
+      break;
+    case 6:
+      out << R"({"type":"node-transmit","nanoseconds":)" << time << R"(,"id":)" << id << R"(,"duration":)"
+          << (1 + id * 1000) << R"(,"target-size":2.5,"color":)" << color() << '}';
+      break;
+    case 7:
+      out << R"({"type":"decoration-position","nanoseconds":)" << time << R"(,"id":1,"x":1,"y":2,"z":3})";
+      break;
+    case 8:
+      out << R"({"type":"decoration-orientation","nanoseconds":)" << time << R"(,"id":1,"x":1,"y":2,"z":3})";
+      break;
+    case 9:
+      out << R"({"type":"xy-series-append","nanoseconds":)" << time << R"(,"series-id":1,"x":)" << unit(random)
+          << R"(,"y":)" << unit(random) << '}';
+      break;
+    case 10:
+      out << R"({"type":"xy-series-append-array","nanoseconds":)" << time << R"(,"series-id":1,"points":[)";
+      for (auto p = 0; p <= id % 4; p++) {
+        if (p > 0)
+          out << ',';
+        out << R"({"x":)" << unit(random) << R"(,"y":)" << unit(random) << '}';
+      }
+      out << "]}";
+      break;
+    case 11:
+      out << R"({"type":"xy-series-clear","nanoseconds":)" << time << R"(,"series-id":1})";
+      break;
+    case 12:
+      out << R"({"type":"category-series-append","nanoseconds":)" << time << R"(,"series-id":2,"category":1,"value":)"
+          << unit(random) << '}';
+      break;
+    case 13:
+      out << R"({"type":"stream-append","nanoseconds":)" << time << R"(,"stream-id":1,"data":"line )" << i
+          << R"( [\"quoted\"]\n"})";
+      break;
+    case 14:
+      out << R"({"type":"logical-link-create","nanoseconds":)" << time << R"(,"link-id":)" << id % 4
+          << R"(,"nodes":[1,2],"active":true,"diameter":0.5,"color":)" << color() << '}';
+      break;
+    default:
+      out << R"({"type":"logical-link-update","nanoseconds":)" << time << R"(,"link-id":)" << id % 4
+          << R"(,"nodes":[1,2],"active":false,"diameter":0.25,"color":)" << color() << '}';
+      break;
+    }
+  }
+
+  out << "]}\n";
+}
+
+void write(std::ostream &out, const parser::Ns3Color3 &color) {
+  out << ' ' << static_cast<int>(color.red) << ' ' << static_cast<int>(color.green) << ' '
+      << static_cast<int>(color.blue);
+}
+
+/**
+ * Writes every field of an event, so two runs may be compared as text
+ */
+struct EventWriter {
+  std::ostream &out;
+
+  void operator()(const parser::MoveEvent &e) {
+    out << "move " << e.time << ' ' << e.nodeId << ' ' << e.targetPosition.x << ' ' << e.targetPosition.y << ' '
+        << e.targetPosition.z;
+  }
+
+  void operator()(const parser::NodeModelChangeEvent &e) {
+    out << "model " << e.time << ' ' << e.nodeId << ' ' << e.model;
+  }
+
+  void operator()(const parser::TransmitEvent &e) {
+    out << "transmit " << e.time << ' ' << e.nodeId << ' ' << e.duration << ' ' << e.targetSize;
+    write(out, e.color);
+  }
+
+  void operator()(const parser::TransmitEndEvent &e) {
+    out << "transmit-end " << e.time << ' ' << e.nodeId << ' ';
+    (*this)(e.startEvent);
+  }
+
+  void operator()(const parser::DecorationMoveEvent &e) {
+    out << "decoration-move " << e.time << ' ' << e.decorationId << ' ' << e.targetPosition.x << ' '
+        << e.targetPosition.y << ' ' << e.targetPosition.z;
+  }
+
+  void operator()(const parser::NodeOrientationChangeEvent &e) {
+    out << "orientation " << e.time << ' ' << e.nodeId << ' ' << e.targetOrientation[0] << ' '
+        << e.targetOrientation[1] << ' ' << e.targetOrientation[2];
+  }
+
+  void operator()(const parser::DecorationOrientationChangeEvent &e) {
+    out << "decoration-orientation " << e.time << ' ' << e.decorationId << ' ' << e.targetOrientation[0] << ' '
+        << e.targetOrientation[1] << ' ' << e.targetOrientation[2];
+  }
+
+  void operator()(const parser::NodeColorChangeEvent &e) {
+    out << "color " << e.time << ' ' << e.nodeId << ' ' << static_cast<int>(e.type);
+    if (e.targetColor)
+      write(out, *e.targetColor);
+  }
+
+  void operator()(const parser::LogicalLinkCreate &e) {
+    out << "link-create " << e.time << ' ' << e.model.id << ' ' << e.model.nodes.first << ' ' << e.model.nodes.second
+        << ' ' << e.model.active << ' ' << e.model.diameter;
+    write(out, e.model.color);
+  }
+
+  void operator()(const parser::LogicalLinkUpdate &e) {
+    out << "link-update " << e.time << ' ' << e.id << ' ' << e.nodes.first << ' ' << e.nodes.second << ' '
+        << e.active << ' ' << e.diameter;
+    write(out, e.color);
+  }
+
+  void operator()(const parser::XYSeriesAddValue &e) {
+    out << "xy " << e.time << ' ' << e.seriesId << ' ' << e.point.x << ' ' << e.point.y;
+  }
+
+  void operator()(const parser::XYSeriesAddValues &e) {
+    out << "xy-values " << e.time << ' ' << e.seriesId;
+    for (const auto &point : e.points)
+      out << ' ' << point.x << ' ' << point.y;
+  }
+
+  void operator()(const parser::XYSeriesClear &e) {
+    out << "xy-clear " << e.time << ' ' << e.seriesId;
+  }
+
+  void operator()(const parser::CategorySeriesAddValue &e) {
+    out << "category " << e.time << ' ' << e.seriesId << ' ' << e.category << ' ' << e.value;
+  }
+
+  void operator()(const parser::StreamAppendEvent &e) {
+    out << "stream " << e.time << ' ' << e.streamId << ' ' << e.value;
+  }
+};
+
+/**
+ * Serialize the events produced by a parse, in order
+ */
+std::string serialize(const parser::FileParser &fileParser) {
+  std::ostringstream out;
+  out.precision(17);
+  EventWriter writer{out};
+
+  for (const auto &event : fileParser.getSceneEvents()) {
+    std::visit(writer, event);
+    out << '\n';
+  }
+  for (const auto &event : fileParser.getChartsEvents()) {
+    std::visit(writer, event);
+    out << '\n';
+  }
+  for (const auto &event : fileParser.getLogEvents()) {
+    std::visit(writer, event);
+    out << '\n';
+  }
+
+  return out.str();
+}
+
+struct Result {
+  double milliseconds;
+  std::string events;
+};
+
+/**
+ * Parse `path` `runs` times, after `configure` sets up the parser
+ *
+ * @return
+ * The fastest run, and the events it produced.
+ * `std::nullopt` if the parse failed
+ */
+std::optional<Result> run(const std::filesystem::path &path, int runs,
+                          const std::function<void(parser::FileParser &)> &configure) {
+  Result result{std::numeric_limits<double>::max(), {}};
+
+  for (auto i = 0; i < runs; i++) {
+    parser::FileParser fileParser;
+    configure(fileParser);
+
+    const auto begin = std::chrono::steady_clock::now();
+    const auto error = fileParser.parse(path.string().c_str());
+    const auto end = std::chrono::steady_clock::now();
+
+    if (error) {
+      std::fprintf(stderr, "Parse failed: %s (offset %zu)\n", error->message.c_str(), error->offset);
+      return {};
+    }
+
+    result.milliseconds =
+        std::min(result.milliseconds, std::chrono::duration<double, std::milli>(end - begin).count());
+    if (i == 0)
+      result.events = serialize(fileParser);
+  }
+
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500'000u;
+  const int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 3;
+
+  const auto path = std::filesystem::temp_directory_path() / "netsimulyzer-parser-bench.json";
+  generate(path, count);
+  std::printf("%zu events, %.1f MiB, best of %d runs\n", count,
+              static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0), runs);
+
+  const auto dom = run(path, runs, [](parser::FileParser &p) {
+    p.setStreamEvents(false);
+  });
+  const auto decoder = run(path, runs, [](parser::FileParser &p) {
+    p.setStreamEvents(true);
+  });
+
+  // Written by the first parse, so it is not part of the timed runs
+  const auto cacheDirectory = std::filesystem::temp_directory_path() / "netsimulyzer-parser-bench-cache";
+  const auto cacheConfigure = [&cacheDirectory](parser::FileParser &p) {
+    p.setCacheDirectory(cacheDirectory);
+  };
+  const auto cacheWrite = run(path, 1, cacheConfigure);
+  const auto cached = run(path, runs, cacheConfigure);
+
+  std::filesystem::remove(path);
+  std::filesystem::remove_all(cacheDirectory);
+  if (!dom || !decoder || !cacheWrite || !cached)
+    return EXIT_FAILURE;
+
+  std::printf("DOM:          %9.1f ms\n", dom->milliseconds);
+  std::printf("EventDecoder: %9.1f ms (%.2fx)\n", decoder->milliseconds, dom->milliseconds / decoder->milliseconds);
+  std::printf("Cached:       %9.1f ms (%.2fx DOM, %.2fx EventDecoder)\n", cached->milliseconds,
+              dom->milliseconds / cached->milliseconds, decoder->milliseconds / cached->milliseconds);
+
+  if (dom->events != decoder->events) {
+    std::fprintf(stderr, "EventDecoder events differ from the DOM events\n");
+    return EXIT_FAILURE;
+  }
+
+  if (dom->events != cached->events) {
+    std::fprintf(stderr, "Cached events differ from the DOM events\n");
+    return EXIT_FAILURE;
+  }
+
+  std::printf("Events match\n");
+  return EXIT_SUCCESS;
+}
@@ -31,98 +31,455 @@
  * Author: Evan Black <evan.black@nist.gov>
  */
 #include "file-parser.h"
+#include "handler/EventDecoder.h"
 #include "handler/JsonHandler.h"
+#include "mapped-file.h"
+#include "scenario-cache.h"
 #include <algorithm>
+#include <cassert>
 #include <cstdio>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <rapidjson/filereadstream.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/reader.h>
+#include <string_view>
+#include <utility>
 
-namespace parser {
-
-std::optional<ParseError> FileParser::parse(const char *path) {
+namespace {
 
-  // RapidJSON prefers FILE*, so this is a safe wrapper for that
-  // Add a 'b' in the mode flags to keep Windows from stupid handling of newlines
-  std::unique_ptr<FILE, decltype(&std::fclose)> file{std::fopen(path, "rb"), std::fclose};
+/**
+ * Convert an error from the JSON reader into a `ParseError`
+ *
+ * @param code
+ * The error code from the reader
+ *
+ * @param offset
+ * Where in the file the error occurred
+ *
+ * @param handlerMessage
+ * The message set by the handler, used when it stopped the parse
+ *
+ * @return
+ * The error to report for the file
+ */
+parser::ParseError makeParseError(rapidjson::ParseErrorCode code, std::size_t offset,
+                                  const std::optional<std::string> &handlerMessage) {
+  parser::ParseError error;
+  error.offset = offset;
 
-  if (!file) {
-    std::cerr << "Failed to open file: " << path << '\n';
-    return {ParseError{"Failed to open file", 0u}};
+  switch (code) {
+    // Error from the `JsonHandler`
+  case rapidjson::kParseErrorTermination:
+    error.message = handlerMessage.value_or("Unknown parsing error");
+    break;
+    // Generic Errors
+  case rapidjson::kParseErrorDocumentEmpty:
+    error.message = "Document empty";
+    break;
+  case rapidjson::kParseErrorDocumentRootNotSingular:
+    error.message = "More than one root element";
+    break;
+  case rapidjson::kParseErrorValueInvalid:
+    error.message = "Invalid value";
+    break;
+  case rapidjson::kParseErrorObjectMissName:
+    error.message = "Object member missing name";
+    break;
+  case rapidjson::kParseErrorObjectMissColon:
+    error.message = "Object property missing colon";
+    break;
+  case rapidjson::kParseErrorObjectMissCommaOrCurlyBracket:
+    error.message = "Missing comma or curly brace after object member";
+    break;
+  case rapidjson::kParseErrorArrayMissCommaOrSquareBracket:
+    error.message = "Missing comma or curly brace after array element";
+    break;
+  case rapidjson::kParseErrorStringUnicodeEscapeInvalidHex:
+    error.message = "Invalid Unicode escape sequence";
+    break;
+  case rapidjson::kParseErrorStringUnicodeSurrogateInvalid:
+    error.message = "Invalid Unicode surrogate pair";
+    break;
+  case rapidjson::kParseErrorStringEscapeInvalid:
+    error.message = "Invalid character escape sequence";
+    break;
+  case rapidjson::kParseErrorStringMissQuotationMark:
+    error.message = "Missing string quotation mark";
+    break;
+  case rapidjson::kParseErrorStringInvalidEncoding:
+    error.message = "Invalid string encoding";
+    break;
+  case rapidjson::kParseErrorNumberTooBig:
+    error.message = "Number too large to be stored in a double";
+    break;
+  case rapidjson::kParseErrorNumberMissFraction:
+    error.message = "Number missing fraction component";
+    break;
+  case rapidjson::kParseErrorNumberMissExponent:
+    error.message = "Number missing exponent component";
+    break;
+  case rapidjson::kParseErrorUnspecificSyntaxError:
+  default:
+    error.message = "Unspecific syntax error";
+    break;
   }
 
-  // Mostly arbitrary buffer size
-  char buffer[65536];
-  rapidjson::FileReadStream stream{file.get(), buffer, sizeof(buffer)};
+  return error;
+}
 
-  JsonHandler handler{*this};
-  rapidjson::Reader reader;
+/**
+ * Location of the top level 'events' array in a document
+ */
+struct EventsLayout {
+  /**
+   * Offset of the first character after the '['
+   */
+  std::size_t begin;
 
-  reader.Parse(stream, handler);
+  /**
+   * Offset of the closing ']'
+   */
+  std::size_t end;
 
-  if (reader.HasParseError()) {
-    ParseError error;
-    error.offset = reader.GetErrorOffset();
+  /**
+   * Offsets splitting the array contents into runs of whole elements.
+   * Each is just after a separating ','
+   */
+  std::vector<std::size_t> splits;
+};
 
-    switch (reader.GetParseErrorCode()) {
-      // Error from the `JsonHandler`
-    case rapidjson::kParseErrorTermination:
-      error.message = errorMessage.value_or("Unknown parsing error");
-      break;
-      // Generic Errors
-    case rapidjson::kParseErrorDocumentEmpty:
-      error.message = "Document empty";
-      break;
-    case rapidjson::kParseErrorDocumentRootNotSingular:
-      error.message = "More than one root element";
-      break;
-    case rapidjson::kParseErrorValueInvalid:
-      error.message = "Invalid value";
-      break;
-    case rapidjson::kParseErrorObjectMissName:
-      error.message = "Object member missing name";
-      break;
-    case rapidjson::kParseErrorObjectMissColon:
-      error.message = "Object property missing colon";
-      break;
-    case rapidjson::kParseErrorObjectMissCommaOrCurlyBracket:
-      error.message = "Missing comma or curly brace after object member";
-      break;
-    case rapidjson::kParseErrorArrayMissCommaOrSquareBracket:
-      error.message = "Missing comma or curly brace after array element";
-      break;
-    case rapidjson::kParseErrorStringUnicodeEscapeInvalidHex:
-      error.message = "Invalid Unicode escape sequence";
-      break;
-    case rapidjson::kParseErrorStringUnicodeSurrogateInvalid:
-      error.message = "Invalid Unicode surrogate pair";
-      break;
-    case rapidjson::kParseErrorStringEscapeInvalid:
-      error.message = "Invalid character escape sequence";
-      break;
-    case rapidjson::kParseErrorStringMissQuotationMark:
-      error.message = "Missing string quotation mark";
+/**
+ * Find the top level 'events' array in `data`,
+ * and split its contents into about `chunks` runs of elements.
+ *
+ * Only tracks strings & nesting, so it is much cheaper than a full parse.
+ * Malformed documents are left for the real parse to report.
+ *
+ * @param data
+ * The document to search
+ *
+ * @param size
+ * The length of `data`
+ *
+ * @param chunks
+ * The number of runs to split the array into
+ *
+ * @return
+ * The layout of the array, or an empty optional if it was not found
+ */
+std::optional<EventsLayout> findEvents(const char *data, std::size_t size, unsigned int chunks) {
+  EventsLayout layout{};
+  std::string_view lastKey;
+  bool inEvents = false;
+  std::size_t chunkSize = 0u;
+  std::size_t chunkStart = 0u;
+  int depth = 0;
+
+  for (std::size_t i = 0u; i < size; i++) {
+    switch (data[i]) {
+    case '"': {
+      const auto stringStart = i + 1;
+      for (i = stringStart; i < size && data[i] != '"'; i++) {
+        if (data[i] == '\\')
+          i++;
+      }
+
+      // Keys of the root object
+      if (depth == 1)
+        lastKey = std::string_view{data + stringStart, std::min(i, size) - stringStart};
+    } break;
+    case '{':
+      depth++;
       break;
-    case rapidjson::kParseErrorStringInvalidEncoding:
-      error.message = "Invalid string encoding";
+    case '[':
+      depth++;
+      if (depth == 2 && lastKey == "events") {
+        inEvents = true;
+        layout.begin = i + 1;
+        chunkStart = layout.begin;
+
+        // Assume the events make up the rest of the file,
+        // which is close for most scenarios
+        chunkSize = (size - layout.begin) / chunks;
+      }
       break;
-    case rapidjson::kParseErrorNumberTooBig:
-      error.message = "Number too large to be stored in a double";
+    case '}':
+      depth--;
       break;
-    case rapidjson::kParseErrorNumberMissFraction:
-      error.message = "Number missing fraction component";
+    case ']':
+      depth--;
+      if (inEvents && depth == 1) {
+        layout.end = i;
+        return {layout};
+      }
       break;
-    case rapidjson::kParseErrorNumberMissExponent:
-      error.message = "Number missing exponent component";
+    case ',':
+      if (inEvents && depth == 2 && i + 1 - chunkStart >= chunkSize) {
+        chunkStart = i + 1;
+        layout.splits.emplace_back(chunkStart);
+      }
       break;
-    case rapidjson::kParseErrorUnspecificSyntaxError:
     default:
-      error.message = "Unspecific syntax error";
       break;
     }
+  }
+
+  return {};
+}
+
+/**
+ * Handler for a run of elements from the 'events' array.
+ * Decodes each into `events`, without any of the
+ * bookkeeping in `JsonHandler`, so runs may be read independently
+ */
+class EventRunHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, EventRunHandler> {
+  EventDecoder decoder;
+
+public:
+  std::vector<EventDecoder::DecodedEvent> events;
+  std::optional<std::string> errorMessage;
+
+  // Values directly in the array are ignored,
+  // the same as in `JsonHandler`
+  bool Default() {
+    return true;
+  }
+
+  bool Null() {
+    if (decoder.isDecoding())
+      decoder.Null();
+    return true;
+  }
+
+  bool Bool(bool value) {
+    if (decoder.isDecoding())
+      decoder.Bool(value);
+    return true;
+  }
+
+  bool Int(int value) {
+    if (decoder.isDecoding())
+      decoder.Int(value);
+    return true;
+  }
+
+  bool Uint(unsigned int value) {
+    if (decoder.isDecoding())
+      decoder.Uint(value);
+    return true;
+  }
+
+  bool Int64(std::int64_t value) {
+    if (decoder.isDecoding())
+      decoder.Int64(value);
+    return true;
+  }
+
+  bool Uint64(std::uint64_t value) {
+    if (decoder.isDecoding())
+      decoder.Uint64(value);
+    return true;
+  }
+
+  bool Double(double value) {
+    if (decoder.isDecoding())
+      decoder.Double(value);
+    return true;
+  }
+
+  bool String(const char *value, rapidjson::SizeType length, bool) {
+    if (decoder.isDecoding())
+      decoder.String(value, length);
+    return true;
+  }
+
+  bool StartObject() {
+    decoder.StartObject();
+    return true;
+  }
+
+  bool Key(const char *value, rapidjson::SizeType length, bool) {
+    decoder.Key(value, length);
+    return true;
+  }
+
+  bool EndObject(rapidjson::SizeType) {
+    if (!decoder.EndObject()) {
+      errorMessage = decoder.error();
+      return false;
+    }
+
+    if (!decoder.isDecoding()) {
+      auto event = decoder.take();
+      if (event)
+        events.emplace_back(std::move(event.value()));
+    }
+    return true;
+  }
+
+  bool StartArray() {
+    if (!decoder.isDecoding()) {
+      errorMessage = "Unexpected array in 'events'";
+      return false;
+    }
 
-    return {error};
+    decoder.StartArray();
+    return true;
+  }
+
+  bool EndArray(rapidjson::SizeType) {
+    decoder.EndArray();
+    return true;
+  }
+};
+
+/**
+ * The result of reading one run of the 'events' array
+ */
+struct EventRun {
+  std::vector<EventDecoder::DecodedEvent> events;
+  std::optional<parser::ParseError> error;
+};
+
+bool isWhitespace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * Decode the elements in `data[begin, end)`
+ *
+ * @param data
+ * The whole document
+ *
+ * @param begin
+ * Offset of the first element in the run
+ *
+ * @param end
+ * Offset just past the last element, and its separating ',' if any
+ *
+ * @param last
+ * If this is the final run in the array,
+ * which may not end in a ','
+ *
+ * @return
+ * The decoded events, or the first error in the run
+ */
+EventRun parseEventRun(const char *data, std::size_t begin, std::size_t end, bool last) {
+  EventRun run;
+  rapidjson::MemoryStream stream{data + begin, end - begin};
+  EventRunHandler handler;
+  rapidjson::Reader reader;
+
+  const auto length = end - begin;
+  const auto skipWhitespace = [&stream, length]() {
+    while (stream.Tell() < length && isWhitespace(stream.Peek()))
+      stream.Take();
+  };
+
+  skipWhitespace();
+  while (stream.Tell() < length) {
+    reader.Parse<rapidjson::kParseStopWhenDoneFlag>(stream, handler);
+    if (reader.HasParseError()) {
+      run.error = makeParseError(reader.GetParseErrorCode(), begin + reader.GetErrorOffset(), handler.errorMessage);
+      return run;
+    }
+
+    skipWhitespace();
+    if (stream.Tell() == length)
+      break;
+
+    if (stream.Peek() != ',') {
+      run.error = makeParseError(rapidjson::kParseErrorArrayMissCommaOrSquareBracket, begin + stream.Tell(), {});
+      return run;
+    }
+    stream.Take();
+    skipWhitespace();
+
+    // Trailing ',' before the ']'
+    if (last && stream.Tell() == length) {
+      run.error = makeParseError(rapidjson::kParseErrorValueInvalid, begin + stream.Tell(), {});
+      return run;
+    }
+  }
+
+  run.events = std::move(handler.events);
+  return run;
+}
+
+/**
+ * Input stream over a document in memory,
+ * which skips over the contents of one range
+ */
+class SkipRangeStream {
+  const char *data;
+  std::size_t size;
+  std::size_t skipBegin;
+  std::size_t skipEnd;
+  std::size_t position{0u};
+
+public:
+  typedef char Ch;
+
+  SkipRangeStream(const char *data, std::size_t size, std::size_t skipBegin, std::size_t skipEnd)
+      : data(data), size(size), skipBegin(skipBegin), skipEnd(skipEnd) {
+  }
+
+  [[nodiscard]] Ch Peek() const {
+    return position < size ? data[position] : '\0';
+  }
+
+  Ch Take() {
+    const auto c = Peek();
+    position++;
+    if (position == skipBegin)
+      position = skipEnd;
+    return c;
+  }
+
+  [[nodiscard]] std::size_t Tell() const {
+    return position;
+  }
+
+  // Write functions required by the `Stream` concept,
+  // only used for in situ parsing
+  Ch *PutBegin() {
+    assert(false);
+    return nullptr;
+  }
+
+  void Put(Ch) {
+    assert(false);
+  }
+
+  void Flush() {
+    assert(false);
+  }
+
+  std::size_t PutEnd(Ch *) {
+    assert(false);
+    return 0u;
+  }
+};
+
+} // namespace
+
+namespace parser {
+
+std::optional<ParseError> FileParser::parse(const char *path) {
+  if (cacheDirectory.empty() || !parseCached(path)) {
+    std::optional<ParseError> error;
+    if (eventThreads > 1u)
+      error = parseParallel(path);
+    else
+      error = parseSequential(path);
+
+    if (error)
+      return error;
+
+    if (!cacheDirectory.empty())
+      writeCache(path);
   }
 
   std::sort(nodes.begin(), nodes.end(), [](const Node &left, const Node &right) {
@@ -140,6 +497,132 @@ std::optional<ParseError> FileParser::parse(const char *path) {
   return {};
 }
 
+std::optional<ParseError> FileParser::parseSequential(const char *path) {
+  // RapidJSON prefers FILE*, so this is a safe wrapper for that
+  // Add a 'b' in the mode flags to keep Windows from stupid handling of newlines
+  std::unique_ptr<FILE, decltype(&std::fclose)> file{std::fopen(path, "rb"), std::fclose};
+
+  if (!file) {
+    std::cerr << "Failed to open file: " << path << '\n';
+    return {ParseError{"Failed to open file", 0u}};
+  }
+
+  // Mostly arbitrary buffer size
+  char buffer[65536];
+  rapidjson::FileReadStream stream{file.get(), buffer, sizeof(buffer)};
+
+  JsonHandler handler{*this, streamEvents};
+  rapidjson::Reader reader;
+
+  reader.Parse(stream, handler);
+
+  if (reader.HasParseError())
+    return {makeParseError(reader.GetParseErrorCode(), reader.GetErrorOffset(), errorMessage)};
+
+  return {};
+}
+
+std::optional<ParseError> FileParser::parseParallel(const char *path) {
+  MappedFile file{path};
+  if (!file.isOpen())
+    return parseSequential(path);
+
+  const auto layout = findEvents(file.data(), file.size(), eventThreads);
+  if (!layout)
+    return parseSequential(path);
+
+  // Each run is a contiguous slice of the array,
+  // so joining them in order keeps the events in document (time) order
+  std::vector<std::size_t> bounds{layout->begin};
+  bounds.insert(bounds.end(), layout->splits.begin(), layout->splits.end());
+  bounds.emplace_back(layout->end);
+
+  std::vector<std::future<EventRun>> pending;
+  for (std::size_t i = 0u; i + 1 < bounds.size(); i++) {
+    pending.emplace_back(std::async(std::launch::async, parseEventRun, file.data(), bounds[i], bounds[i + 1],
+                                    i + 2 == bounds.size()));
+  }
+
+  std::optional<ParseError> eventError;
+  std::vector<std::vector<EventDecoder::DecodedEvent>> events;
+  for (auto &future : pending) {
+    auto run = future.get();
+
+    // Runs are in document order, so keep the first error
+    if (run.error && !eventError)
+      eventError = std::move(run.error);
+
+    events.emplace_back(std::move(run.events));
+  }
+
+  // The rest of the document is read as usual, with an empty 'events' array.
+  // The handler adds the decoded events when it reaches the end of the array,
+  // so the transmit & bounds bookkeeping is the same as a sequential read
+  JsonHandler handler{*this, true};
+  if (!eventError)
+    handler.setDecodedEvents(std::move(events));
+
+  SkipRangeStream stream{file.data(), file.size(), layout->begin, layout->end};
+  rapidjson::Reader reader;
+  reader.Parse(stream, handler);
+
+  if (reader.HasParseError()) {
+    auto error = makeParseError(reader.GetParseErrorCode(), reader.GetErrorOffset(), errorMessage);
+    if (!eventError || error.offset < eventError->offset)
+      return {error};
+  }
+
+  return eventError;
+}
+
+bool FileParser::parseCached(const char *path) {
+  MappedFile file{path};
+  if (!file.isOpen())
+    return false;
+
+  auto cached = cache::read(cache::cachePath(cacheDirectory, path), path, file.data(), file.size());
+  if (!cached)
+    return false;
+
+  globalConfiguration = std::move(cached->configuration);
+  nodes = std::move(cached->nodes);
+  buildings = std::move(cached->buildings);
+  decorations = std::move(cached->decorations);
+  areas = std::move(cached->areas);
+  wiredLinks = std::move(cached->wiredLinks);
+  logicalLinks = std::move(cached->logicalLinks);
+  sceneEvents = std::move(cached->sceneEvents);
+  chartEvents = std::move(cached->chartEvents);
+  logEvents = std::move(cached->logEvents);
+  xySeries = std::move(cached->xySeries);
+  categoryValueSeries = std::move(cached->categoryValueSeries);
+  seriesCollections = std::move(cached->seriesCollections);
+  logStreams = std::move(cached->logStreams);
+
+  return true;
+}
+
+void FileParser::writeCache(const char *path) const {
+  MappedFile file{path};
+  if (!file.isOpen())
+    return;
+
+  const auto source = cache::stamp(path, file.data(), file.size());
+  if (!source)
+    return;
+
+  std::error_code error;
+  std::filesystem::create_directories(cacheDirectory, error);
+  if (error) {
+    std::cerr << "Failed to create scenario cache directory: " << cacheDirectory << '\n';
+    return;
+  }
+
+  const auto cachePath = cache::cachePath(cacheDirectory, path);
+  if (!cache::write(cachePath, source.value(), *this))
+    std::cerr << "Failed to write scenario cache: " << cachePath << '\n';
+}
+
 void FileParser::reset() {
   globalConfiguration = {};
   nodes.clear();
@@ -157,6 +640,42 @@ void FileParser::reset() {
   logicalLinks.clear();
 }
 
+ParseResult FileParser::takeResult() {
+  ParseResult result;
+  result.configuration = std::move(globalConfiguration);
+  result.nodes = std::move(nodes);
+  result.buildings = std::move(buildings);
+  result.decorations = std::move(decorations);
+  result.areas = std::move(areas);
+  result.wiredLinks = std::move(wiredLinks);
+  result.logicalLinks = std::move(logicalLinks);
+  result.sceneEvents = std::move(sceneEvents);
+  result.chartEvents = std::move(chartEvents);
+  result.logEvents = std::move(logEvents);
+  result.xySeries = std::move(xySeries);
+  result.categoryValueSeries = std::move(categoryValueSeries);
+  result.seriesCollections = std::move(seriesCollections);
+  result.logStreams = std::move(logStreams);
+
+  // Moved from vectors are valid, but unspecified,
+  // so make sure we're back to a known state
+  reset();
+
+  return result;
+}
+
+void FileParser::setStreamEvents(bool enabled) {
+  streamEvents = enabled;
+}
+
+void FileParser::setCacheDirectory(std::filesystem::path directory) {
+  cacheDirectory = std::move(directory);
+}
+
+void FileParser::setEventThreads(unsigned int threads) {
+  eventThreads = std::max(threads, 1u);
+}
+
 const GlobalConfiguration &FileParser::getConfiguration() const {
   return globalConfiguration;
 }
@@ -32,6 +32,7 @@
  */
 #pragma once
 #include "model.h"
+#include <filesystem>
 #include <optional>
 #include <stack>
 #include <string>
@@ -47,6 +48,27 @@ struct ParseError {
   std::size_t offset;
 };
 
+/**
+ * Everything read from a scenario file,
+ * moved out of the `FileParser` once parsing is complete
+ */
+struct ParseResult {
+  GlobalConfiguration configuration;
+  std::vector<Node> nodes;
+  std::vector<Building> buildings;
+  std::vector<Decoration> decorations;
+  std::vector<Area> areas;
+  std::vector<WiredLink> wiredLinks;
+  std::vector<LogicalLink> logicalLinks;
+  std::vector<SceneEvent> sceneEvents;
+  std::vector<ChartEvent> chartEvents;
+  std::vector<LogEvent> logEvents;
+  std::vector<XYSeries> xySeries;
+  std::vector<CategoryValueSeries> categoryValueSeries;
+  std::vector<SeriesCollection> seriesCollections;
+  std::vector<LogStream> logStreams;
+};
+
 class FileParser {
   friend JsonHandler;
 
@@ -65,6 +87,55 @@ public:
    */
   void reset();
 
+  /**
+   * Move everything read by the last `parse()` call
+   * out of the parser, without copying it.
+   * Leaves the parser in the same state as `reset()`
+   *
+   * @return
+   * The parsed configuration, models & events
+   */
+  [[nodiscard]] ParseResult takeResult();
+
+  /**
+   * Choose how objects in the 'events' section are read.
+   * Streamed events are decoded as the parser reads them,
+   * otherwise a JSON object is built for each first.
+   * Both produce the same events,
+   * so this is mostly useful for comparing the two
+   *
+   * @param enabled
+   * True to stream events (the default),
+   * False to build JSON objects
+   */
+  void setStreamEvents(bool enabled);
+
+  /**
+   * Set where binary caches of the events ('.nsz' files) are read & written.
+   *
+   * After a successful parse, the cache is written.
+   * Later parses of the same, unchanged file read
+   * everything from the cache instead
+   *
+   * @param directory
+   * The directory to keep caches in, created when the first cache is written.
+   * Empty (the default) to always parse the whole file
+   */
+  void setCacheDirectory(std::filesystem::path directory);
+
+  /**
+   * Set the number of threads used to read the 'events' section.
+   * With more than one thread, the file is memory mapped and the
+   * 'events' array is split into runs read in parallel.
+   * The resulting events are the same as a single threaded read.
+   * Events are always streamed in this mode, regardless of `setStreamEvents()`
+   *
+   * @param threads
+   * The number of threads to use. 1 (the default) to read
+   * the file in a single pass
+   */
+  void setEventThreads(unsigned int threads);
+
   /**
    * Gets the configuration from the parsed file
    * `parse()` should be called first
@@ -190,6 +261,68 @@ private:
    */
   std::optional<std::string> errorMessage;
 
+  /**
+   * Flag passed to the `JsonHandler`
+   * for how to read events
+   *
+   * @see setStreamEvents()
+   */
+  bool streamEvents{true};
+
+  /**
+   * Number of threads to read events with
+   *
+   * @see setEventThreads()
+   */
+  unsigned int eventThreads{1u};
+
+  /**
+   * Where the events caches are kept, empty if disabled
+   *
+   * @see setCacheDirectory()
+   */
+  std::filesystem::path cacheDirectory;
+
+  /**
+   * Read the file in a single pass
+   *
+   * @param path
+   * The path to the JSON file
+   */
+  std::optional<ParseError> parseSequential(const char *path);
+
+  /**
+   * Read the 'events' array on `eventThreads` threads,
+   * and the rest of the file on this one.
+   * Falls back to `parseSequential()` if the file
+   * cannot be mapped, or has no 'events' array
+   *
+   * @param path
+   * The path to the JSON file
+   */
+  std::optional<ParseError> parseParallel(const char *path);
+
+  /**
+   * Read everything from the cache for `path`, without parsing the file.
+   * Leaves the parser reset if the cache could not be used
+   *
+   * @param path
+   * The path to the JSON file
+   *
+   * @return
+   * True if the file was read using the cache, False otherwise
+   */
+  bool parseCached(const char *path);
+
+  /**
+   * Write the cache for `path`,
+   * from everything read by the last parse
+   *
+   * @param path
+   * The path to the JSON file
+   */
+  void writeCache(const char *path) const;
+
   /**
    * The overall configuration of the simulation
    */
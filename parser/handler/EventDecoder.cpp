@@ -0,0 +1,568 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "EventDecoder.h"
+#include "PerfectHash.h"
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+using Field = EventDecoder::Field;
+using Type = EventDecoder::Type;
+using int_type = util::json::JsonValue::int_type;
+using unsigned_int_type = util::json::JsonValue::unsigned_int_type;
+const long long msToNsFactor = 1'000'000LL;
+
+constexpr util::PerfectHash<Field, EventDecoder::fieldCount, 128u> fieldTable{
+    {{
+        {"type", Field::Type},
+        {"id", Field::Id},
+        {"milliseconds", Field::Milliseconds},
+        {"nanoseconds", Field::Nanoseconds},
+        {"x", Field::X},
+        {"y", Field::Y},
+        {"z", Field::Z},
+        {"duration", Field::Duration},
+        {"target-size", Field::TargetSize},
+        {"color", Field::Color},
+        {"red", Field::Red},
+        {"green", Field::Green},
+        {"blue", Field::Blue},
+        {"model", Field::Model},
+        {"color-type", Field::ColorType},
+        {"series-id", Field::SeriesId},
+        {"points", Field::Points},
+        {"category", Field::Category},
+        {"value", Field::Value},
+        {"stream-id", Field::StreamId},
+        {"data", Field::Data},
+        {"link-id", Field::LinkId},
+        {"nodes", Field::Nodes},
+        {"active", Field::Active},
+        {"diameter", Field::Diameter},
+    }},
+    Field::Unknown};
+static_assert(fieldTable.isPerfect(), "No collision free seed for the event field table");
+
+constexpr util::PerfectHash<Type, static_cast<std::size_t>(Type::Unknown), 64u> typeTable{
+    {{
+        {"node-position", Type::NodePosition},
+        {"node-model-change", Type::NodeModelChange},
+        {"node-orientation", Type::NodeOrientation},
+        {"node-color", Type::NodeColor},
+        {"node-transmit", Type::NodeTransmit},
+        {"decoration-position", Type::DecorationPosition},
+        {"decoration-orientation", Type::DecorationOrientation},
+        {"xy-series-append", Type::XYSeriesAppend},
+        {"xy-series-append-array", Type::XYSeriesAppendArray},
+        {"xy-series-clear", Type::XYSeriesClear},
+        {"category-series-append", Type::CategorySeriesAppend},
+        {"stream-append", Type::StreamAppend},
+        {"logical-link-create", Type::LogicalLinkCreate},
+        {"logical-link-update", Type::LogicalLinkUpdate},
+    }},
+    Type::Unknown};
+static_assert(typeTable.isPerfect(), "No collision free seed for the event type table");
+
+/**
+ * The key for each `Field`, for error messages
+ */
+constexpr std::array<std::string_view, EventDecoder::fieldCount> fieldNames{
+    "type", "id", "milliseconds", "nanoseconds", "x", "y", "z", "duration", "target-size", "color", "red", "green",
+    "blue", "model", "color-type", "series-id", "points", "category", "value", "stream-id", "data", "link-id", "nodes",
+    "active", "diameter"};
+
+constexpr std::size_t index(Field field) {
+  return static_cast<std::size_t>(field);
+}
+
+} // namespace
+
+void EventDecoder::handle(util::json::JsonValue &&value) {
+  switch (frames.back()) {
+  case Frame::Event:
+  case Frame::Color:
+    if (currentKey == Field::Unknown)
+      return;
+
+    values[index(currentKey)] = std::move(value);
+    present.set(index(currentKey));
+    break;
+  case Frame::Point:
+    if (currentKey == Field::X)
+      pointX = value.get<double>();
+    else if (currentKey == Field::Y)
+      pointY = value.get<double>();
+    break;
+  case Frame::Nodes:
+    nodes.emplace_back(std::move(value));
+    break;
+  case Frame::Points:
+  case Frame::Skip:
+    break;
+  }
+}
+
+bool EventDecoder::required(std::initializer_list<Field> fields) {
+  for (const auto field : fields) {
+    if (!has(field)) {
+      errorMessage = "Missing required field: " + std::string{fieldNames[index(field)]};
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool EventDecoder::time(parser::nanoseconds &time) {
+  if (has(Field::Milliseconds)) {
+    time = get<int_type>(Field::Milliseconds) * msToNsFactor;
+    return true;
+  }
+
+  if (has(Field::Nanoseconds)) {
+    time = get<int_type>(Field::Nanoseconds);
+    return true;
+  }
+
+  errorMessage = "Object must have at least one of the follow fields: milliseconds, nanoseconds";
+  return false;
+}
+
+bool EventDecoder::color(parser::Ns3Color3 &color) {
+  if (!required({Field::Color, Field::Red, Field::Green, Field::Blue}))
+    return false;
+
+  color.red = get<uint8_t>(Field::Red);
+  color.green = get<uint8_t>(Field::Green);
+  color.blue = get<uint8_t>(Field::Blue);
+  return true;
+}
+
+bool EventDecoder::decode() {
+  // Each case follows the matching `JsonHandler::parseXXX()` function,
+  // including the order fields are checked in
+  if (!required({Field::Type}))
+    return false;
+
+  switch (typeTable.find(typeName)) {
+  case Type::NodePosition: {
+    if (!required({Field::Id, Field::X, Field::Y, Field::Z}))
+      return false;
+    parser::MoveEvent event;
+
+    event.nodeId = get<int>(Field::Id);
+    if (!time(event.time))
+      return false;
+    event.targetPosition.x = get<double>(Field::X);
+    event.targetPosition.y = get<double>(Field::Y);
+    event.targetPosition.z = get<double>(Field::Z);
+
+    decoded = event;
+  } break;
+  case Type::NodeModelChange: {
+    if (!required({Field::Id, Field::Nanoseconds, Field::Model}))
+      return false;
+    parser::NodeModelChangeEvent event;
+
+    event.nodeId = get<unsigned_int_type>(Field::Id);
+    event.time = get<int_type>(Field::Nanoseconds);
+    event.model = get<std::string>(Field::Model);
+
+    decoded = std::move(event);
+  } break;
+  case Type::NodeOrientation: {
+    if (!required({Field::Id, Field::X, Field::Y, Field::Z}))
+      return false;
+    parser::NodeOrientationChangeEvent event;
+
+    event.nodeId = get<int>(Field::Id);
+    if (!time(event.time))
+      return false;
+    event.targetOrientation[0] = get<double>(Field::X);
+    event.targetOrientation[1] = get<double>(Field::Y);
+    event.targetOrientation[2] = get<double>(Field::Z);
+
+    decoded = event;
+  } break;
+  case Type::NodeColor: {
+    if (!required({Field::Id, Field::ColorType}))
+      return false;
+    parser::NodeColorChangeEvent event;
+
+    event.nodeId = get<unsigned int>(Field::Id);
+    if (!time(event.time))
+      return false;
+
+    const auto &type = values[index(Field::ColorType)].get<std::string>();
+    if (type == "base")
+      event.type = parser::NodeColorChangeEvent::ColorType::Base;
+    else if (type == "highlight")
+      event.type = parser::NodeColorChangeEvent::ColorType::Highlight;
+    else
+      std::cerr << "Error: unhandled 'color-type': \"" << type << "\" in `NodeColorChangeEvent`\n";
+
+    if (has(Field::Color)) {
+      parser::Ns3Color3 targetColor;
+      if (!color(targetColor))
+        return false;
+      event.targetColor = targetColor;
+    }
+
+    decoded = event;
+  } break;
+  case Type::NodeTransmit: {
+    if (!required({Field::Id, Field::Duration, Field::TargetSize}))
+      return false;
+    parser::TransmitEvent event;
+
+    event.nodeId = get<int>(Field::Id);
+    if (!time(event.time))
+      return false;
+    event.duration = get<int_type>(Field::Duration);
+
+    // TODO: compatibility with v1.0.0, remove for v1.1.0
+    if (has(Field::Milliseconds))
+      event.duration *= msToNsFactor;
+
+    event.targetSize = get<double>(Field::TargetSize);
+    if (!color(event.color))
+      return false;
+
+    decoded = event;
+  } break;
+  case Type::DecorationPosition: {
+    if (!required({Field::Id, Field::X, Field::Y, Field::Z}))
+      return false;
+    parser::DecorationMoveEvent event;
+
+    event.decorationId = get<int>(Field::Id);
+    if (!time(event.time))
+      return false;
+    event.targetPosition.x = get<double>(Field::X);
+    event.targetPosition.y = get<double>(Field::Y);
+    event.targetPosition.z = get<double>(Field::Z);
+
+    decoded = event;
+  } break;
+  case Type::DecorationOrientation: {
+    if (!required({Field::Id, Field::X, Field::Y, Field::Z}))
+      return false;
+    parser::DecorationOrientationChangeEvent event;
+
+    event.decorationId = get<int>(Field::Id);
+    if (!time(event.time))
+      return false;
+    event.targetOrientation[0] = get<double>(Field::X);
+    event.targetOrientation[1] = get<double>(Field::Y);
+    event.targetOrientation[2] = get<double>(Field::Z);
+
+    decoded = event;
+  } break;
+  case Type::XYSeriesAppend: {
+    if (!required({Field::SeriesId, Field::X, Field::Y}))
+      return false;
+    parser::XYSeriesAddValue event;
+
+    if (!time(event.time))
+      return false;
+    event.seriesId = get<int>(Field::SeriesId);
+    event.point.x = get<double>(Field::X);
+    event.point.y = get<double>(Field::Y);
+
+    decoded = event;
+  } break;
+  case Type::XYSeriesAppendArray: {
+    if (!required({Field::SeriesId, Field::Points}))
+      return false;
+    parser::XYSeriesAddValues event;
+
+    if (!time(event.time))
+      return false;
+    event.seriesId = get<int>(Field::SeriesId);
+
+    // Ignore events with empty point arrays
+    if (points.empty()) {
+      std::cerr << "Ignoring empty `xy-series-append-array` event\n";
+      return true;
+    }
+
+    event.points = std::move(points);
+    decoded = std::move(event);
+  } break;
+  case Type::XYSeriesClear: {
+    if (!required({Field::SeriesId}))
+      return false;
+    parser::XYSeriesClear event;
+
+    if (!time(event.time))
+      return false;
+    event.seriesId = get<int>(Field::SeriesId);
+
+    decoded = event;
+  } break;
+  case Type::CategorySeriesAppend: {
+    if (!required({Field::SeriesId, Field::Category, Field::Value}))
+      return false;
+    parser::CategorySeriesAddValue event;
+
+    if (!time(event.time))
+      return false;
+    event.seriesId = get<int>(Field::SeriesId);
+    event.category = get<int>(Field::Category);
+    event.value = get<double>(Field::Value);
+
+    decoded = event;
+  } break;
+  case Type::StreamAppend: {
+    if (!required({Field::StreamId, Field::Data}))
+      return false;
+    parser::StreamAppendEvent event;
+
+    if (!time(event.time))
+      return false;
+    event.streamId = get<int>(Field::StreamId);
+    event.value = get<std::string>(Field::Data);
+
+    decoded = std::move(event);
+  } break;
+  case Type::LogicalLinkCreate: {
+    if (!required({Field::Nanoseconds, Field::LinkId, Field::Nodes, Field::Active, Field::Color, Field::Diameter}))
+      return false;
+    parser::LogicalLinkCreate event;
+    event.time = get<int_type>(Field::Nanoseconds);
+    event.model.id = get<unsigned_int_type>(Field::LinkId);
+
+    if (nodes.size() != 2u) {
+      std::cerr << "Error: Links of type 'logical' must have exactly 2 nodes, got: " << nodes.size()
+                << " Ignoring.\n";
+      return true;
+    }
+    event.model.nodes = {nodes[0].get<unsigned_int_type>(), nodes[1].get<unsigned_int_type>()};
+
+    event.model.active = get<bool>(Field::Active);
+    if (!color(event.model.color))
+      return false;
+    event.model.diameter = get<float>(Field::Diameter);
+
+    decoded = event;
+  } break;
+  case Type::LogicalLinkUpdate: {
+    if (!required({Field::Nanoseconds, Field::LinkId, Field::Nodes, Field::Active, Field::Color, Field::Diameter}))
+      return false;
+    parser::LogicalLinkUpdate event;
+    event.time = get<int_type>(Field::Nanoseconds);
+    event.id = get<unsigned_int_type>(Field::LinkId);
+
+    if (nodes.size() != 2u) {
+      std::cerr << "Error: Links of type 'logical' must have exactly 2 nodes, got: " << nodes.size()
+                << " Ignoring.\n";
+      return true;
+    }
+    event.nodes = {nodes[0].get<unsigned_int_type>(), nodes[1].get<unsigned_int_type>()};
+
+    event.active = get<bool>(Field::Active);
+    if (!color(event.color))
+      return false;
+    event.diameter = get<float>(Field::Diameter);
+
+    decoded = event;
+  } break;
+  case Type::Unknown:
+    std::cerr << "Unhandled Event type: " << typeName << '\n';
+    break;
+  }
+
+  return true;
+}
+
+std::optional<EventDecoder::DecodedEvent> EventDecoder::take() {
+  auto event = std::move(decoded);
+  decoded.reset();
+  return event;
+}
+
+void EventDecoder::Null() {
+  handle(nullptr);
+}
+
+void EventDecoder::Bool(bool value) {
+  handle(value);
+}
+
+void EventDecoder::Int(int value) {
+  handle(value);
+}
+
+void EventDecoder::Uint(unsigned int value) {
+  handle(value);
+}
+
+void EventDecoder::Int64(std::int64_t value) {
+  handle(static_cast<int_type>(value));
+}
+
+void EventDecoder::Uint64(std::uint64_t value) {
+  handle(static_cast<unsigned_int_type>(value));
+}
+
+void EventDecoder::Double(double value) {
+  handle(value);
+}
+
+void EventDecoder::String(const char *value, rapidjson::SizeType length) {
+  // The type is only needed as a string for error messages,
+  // so reuse the same buffer rather than storing it in `values`
+  if (frames.back() == Frame::Event && currentKey == Field::Type) {
+    typeName.assign(value, length);
+    present.set(index(Field::Type));
+    return;
+  }
+
+  handle(std::string(value, length));
+}
+
+void EventDecoder::StartObject() {
+  // The event object itself
+  if (frames.empty()) {
+    frames.push_back(Frame::Event);
+    currentKey = Field::Unknown;
+    present.reset();
+    points.clear();
+    nodes.clear();
+    decoded.reset();
+    return;
+  }
+
+  if (frames.back() == Frame::Event && currentKey == Field::Color) {
+    frames.push_back(Frame::Color);
+    // Only keep components from the latest 'color'
+    present.reset(index(Field::Red));
+    present.reset(index(Field::Green));
+    present.reset(index(Field::Blue));
+    present.set(index(Field::Color));
+    return;
+  }
+
+  if (frames.back() == Frame::Points) {
+    frames.push_back(Frame::Point);
+    pointX.reset();
+    pointY.reset();
+    return;
+  }
+
+  frames.push_back(Frame::Skip);
+}
+
+void EventDecoder::Key(const char *value, rapidjson::SizeType length) {
+  const auto field = fieldTable.find(std::string_view{value, length});
+
+  switch (frames.back()) {
+  case Frame::Event:
+    // Color components only belong in the 'color' object
+    if (field == Field::Red || field == Field::Green || field == Field::Blue)
+      currentKey = Field::Unknown;
+    else
+      currentKey = field;
+    break;
+  case Frame::Color:
+    if (field == Field::Red || field == Field::Green || field == Field::Blue)
+      currentKey = field;
+    else
+      currentKey = Field::Unknown;
+    break;
+  case Frame::Point:
+    if (field == Field::X || field == Field::Y)
+      currentKey = field;
+    else
+      currentKey = Field::Unknown;
+    break;
+  case Frame::Points:
+  case Frame::Nodes:
+  case Frame::Skip:
+    break;
+  }
+}
+
+bool EventDecoder::EndObject() {
+  const auto frame = frames.back();
+  frames.pop_back();
+
+  switch (frame) {
+  case Frame::Event:
+    return decode();
+  case Frame::Point:
+    if (!pointX.has_value()) {
+      errorMessage = "Missing required field: x";
+      return false;
+    }
+    if (!pointY.has_value()) {
+      errorMessage = "Missing required field: y";
+      return false;
+    }
+
+    points.emplace_back(parser::XYPoint{pointX.value(), pointY.value()});
+    break;
+  default:
+    break;
+  }
+
+  // Keys after a closed child belong to the parent again
+  currentKey = Field::Unknown;
+  return true;
+}
+
+void EventDecoder::StartArray() {
+  if (frames.back() == Frame::Event && currentKey == Field::Points) {
+    frames.push_back(Frame::Points);
+    points.clear();
+    present.set(index(Field::Points));
+    return;
+  }
+
+  if (frames.back() == Frame::Event && currentKey == Field::Nodes) {
+    frames.push_back(Frame::Nodes);
+    nodes.clear();
+    present.set(index(Field::Nodes));
+    return;
+  }
+
+  frames.push_back(Frame::Skip);
+}
+
+void EventDecoder::EndArray() {
+  frames.pop_back();
+  currentKey = Field::Unknown;
+}
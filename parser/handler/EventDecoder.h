@@ -0,0 +1,291 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include "Json.h"
+#include "model.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <rapidjson/reader.h>
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * Decodes a single object from the 'events' section
+ * directly from the parser callbacks, without building
+ * a `util::json::JsonObject` for it.
+ *
+ * Since the 'type' key may come after the fields it describes,
+ * values are held in fixed slots as they are read,
+ * and the event is built once the object ends.
+ *
+ * Produces the same events as the `JsonHandler::parseXXX()` event functions
+ */
+class EventDecoder {
+public:
+  /**
+   * Every event which may be read from the 'events' section
+   */
+  using DecodedEvent =
+      std::variant<parser::MoveEvent, parser::NodeModelChangeEvent, parser::TransmitEvent, parser::DecorationMoveEvent,
+                   parser::NodeOrientationChangeEvent, parser::DecorationOrientationChangeEvent,
+                   parser::NodeColorChangeEvent, parser::XYSeriesAddValue, parser::XYSeriesAddValues,
+                   parser::XYSeriesClear, parser::CategorySeriesAddValue, parser::StreamAppendEvent,
+                   parser::LogicalLinkCreate, parser::LogicalLinkUpdate>;
+
+  /**
+   * Every key used by an event object, or its children
+   */
+  enum class Field {
+    Type,
+    Id,
+    Milliseconds,
+    Nanoseconds,
+    X,
+    Y,
+    Z,
+    Duration,
+    TargetSize,
+    Color,
+    Red,
+    Green,
+    Blue,
+    Model,
+    ColorType,
+    SeriesId,
+    Points,
+    Category,
+    Value,
+    StreamId,
+    Data,
+    LinkId,
+    Nodes,
+    Active,
+    Diameter,
+    Unknown
+  };
+
+  /**
+   * The values of the 'type' key
+   */
+  enum class Type {
+    NodePosition,
+    NodeModelChange,
+    NodeOrientation,
+    NodeColor,
+    NodeTransmit,
+    DecorationPosition,
+    DecorationOrientation,
+    XYSeriesAppend,
+    XYSeriesAppendArray,
+    XYSeriesClear,
+    CategorySeriesAppend,
+    StreamAppend,
+    LogicalLinkCreate,
+    LogicalLinkUpdate,
+    Unknown
+  };
+
+  static constexpr std::size_t fieldCount = static_cast<std::size_t>(Field::Unknown);
+
+private:
+  /**
+   * What the decoder is currently inside of
+   */
+  enum class Frame {
+    Event,
+    Color,
+    Points,
+    Point,
+    Nodes,
+    /**
+     * Some object or array we do not read
+     */
+    Skip
+  };
+
+  /**
+   * The nesting of the decoder.
+   * Empty when not decoding an event
+   */
+  std::vector<Frame> frames;
+
+  /**
+   * The last key read. `Field::Unknown` for keys
+   * which do not belong to the current object
+   */
+  Field currentKey{Field::Unknown};
+
+  /**
+   * Values read for the event & its color.
+   * Only valid if the matching bit in `present` is set
+   */
+  std::array<util::json::JsonValue, fieldCount> values;
+
+  /**
+   * Which of `values` have been set for the current event
+   */
+  std::bitset<fieldCount> present;
+
+  /**
+   * The raw 'type' value, kept for error messages
+   */
+  std::string typeName;
+
+  std::vector<parser::XYPoint> points;
+  std::optional<double> pointX;
+  std::optional<double> pointY;
+  std::vector<util::json::JsonValue> nodes;
+
+  std::optional<DecodedEvent> decoded;
+  std::string errorMessage;
+
+  /**
+   * Store a value read by the parser for `currentKey`
+   *
+   * @param value
+   * The value read
+   */
+  void handle(util::json::JsonValue &&value);
+
+  [[nodiscard]] bool has(Field field) const {
+    return present.test(static_cast<std::size_t>(field));
+  }
+
+  template <typename T>
+  [[nodiscard]] T get(Field field) const {
+    return values[static_cast<std::size_t>(field)].get<T>();
+  }
+
+  /**
+   * Check each of `fields` was read.
+   * Sets `errorMessage` for the first missing field
+   *
+   * @param fields
+   * The fields to check for
+   *
+   * @return
+   * True if every field was read, False otherwise
+   */
+  bool required(std::initializer_list<Field> fields);
+
+  /**
+   * Read the event time from either the 'milliseconds'
+   * or 'nanoseconds' field
+   *
+   * @param time
+   * Set to the time of the event
+   *
+   * @return
+   * True if one of the fields was read, False otherwise
+   */
+  bool time(parser::nanoseconds &time);
+
+  /**
+   * Read the 'color' object
+   *
+   * @param color
+   * Set to the read color
+   *
+   * @return
+   * True if the color and all its components were read, False otherwise
+   */
+  bool color(parser::Ns3Color3 &color);
+
+  /**
+   * Build the event from the read fields into `decoded`
+   *
+   * @return
+   * False if a required field is missing, True otherwise.
+   * Ignored events still return True
+   */
+  bool decode();
+
+public:
+  /**
+   * Checks if an event object is currently being read
+   *
+   * @return
+   * True if the parser is within an event object
+   */
+  [[nodiscard]] bool isDecoding() const {
+    return !frames.empty();
+  }
+
+  /**
+   * Take the most recently decoded event
+   *
+   * @return
+   * The event, or an empty optional
+   * if the last object was ignored
+   */
+  [[nodiscard]] std::optional<DecodedEvent> take();
+
+  /**
+   * The reason the last call to `EndObject()` failed
+   */
+  [[nodiscard]] const std::string &error() const {
+    return errorMessage;
+  }
+
+  // Mirrors the handler interface of the parser,
+  // forwarded from `JsonHandler` while `isDecoding()`
+  void Null();
+  void Bool(bool value);
+  void Int(int value);
+  void Uint(unsigned int value);
+  void Int64(std::int64_t value);
+  void Uint64(std::uint64_t value);
+  void Double(double value);
+  void String(const char *value, rapidjson::SizeType length);
+  void StartObject();
+  void Key(const char *value, rapidjson::SizeType length);
+
+  /**
+   * Close the current object.
+   * When closing the event object itself,
+   * the event is built & may be retrieved with `take()`
+   *
+   * @return
+   * False if the event is missing required fields
+   * (see `error()`), True otherwise
+   */
+  bool EndObject();
+  void StartArray();
+  void EndArray();
+};
@@ -38,6 +38,9 @@
 #include <cmath>
 #include <exception>
 #include <sstream>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
 using int_type = util::json::JsonValue::int_type;
 using unsigned_int_type = util::json::JsonValue::unsigned_int_type;
@@ -624,11 +627,7 @@ void JsonHandler::parseMoveEvent(const util::json::JsonObject &object) {
   event.targetPosition.y = object["y"].get<double>();
   event.targetPosition.z = object["z"].get<double>();
 
-  updateLocationBounds(event.targetPosition);
-
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseNodeModelChangeEvent(const util::json::JsonObject &object) {
@@ -639,9 +638,7 @@ void JsonHandler::parseNodeModelChangeEvent(const util::json::JsonObject &object
   event.time = object["nanoseconds"].get<int_type>();
   event.model = object["model"].get<std::string>();
 
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseTransmitEvent(const util::json::JsonObject &object) {
@@ -662,20 +659,7 @@ void JsonHandler::parseTransmitEvent(const util::json::JsonObject &object) {
   event.targetSize = object["target-size"].get<double>();
   event.color = colorFromObject(object["color"].object());
 
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-
-  // End any previous transmits by this Node
-  // Even if they're incomplete
-  const auto &transmittingIter = transmittingNodes.find(event.nodeId);
-  if (transmittingIter != transmittingNodes.end() && transmittingIter->second.has_value()) {
-    parser::TransmitEndEvent endEvent;
-    endEvent.time = event.time;
-    endEvent.startEvent = transmittingIter->second.value();
-    fileParser.sceneEvents.emplace_back(endEvent);
-  }
-  transmittingNodes[event.nodeId] = event;
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseDecorationMoveEvent(const util::json::JsonObject &object) {
@@ -689,11 +673,7 @@ void JsonHandler::parseDecorationMoveEvent(const util::json::JsonObject &object)
   event.targetPosition.y = object["y"].get<double>();
   event.targetPosition.z = object["z"].get<double>();
 
-  updateLocationBounds(event.targetPosition);
-
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseNodeOrientationEvent(const util::json::JsonObject &object) {
@@ -707,9 +687,7 @@ void JsonHandler::parseNodeOrientationEvent(const util::json::JsonObject &object
   event.targetOrientation[1] = object["y"].get<double>();
   event.targetOrientation[2] = object["z"].get<double>();
 
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseDecorationOrientationEvent(const util::json::JsonObject &object) {
@@ -723,9 +701,7 @@ void JsonHandler::parseDecorationOrientationEvent(const util::json::JsonObject &
   event.targetOrientation[1] = object["y"].get<double>();
   event.targetOrientation[2] = object["z"].get<double>();
 
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseNodeColorChangeEvent(const util::json::JsonObject &object) {
@@ -747,9 +723,7 @@ void JsonHandler::parseNodeColorChangeEvent(const util::json::JsonObject &object
   if (object.contains("color"))
     event.targetColor = colorFromObject(object["color"].object());
 
-  updateEndTime(event.time);
-  processEndTransmits(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseSeriesAppend(const util::json::JsonObject &object) {
@@ -762,8 +736,7 @@ void JsonHandler::parseSeriesAppend(const util::json::JsonObject &object) {
   event.point.x = object["x"].get<double>();
   event.point.y = object["y"].get<double>();
 
-  updateEndTime(event.time);
-  fileParser.chartEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseSeriesAppendArray(const util::json::JsonObject &object) {
@@ -782,12 +755,12 @@ void JsonHandler::parseSeriesAppendArray(const util::json::JsonObject &object) {
     return;
   }
 
+  event.points.reserve(points.size());
   for (const auto &point : points) {
     event.points.emplace_back(parser::XYPoint{point.object()["x"].get<double>(), point.object()["y"].get<double>()});
   }
 
-  updateEndTime(event.time);
-  fileParser.chartEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseSeriesClear(const util::json::JsonObject &object) {
@@ -798,8 +771,7 @@ void JsonHandler::parseSeriesClear(const util::json::JsonObject &object) {
   event.time = getTimeCompatible(object);
   event.seriesId = object["series-id"].get<int>();
 
-  updateEndTime(event.time);
-  fileParser.chartEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseCategorySeriesAppend(const util::json::JsonObject &object) {
@@ -812,8 +784,7 @@ void JsonHandler::parseCategorySeriesAppend(const util::json::JsonObject &object
   event.category = object["category"].get<int>();
   event.value = object["value"].get<double>();
 
-  updateEndTime(event.time);
-  fileParser.chartEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseXYSeries(const util::json::JsonObject &object) {
@@ -979,8 +950,7 @@ void JsonHandler::parseStreamAppend(const util::json::JsonObject &object) {
   event.streamId = object["stream-id"].get<int>();
   event.value = object["data"].get<std::string>();
 
-  updateEndTime(event.time);
-  fileParser.logEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseLogicalLinkCreate(const util::json::JsonObject &object) {
@@ -1000,8 +970,7 @@ void JsonHandler::parseLogicalLinkCreate(const util::json::JsonObject &object) {
   event.model.color = colorFromObject(object["color"].object());
   event.model.diameter = object["diameter"].get<float>();
 
-  updateEndTime(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
 }
 
 void JsonHandler::parseLogicalLinkUpdate(const util::json::JsonObject &object) {
@@ -1021,8 +990,46 @@ void JsonHandler::parseLogicalLinkUpdate(const util::json::JsonObject &object) {
   event.color = colorFromObject(object["color"].object());
   event.diameter = object["diameter"].get<float>();
 
-  updateEndTime(event.time);
-  fileParser.sceneEvents.emplace_back(event);
+  addEvent(std::move(event));
+}
+
+void JsonHandler::addEvent(EventDecoder::DecodedEvent &&event) {
+  std::visit(
+      [this](auto &&e) {
+        using T = std::decay_t<decltype(e)>;
+
+        if constexpr (std::is_same_v<T, parser::MoveEvent> || std::is_same_v<T, parser::DecorationMoveEvent>)
+          updateLocationBounds(e.targetPosition);
+
+        updateEndTime(e.time);
+
+        if constexpr (std::is_same_v<T, parser::XYSeriesAddValue> || std::is_same_v<T, parser::XYSeriesAddValues> ||
+                      std::is_same_v<T, parser::XYSeriesClear> || std::is_same_v<T, parser::CategorySeriesAddValue>)
+          fileParser.chartEvents.emplace_back(std::move(e));
+        else if constexpr (std::is_same_v<T, parser::StreamAppendEvent>)
+          fileParser.logEvents.emplace_back(std::move(e));
+        else if constexpr (std::is_same_v<T, parser::LogicalLinkCreate> || std::is_same_v<T, parser::LogicalLinkUpdate>)
+          fileParser.sceneEvents.emplace_back(std::move(e));
+        else if constexpr (std::is_same_v<T, parser::TransmitEvent>) {
+          processEndTransmits(e.time);
+
+          // End any previous transmits by this Node
+          // Even if they're incomplete
+          const auto &transmittingIter = transmittingNodes.find(e.nodeId);
+          if (transmittingIter != transmittingNodes.end() && transmittingIter->second.has_value()) {
+            parser::TransmitEndEvent endEvent;
+            endEvent.time = e.time;
+            endEvent.startEvent = transmittingIter->second.value();
+            fileParser.sceneEvents.emplace_back(endEvent);
+          }
+          transmittingNodes[e.nodeId] = e;
+          fileParser.sceneEvents.emplace_back(std::move(e));
+        } else {
+          processEndTransmits(e.time);
+          fileParser.sceneEvents.emplace_back(std::move(e));
+        }
+      },
+      std::move(event));
 }
 
 void JsonHandler::updateLocationBounds(const parser::Ns3Coordinate &coordinate) {
@@ -1068,50 +1075,100 @@ void JsonHandler::processEndTransmits(parser::nanoseconds time) {
   }
 }
 
-JsonHandler::JsonHandler(parser::FileParser &parser) : fileParser(parser) {
+JsonHandler::JsonHandler(parser::FileParser &parser, bool streamEvents)
+    : fileParser(parser), streamEvents(streamEvents) {
+}
+
+void JsonHandler::setDecodedEvents(std::vector<std::vector<EventDecoder::DecodedEvent>> &&events) {
+  decodedEvents = std::move(events);
 }
 
 bool JsonHandler::Null() {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Null();
+    return true;
+  }
+
   handle(nullptr);
   return true;
 }
 
 bool JsonHandler::Bool(bool value) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Bool(value);
+    return true;
+  }
+
   handle(value);
   return true;
 }
 
 bool JsonHandler::Int(int value) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Int(value);
+    return true;
+  }
+
   handle(value);
   return true;
 }
 
 bool JsonHandler::Uint(unsigned int value) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Uint(value);
+    return true;
+  }
+
   handle(value);
   return true;
 }
 
 bool JsonHandler::Int64(std::int64_t value) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Int64(value);
+    return true;
+  }
+
   handle(value);
   return true;
 }
 
 bool JsonHandler::Uint64(std::uint64_t value) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Uint64(value);
+    return true;
+  }
+
   handle(value);
   return true;
 }
 
 bool JsonHandler::Double(double value) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Double(value);
+    return true;
+  }
+
   handle(value);
   return true;
 }
 
 bool JsonHandler::String(const char *value, rapidjson::SizeType length, bool) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.String(value, length);
+    return true;
+  }
+
   handle(std::string(value, length));
   return true;
 }
 
 bool JsonHandler::StartObject() {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.StartObject();
+    return true;
+  }
+
   // Root object case
   if (jsonStack.empty()) {
     jsonStack.push({"root", util::json::JsonObject()});
@@ -1120,6 +1177,13 @@ bool JsonHandler::StartObject() {
 
   auto &top = jsonStack.top();
 
+  // Objects directly in the 'events' array
+  // are decoded as they are read
+  if (streamEvents && currentSection == Section::Events && jsonStack.size() == 2u && top.value.isArray()) {
+    eventDecoder.StartObject();
+    return true;
+  }
+
   // Do not overwrite existing values
   if (top.value.isArray()) {
     jsonStack.push({"", util::json::JsonObject()});
@@ -1131,6 +1195,22 @@ bool JsonHandler::StartObject() {
 }
 
 bool JsonHandler::EndObject(rapidjson::SizeType) {
+  if (eventDecoder.isDecoding()) {
+    if (!eventDecoder.EndObject()) {
+      fileParser.errorMessage = eventDecoder.error();
+      return false;
+    }
+
+    // Still within the event object
+    if (eventDecoder.isDecoding())
+      return true;
+
+    auto event = eventDecoder.take();
+    if (event)
+      addEvent(std::move(event.value()));
+    return true;
+  }
+
   // TODO: Error
   if (jsonStack.empty()) {
     return false;
@@ -1191,6 +1271,11 @@ bool JsonHandler::EndObject(rapidjson::SizeType) {
 }
 
 bool JsonHandler::StartArray() {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.StartArray();
+    return true;
+  }
+
   if (jsonStack.empty()) {
     return false;
   }
@@ -1200,6 +1285,42 @@ bool JsonHandler::StartArray() {
 }
 
 bool JsonHandler::EndArray(rapidjson::SizeType) {
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.EndArray();
+    return true;
+  }
+
+  // End of the 'events' array itself
+  if (currentSection == Section::Events && jsonStack.size() == 2u) {
+    // Size the event collections once, rather than growing them
+    // through every event. Transmits may also add an end event, so count them twice
+    std::size_t scene{0u};
+    std::size_t chart{0u};
+    std::size_t log{0u};
+    for (const auto &run : decodedEvents) {
+      for (const auto &event : run) {
+        if (std::holds_alternative<parser::XYSeriesAddValue>(event) ||
+            std::holds_alternative<parser::XYSeriesAddValues>(event) ||
+            std::holds_alternative<parser::XYSeriesClear>(event) ||
+            std::holds_alternative<parser::CategorySeriesAddValue>(event))
+          chart++;
+        else if (std::holds_alternative<parser::StreamAppendEvent>(event))
+          log++;
+        else
+          scene += std::holds_alternative<parser::TransmitEvent>(event) ? 2u : 1u;
+      }
+    }
+    fileParser.sceneEvents.reserve(fileParser.sceneEvents.size() + scene);
+    fileParser.chartEvents.reserve(fileParser.chartEvents.size() + chart);
+    fileParser.logEvents.reserve(fileParser.logEvents.size() + log);
+
+    for (auto &run : decodedEvents) {
+      for (auto &event : run)
+        addEvent(std::move(event));
+    }
+    decodedEvents.clear();
+  }
+
   auto oldTop = jsonStack.top();
   jsonStack.pop();
 
@@ -1217,7 +1338,12 @@ bool JsonHandler::EndArray(rapidjson::SizeType) {
 }
 
 bool JsonHandler::Key(const char *value, rapidjson::SizeType length, bool) {
-  jsonStack.push({std::string(value, length)});
+  if (eventDecoder.isDecoding()) {
+    eventDecoder.Key(value, length);
+    return true;
+  }
+
+  jsonStack.push({std::string(value, length), {}});
 
   // Only Check for sections for keys immediately
   // descending from the root object.
@@ -33,6 +33,7 @@
 
 #pragma once
 #include "../file-parser.h"
+#include "EventDecoder.h"
 #include "Json.h"
 #include "model.h"
 #include <cassert>
@@ -78,6 +79,26 @@ class JsonHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonH
    */
   Section currentSection = Section::None;
 
+  /**
+   * Flag for reading objects in the 'events' section
+   * with `eventDecoder`, rather than as `JsonObject`s
+   */
+  bool streamEvents;
+
+  /**
+   * Decoder for the event object currently being read,
+   * when `streamEvents` is set
+   */
+  EventDecoder eventDecoder;
+
+  /**
+   * Events decoded ahead of time, in document order.
+   * Added in place of the 'events' array contents
+   *
+   * @see setDecodedEvents()
+   */
+  std::vector<std::vector<EventDecoder::DecodedEvent>> decodedEvents;
+
   /**
    * A frame for the JSON stack
    */
@@ -345,6 +366,17 @@ class JsonHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonH
    */
   void parseLogicalLinkUpdate(const util::json::JsonObject &object);
 
+  /**
+   * Store an event read from the 'events' section,
+   * after updating the bounds, end time & transmits the event affects.
+   *
+   * Shared by the `parseXXX()` event functions & `eventDecoder`
+   *
+   * @param event
+   * The fully read event
+   */
+  void addEvent(EventDecoder::DecodedEvent &&event);
+
   /**
    * Check the min/max bounds against `coordinate` and update accordingly
    *
@@ -378,7 +410,26 @@ class JsonHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonH
   void processEndTransmits(parser::nanoseconds time);
 
 public:
-  explicit JsonHandler(parser::FileParser &parser);
+  /**
+   * @param parser
+   * The parser to store read models & events in
+   *
+   * @param streamEvents
+   * True to decode objects in the 'events' section as they are read,
+   * False to build a `JsonObject` for each first
+   */
+  explicit JsonHandler(parser::FileParser &parser, bool streamEvents = true);
+
+  /**
+   * Provide the contents of the 'events' array ahead of time,
+   * for documents read with the array contents skipped.
+   * The events are added, with the same bookkeeping as if they were read,
+   * when the (empty) array ends
+   *
+   * @param events
+   * Contiguous runs of events from the array, in document order
+   */
+  void setDecodedEvents(std::vector<std::vector<EventDecoder::DecodedEvent>> &&events);
 
   // Note: do not make the below functions `virtual`
   // or mark them with `override
@@ -0,0 +1,172 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace util {
+
+/**
+ * Hash table mapping a fixed set of strings to IDs,
+ * built entirely at compile time.
+ *
+ * The constructor searches for a seed that places every key
+ * in its own slot, so a lookup is a single hash
+ * and a single string comparison.
+ *
+ * Instances should be `constexpr`,
+ * and checked with `static_assert(table.isPerfect())`
+ *
+ * @tparam Id
+ * The type mapped to by each key
+ *
+ * @tparam KeyCount
+ * The number of keys in the table
+ *
+ * @tparam TableSize
+ * The number of slots in the table.
+ * Should be a power of two, and comfortably larger than `KeyCount`
+ * so a seed may be found quickly
+ */
+template <typename Id, std::size_t KeyCount, std::size_t TableSize>
+class PerfectHash {
+public:
+  using Entry = std::pair<std::string_view, Id>;
+
+private:
+  /**
+   * Upper bound on the seeds tried by the constructor
+   */
+  static constexpr std::uint32_t maxSeed = 10'000u;
+
+  std::array<Entry, TableSize> table{};
+  std::uint32_t seed{0u};
+  Id missing;
+  bool perfect{false};
+
+  /**
+   * FNV-1a, with `seed` mixed into the offset basis
+   */
+  [[nodiscard]] static constexpr std::uint32_t hash(std::string_view key, std::uint32_t seed) {
+    std::uint32_t value = 2166136261u ^ seed;
+    for (const auto c : key) {
+      value ^= static_cast<unsigned char>(c);
+      value *= 16777619u;
+    }
+    return value;
+  }
+
+  [[nodiscard]] constexpr std::size_t slot(std::string_view key) const {
+    return hash(key, seed) % TableSize;
+  }
+
+  /**
+   * Attempt to place every entry with the current `seed`
+   *
+   * @return
+   * True if no two keys share a slot, False otherwise
+   */
+  constexpr bool build(const std::array<Entry, KeyCount> &entries) {
+    for (auto &entry : table)
+      entry = {std::string_view{}, missing};
+
+    std::array<bool, TableSize> used{};
+    for (const auto &entry : entries) {
+      const auto index = slot(entry.first);
+      if (used[index])
+        return false;
+
+      used[index] = true;
+      table[index] = entry;
+    }
+
+    return true;
+  }
+
+public:
+  /**
+   * Build the table from `entries`
+   *
+   * @param entries
+   * Every key and the ID it maps to.
+   * Keys must be unique
+   *
+   * @param missing
+   * The ID returned by `find()` for keys not in `entries`
+   */
+  constexpr PerfectHash(const std::array<Entry, KeyCount> &entries, Id missing) : missing(missing) {
+    static_assert(KeyCount < TableSize, "PerfectHash requires more slots than keys");
+
+    for (seed = 0u; seed < maxSeed; seed++) {
+      if (build(entries)) {
+        perfect = true;
+        return;
+      }
+    }
+  }
+
+  /**
+   * Checks that a seed was found which
+   * gives each key its own slot
+   *
+   * @return
+   * True if the table is usable, False otherwise
+   */
+  [[nodiscard]] constexpr bool isPerfect() const {
+    return perfect;
+  }
+
+  /**
+   * Look up the ID for `key`
+   *
+   * @param key
+   * The string to look up
+   *
+   * @return
+   * The ID for `key`, or the `missing` ID from the constructor
+   * if `key` is not in the table
+   */
+  [[nodiscard]] constexpr Id find(std::string_view key) const {
+    const auto &entry = table[slot(key)];
+    if (entry.first != key)
+      return missing;
+
+    return entry.second;
+  }
+};
+
+} // namespace util
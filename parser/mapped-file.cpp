@@ -0,0 +1,128 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+#include "mapped-file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace parser {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char *path) {
+  file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    file = nullptr;
+    return;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    return;
+
+  mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+    return;
+
+  const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view)
+    return;
+
+  contents = static_cast<const char *>(view);
+  length = static_cast<std::size_t>(fileSize.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+  if (contents)
+    UnmapViewOfFile(contents);
+  if (mapping)
+    CloseHandle(mapping);
+  if (file)
+    CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const char *path) {
+  const auto descriptor = open(path, O_RDONLY);
+  if (descriptor == -1)
+    return;
+
+  struct stat status {};
+  if (fstat(descriptor, &status) == -1 || status.st_size == 0) {
+    close(descriptor);
+    return;
+  }
+
+  const auto size = static_cast<std::size_t>(status.st_size);
+  auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+  // The mapping holds its own reference to the file
+  close(descriptor);
+  if (view == MAP_FAILED)
+    return;
+
+  // Every page is read once, front to back
+  madvise(view, size, MADV_SEQUENTIAL);
+
+  contents = static_cast<const char *>(view);
+  length = size;
+}
+
+MappedFile::~MappedFile() {
+  if (contents)
+    munmap(const_cast<char *>(contents), length);
+}
+
+#endif
+
+bool MappedFile::isOpen() const {
+  return contents != nullptr;
+}
+
+const char *MappedFile::data() const {
+  return contents;
+}
+
+std::size_t MappedFile::size() const {
+  return length;
+}
+
+} // namespace parser
@@ -0,0 +1,89 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+#pragma once
+#include <cstddef>
+
+namespace parser {
+
+/**
+ * Read only view of an entire file, mapped into memory
+ */
+class MappedFile {
+  const char *contents{nullptr};
+  std::size_t length{0u};
+
+#ifdef _WIN32
+  void *file{nullptr};
+  void *mapping{nullptr};
+#endif
+
+public:
+  /**
+   * Map the file at `path`.
+   * Check `isOpen()` before using the contents
+   *
+   * @param path
+   * The path to the file to map
+   */
+  explicit MappedFile(const char *path);
+
+  // No Copies
+  MappedFile(const MappedFile &other) = delete;
+  MappedFile &operator=(const MappedFile &other) = delete;
+
+  ~MappedFile();
+
+  /**
+   * Checks if the file was mapped.
+   * Empty files are never mapped
+   *
+   * @return
+   * True if `data()` may be read, False otherwise
+   */
+  [[nodiscard]] bool isOpen() const;
+
+  /**
+   * @return
+   * The start of the file contents.
+   * Not null terminated
+   */
+  [[nodiscard]] const char *data() const;
+
+  /**
+   * @return
+   * The size of the file in bytes
+   */
+  [[nodiscard]] std::size_t size() const;
+};
+
+} // namespace parser
@@ -0,0 +1,975 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+#include "scenario-cache.h"
+#include "mapped-file.h"
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <initializer_list>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace {
+
+/**
+ * Change whenever the layout of the file,
+ * the meaning of a record field, or the fields of a model change
+ */
+const std::uint32_t cacheVersion = 3u;
+const std::array<char, 8> cacheMagic{'N', 'S', 'Z', 'C', 'A', 'C', 'H', 'E'};
+
+enum class RecordType : std::uint8_t {
+  Move,
+  NodeModelChange,
+  Transmit,
+  TransmitEnd,
+  DecorationMove,
+  NodeOrientation,
+  DecorationOrientation,
+  NodeColor,
+  XYSeriesAddValue,
+  XYSeriesAddValues,
+  XYSeriesClear,
+  CategorySeriesAddValue,
+  StreamAppend,
+  LogicalLinkCreate,
+  LogicalLinkUpdate
+};
+
+/**
+ * Flags for `EventRecord::flags`
+ */
+enum RecordFlag : std::uint8_t { Active = 1u, HasColor = 2u, HighlightColor = 4u };
+
+/**
+ * A single event, of any type.
+ * The meaning of each field depends on `type`
+ */
+struct EventRecord {
+  RecordType type;
+  std::uint8_t flags;
+  std::array<std::uint8_t, 3> color;
+  std::array<std::uint8_t, 3> padding;
+  std::int64_t time;
+
+  /**
+   * Node, decoration, series, stream or link ID.
+   * For transmit ends, the ending Node in the low 32 bits,
+   * and the transmitting Node in the high 32 bits
+   */
+  std::uint64_t id;
+
+  /**
+   * Duration, string index, first point, or category
+   */
+  std::uint64_t extra;
+
+  /**
+   * Point count, the link nodes, or the start time of an ended transmit
+   */
+  std::uint64_t count;
+
+  /**
+   * Position, orientation, point, size, value or diameter
+   */
+  std::array<double, 3> values;
+};
+static_assert(std::is_trivially_copyable_v<EventRecord>);
+static_assert(sizeof(EventRecord) == 64u);
+
+struct StringEntry {
+  std::uint64_t offset;
+  std::uint64_t length;
+};
+
+/**
+ * Layout:
+ * Header, EventRecord[sceneCount + chartCount + logCount],
+ * XYPoint[pointCount], StringEntry[stringCount], char[stringBytes], char[modelBytes]
+ */
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t recordSize;
+  std::uint64_t sourceSize;
+  std::int64_t sourceModified;
+  std::uint64_t sourceHash;
+  std::uint64_t sceneCount;
+  std::uint64_t chartCount;
+  std::uint64_t logCount;
+  std::uint64_t pointCount;
+  std::uint64_t stringCount;
+  std::uint64_t stringBytes;
+
+  /**
+   * Size of the serialized configuration, nodes, series, etc.
+   *
+   * @see ModelWriter
+   */
+  std::uint64_t modelBytes;
+
+  /**
+   * Hash of everything after the header
+   *
+   * @see hashBody()
+   */
+  std::uint64_t bodyHash;
+};
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(sizeof(parser::XYPoint) == 2u * sizeof(double));
+
+/**
+ * Hash of the full contents of a file.
+ * Not cryptographic, just fast enough to check
+ * hundreds of MB on each load
+ */
+std::uint64_t hashContents(const char *data, std::size_t size) {
+  const std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+  const std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+  // Independent lanes, so the multiplies may overlap
+  std::array<std::uint64_t, 4> lanes{prime1 + prime2, prime2, 0u, 0u - prime1};
+  const auto round = [prime1, prime2](std::uint64_t lane, std::uint64_t input) {
+    return std::rotl(lane + input * prime2, 31) * prime1;
+  };
+
+  std::size_t i = 0u;
+  for (; i + 32u <= size; i += 32u) {
+    for (auto lane = 0u; lane < 4u; lane++) {
+      std::uint64_t word;
+      std::memcpy(&word, data + i + lane * 8u, sizeof(word));
+      lanes[lane] = round(lanes[lane], word);
+    }
+  }
+
+  auto hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+  hash += size;
+  for (; i < size; i++)
+    hash = std::rotl(hash ^ (static_cast<unsigned char>(data[i]) * prime1), 11) * prime2;
+
+  hash ^= hash >> 33;
+  hash *= prime2;
+  hash ^= hash >> 29;
+  return hash;
+}
+
+/**
+ * Hash of the sections following the header, in file order.
+ * Each section is hashed on its own, so the writer does not
+ * need to build the whole file in memory first
+ *
+ * @param sections
+ * The start & length in bytes of each section
+ */
+std::uint64_t hashBody(std::initializer_list<std::pair<const char *, std::size_t>> sections) {
+  std::uint64_t hash = 0u;
+  for (const auto &[data, size] : sections)
+    hash = std::rotl(hash, 17) ^ hashContents(data, size);
+
+  return hash;
+}
+
+/**
+ * Builds the string table, storing each distinct string once
+ */
+class StringTable {
+  std::unordered_map<std::string_view, std::uint64_t> indices;
+
+public:
+  std::vector<StringEntry> entries;
+  std::string blob;
+
+  std::uint64_t intern(const std::string &value) {
+    const auto existing = indices.find(value);
+    if (existing != indices.end())
+      return existing->second;
+
+    const auto index = static_cast<std::uint64_t>(entries.size());
+    entries.emplace_back(StringEntry{blob.size(), value.size()});
+    blob.append(value);
+
+    // Keys view the source strings, which outlive the table
+    indices.emplace(std::string_view{value}, index);
+    return index;
+  }
+};
+
+/**
+ * Matches `T` with or without const,
+ * so the same `fields()` describes a model for reading & writing
+ */
+template <typename T, typename Model>
+concept ModelOf = std::is_same_v<std::remove_const_t<T>, Model>;
+
+template <typename Archive, ModelOf<parser::Ns3ModuleVersion> T>
+void fields(Archive &archive, T &version) {
+  archive(version.major, version.minor, version.patch, version.suffix);
+}
+
+template <typename Archive, ModelOf<parser::GlobalConfiguration> T>
+void fields(Archive &archive, T &config) {
+  archive(config.moduleVersion, config.endTime, config.timeStep, config.granularity, config.minLocation,
+          config.maxLocation);
+}
+
+template <typename Archive, ModelOf<parser::Node> T>
+void fields(Archive &archive, T &node) {
+  archive(node.id, node.name, node.labelEnabled, node.model, node.scale, node.keepRatio, node.height, node.width,
+          node.depth, node.visible, node.position, node.offset, node.baseColor, node.highlightColor, node.trailEnabled,
+          node.trailColor, node.orientation);
+}
+
+template <typename Archive, ModelOf<parser::Building> T>
+void fields(Archive &archive, T &building) {
+  archive(building.id, building.color, building.visible, building.floors, building.roomsX, building.roomsY,
+          building.min, building.max);
+}
+
+template <typename Archive, ModelOf<parser::Decoration> T>
+void fields(Archive &archive, T &decoration) {
+  archive(decoration.id, decoration.model, decoration.position, decoration.orientation, decoration.keepRatio,
+          decoration.height, decoration.width, decoration.depth, decoration.scale);
+}
+
+template <typename Archive, ModelOf<parser::Area> T>
+void fields(Archive &archive, T &area) {
+  archive(area.id, area.name, area.fillColor, area.fillMode, area.borderColor, area.borderMode, area.height,
+          area.points);
+}
+
+template <typename Archive, ModelOf<parser::WiredLink> T>
+void fields(Archive &archive, T &link) {
+  archive(link.nodes);
+}
+
+template <typename Archive, ModelOf<parser::LogicalLink> T>
+void fields(Archive &archive, T &link) {
+  archive(link.id, link.nodes.first, link.nodes.second, link.color, link.active, link.diameter);
+}
+
+template <typename Archive, ModelOf<parser::ValueAxis> T>
+void fields(Archive &archive, T &axis) {
+  archive(axis.name, axis.boundMode, axis.scale, axis.min, axis.max);
+}
+
+template <typename Archive, ModelOf<parser::CategoryAxis::Category> T>
+void fields(Archive &archive, T &category) {
+  archive(category.id, category.name);
+}
+
+template <typename Archive, ModelOf<parser::CategoryAxis> T>
+void fields(Archive &archive, T &axis) {
+  archive(axis.name, axis.values);
+}
+
+template <typename Archive, ModelOf<parser::XYSeries> T>
+void fields(Archive &archive, T &series) {
+  archive(series.id, series.visible, series.name, series.legend, series.connection, series.labelMode,
+          series.pointMode, series.color, series.pointColor, series.xAxis, series.yAxis);
+}
+
+template <typename Archive, ModelOf<parser::CategoryValueSeries> T>
+void fields(Archive &archive, T &series) {
+  archive(series.id, series.visible, series.autoUpdate, series.autoUpdateInterval, series.autoUpdateIncrement,
+          series.name, series.legend, series.color, series.xAxis, series.yAxis);
+}
+
+template <typename Archive, ModelOf<parser::SeriesCollection> T>
+void fields(Archive &archive, T &collection) {
+  archive(collection.id, collection.name, collection.series, collection.xAxis, collection.yAxis);
+}
+
+template <typename Archive, ModelOf<parser::LogStream> T>
+void fields(Archive &archive, T &stream) {
+  archive(stream.id, stream.visible, stream.name, stream.color);
+}
+
+/**
+ * Serializes everything besides the events.
+ * There are few of these compared to the events,
+ * so they are stored field by field, rather than as fixed records
+ */
+class ModelWriter {
+  template <typename T>
+  void write(const T &value) {
+    if constexpr (requires { fields(*this, value); })
+      fields(*this, value);
+    else {
+      static_assert(std::is_trivially_copyable_v<T>, "Model field without a serialization");
+      bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+  }
+
+  void write(bool value) {
+    bytes.push_back(value ? '\1' : '\0');
+  }
+
+  void write(const std::string &value) {
+    write(static_cast<std::uint64_t>(value.size()));
+    bytes.append(value);
+  }
+
+  template <typename T>
+  void write(const std::optional<T> &value) {
+    write(value.has_value());
+    if (value)
+      write(value.value());
+  }
+
+  template <typename T>
+  void write(const std::vector<T> &values) {
+    write(static_cast<std::uint64_t>(values.size()));
+    for (const auto &value : values)
+      write(value);
+  }
+
+public:
+  std::string bytes;
+
+  template <typename... T>
+  void operator()(const T &...values) {
+    (write(values), ...);
+  }
+};
+
+/**
+ * Reads the values written by `ModelWriter`.
+ * Reading past the end marks the reader as failed,
+ * rather than reading outside of the cache
+ */
+class ModelReader {
+  const char *data;
+  std::size_t size;
+  std::size_t offset{0u};
+  bool failed{false};
+
+  void take(void *destination, std::size_t count) {
+    if (failed || count > size - offset) {
+      failed = true;
+      return;
+    }
+
+    std::memcpy(destination, data + offset, count);
+    offset += count;
+  }
+
+  template <typename T>
+  void read(T &value) {
+    if constexpr (requires { fields(*this, value); })
+      fields(*this, value);
+    else {
+      static_assert(std::is_trivially_copyable_v<T>, "Model field without a serialization");
+      take(&value, sizeof(T));
+    }
+  }
+
+  void read(bool &value) {
+    char byte{'\0'};
+    take(&byte, 1u);
+    value = byte != '\0';
+  }
+
+  void read(std::string &value) {
+    std::uint64_t length{0u};
+    read(length);
+    if (failed || length > size - offset) {
+      failed = true;
+      return;
+    }
+
+    value.assign(data + offset, length);
+    offset += length;
+  }
+
+  template <typename T>
+  void read(std::optional<T> &value) {
+    bool present{false};
+    read(present);
+    if (!present) {
+      value.reset();
+      return;
+    }
+
+    read(value.emplace());
+  }
+
+  template <typename T>
+  void read(std::vector<T> &values) {
+    // Every value takes at least one byte,
+    // so a damaged count cannot allocate more than the cache holds
+    std::uint64_t count{0u};
+    read(count);
+    if (failed || count > size - offset) {
+      failed = true;
+      return;
+    }
+
+    values.resize(count);
+    for (auto &value : values) {
+      read(value);
+      if (failed)
+        return;
+    }
+  }
+
+public:
+  ModelReader(const char *data, std::size_t size) : data(data), size(size) {
+  }
+
+  template <typename... T>
+  void operator()(T &...values) {
+    (read(values), ...);
+  }
+
+  /**
+   * @return
+   * True if every read value was in bounds,
+   * and the whole section was read
+   */
+  [[nodiscard]] bool complete() const {
+    return !failed && offset == size;
+  }
+};
+
+/**
+ * True if `T` is one of the types of `Variant`
+ */
+template <typename T, typename Variant>
+struct IsAlternative : std::false_type {};
+
+template <typename T, typename... Types>
+struct IsAlternative<T, std::variant<Types...>> : std::disjunction<std::is_same<T, Types>...> {};
+
+void setColor(EventRecord &record, const parser::Ns3Color3 &color) {
+  record.color = {color.red, color.green, color.blue};
+}
+
+parser::Ns3Color3 getColor(const EventRecord &record) {
+  return {record.color[0], record.color[1], record.color[2]};
+}
+
+/**
+ * Convert an event to a record.
+ * Points & strings are stored in `points` & `strings`
+ */
+template <typename T>
+EventRecord toRecord(const T &e, std::vector<parser::XYPoint> &points, StringTable &strings) {
+  EventRecord record{};
+  record.time = e.time;
+
+  if constexpr (std::is_same_v<T, parser::MoveEvent>) {
+    record.type = RecordType::Move;
+    record.id = e.nodeId;
+    record.values = {e.targetPosition.x, e.targetPosition.y, e.targetPosition.z};
+  } else if constexpr (std::is_same_v<T, parser::NodeModelChangeEvent>) {
+    record.type = RecordType::NodeModelChange;
+    record.id = e.nodeId;
+    record.extra = strings.intern(e.model);
+  } else if constexpr (std::is_same_v<T, parser::TransmitEvent>) {
+    record.type = RecordType::Transmit;
+    record.id = e.nodeId;
+    record.extra = static_cast<std::uint64_t>(e.duration);
+    record.values[0] = e.targetSize;
+    setColor(record, e.color);
+  } else if constexpr (std::is_same_v<T, parser::TransmitEndEvent>) {
+    record.type = RecordType::TransmitEnd;
+    record.id = e.nodeId | (static_cast<std::uint64_t>(e.startEvent.nodeId) << 32u);
+    record.extra = static_cast<std::uint64_t>(e.startEvent.duration);
+    record.count = static_cast<std::uint64_t>(e.startEvent.time);
+    record.values[0] = e.startEvent.targetSize;
+    setColor(record, e.startEvent.color);
+  } else if constexpr (std::is_same_v<T, parser::DecorationMoveEvent>) {
+    record.type = RecordType::DecorationMove;
+    record.id = e.decorationId;
+    record.values = {e.targetPosition.x, e.targetPosition.y, e.targetPosition.z};
+  } else if constexpr (std::is_same_v<T, parser::NodeOrientationChangeEvent>) {
+    record.type = RecordType::NodeOrientation;
+    record.id = e.nodeId;
+    record.values = e.targetOrientation;
+  } else if constexpr (std::is_same_v<T, parser::DecorationOrientationChangeEvent>) {
+    record.type = RecordType::DecorationOrientation;
+    record.id = e.decorationId;
+    record.values = e.targetOrientation;
+  } else if constexpr (std::is_same_v<T, parser::NodeColorChangeEvent>) {
+    record.type = RecordType::NodeColor;
+    record.id = e.nodeId;
+    if (e.type == parser::NodeColorChangeEvent::ColorType::Highlight)
+      record.flags |= HighlightColor;
+    if (e.targetColor) {
+      record.flags |= HasColor;
+      setColor(record, e.targetColor.value());
+    }
+  } else if constexpr (std::is_same_v<T, parser::XYSeriesAddValue>) {
+    record.type = RecordType::XYSeriesAddValue;
+    record.id = e.seriesId;
+    record.values = {e.point.x, e.point.y, 0.0};
+  } else if constexpr (std::is_same_v<T, parser::XYSeriesAddValues>) {
+    record.type = RecordType::XYSeriesAddValues;
+    record.id = e.seriesId;
+    record.extra = points.size();
+    record.count = e.points.size();
+    points.insert(points.end(), e.points.begin(), e.points.end());
+  } else if constexpr (std::is_same_v<T, parser::XYSeriesClear>) {
+    record.type = RecordType::XYSeriesClear;
+    record.id = e.seriesId;
+  } else if constexpr (std::is_same_v<T, parser::CategorySeriesAddValue>) {
+    record.type = RecordType::CategorySeriesAddValue;
+    record.id = e.seriesId;
+    record.extra = e.category;
+    record.values[0] = e.value;
+  } else if constexpr (std::is_same_v<T, parser::StreamAppendEvent>) {
+    record.type = RecordType::StreamAppend;
+    record.id = e.streamId;
+    record.extra = strings.intern(e.value);
+  } else if constexpr (std::is_same_v<T, parser::LogicalLinkCreate>) {
+    record.type = RecordType::LogicalLinkCreate;
+    record.id = e.model.id;
+    record.extra = e.model.nodes.first;
+    record.count = e.model.nodes.second;
+    if (e.model.active)
+      record.flags |= Active;
+    record.values[0] = e.model.diameter;
+    setColor(record, e.model.color);
+  } else if constexpr (std::is_same_v<T, parser::LogicalLinkUpdate>) {
+    record.type = RecordType::LogicalLinkUpdate;
+    record.id = e.id;
+    record.extra = e.nodes.first;
+    record.count = e.nodes.second;
+    if (e.active)
+      record.flags |= Active;
+    record.values[0] = e.diameter;
+    setColor(record, e.color);
+  } else
+    static_assert(!sizeof(T), "Event type without a record type");
+
+  return record;
+}
+
+/**
+ * Rebuild an event from `record`, and pass it to `emit`
+ *
+ * @param emit
+ * Called with the rebuilt event.
+ * Returns False if the event does not belong in the section being read
+ *
+ * @return
+ * False if the record refers to points or strings outside the cache,
+ * or `emit` rejected the event. True otherwise
+ */
+template <typename Emit>
+bool fromRecord(const EventRecord &record, const char *points, std::uint64_t pointCount, const char *entries,
+                std::uint64_t stringCount, const char *blob, std::uint64_t stringBytes, Emit &&emit) {
+  const auto getString = [entries, stringCount, blob, stringBytes](std::uint64_t index) -> std::optional<std::string> {
+    if (index >= stringCount)
+      return {};
+
+    StringEntry entry;
+    std::memcpy(&entry, entries + index * sizeof(StringEntry), sizeof(StringEntry));
+    if (entry.offset > stringBytes || entry.length > stringBytes - entry.offset)
+      return {};
+
+    return std::string{blob + entry.offset, entry.length};
+  };
+
+  switch (record.type) {
+  case RecordType::Move: {
+    parser::MoveEvent event;
+    event.time = record.time;
+    event.nodeId = static_cast<uint32_t>(record.id);
+    event.targetPosition.x = static_cast<float>(record.values[0]);
+    event.targetPosition.y = static_cast<float>(record.values[1]);
+    event.targetPosition.z = static_cast<float>(record.values[2]);
+    return emit(std::move(event));
+  }
+  case RecordType::NodeModelChange: {
+    parser::NodeModelChangeEvent event;
+    event.time = record.time;
+    event.nodeId = static_cast<uint32_t>(record.id);
+
+    auto model = getString(record.extra);
+    if (!model)
+      return false;
+    event.model = std::move(model.value());
+    return emit(std::move(event));
+  }
+  case RecordType::Transmit: {
+    parser::TransmitEvent event;
+    event.time = record.time;
+    event.nodeId = static_cast<uint32_t>(record.id);
+    event.duration = static_cast<parser::nanoseconds>(record.extra);
+    event.targetSize = record.values[0];
+    event.color = getColor(record);
+    return emit(std::move(event));
+  }
+  case RecordType::TransmitEnd: {
+    parser::TransmitEndEvent event;
+    event.time = record.time;
+    event.nodeId = static_cast<uint32_t>(record.id);
+    event.startEvent.time = static_cast<parser::nanoseconds>(record.count);
+    event.startEvent.nodeId = static_cast<uint32_t>(record.id >> 32u);
+    event.startEvent.duration = static_cast<parser::nanoseconds>(record.extra);
+    event.startEvent.targetSize = record.values[0];
+    event.startEvent.color = getColor(record);
+    return emit(std::move(event));
+  }
+  case RecordType::DecorationMove: {
+    parser::DecorationMoveEvent event;
+    event.time = record.time;
+    event.decorationId = static_cast<uint32_t>(record.id);
+    event.targetPosition.x = static_cast<float>(record.values[0]);
+    event.targetPosition.y = static_cast<float>(record.values[1]);
+    event.targetPosition.z = static_cast<float>(record.values[2]);
+    return emit(std::move(event));
+  }
+  case RecordType::NodeOrientation: {
+    parser::NodeOrientationChangeEvent event;
+    event.time = record.time;
+    event.nodeId = static_cast<uint32_t>(record.id);
+    event.targetOrientation = record.values;
+    return emit(std::move(event));
+  }
+  case RecordType::DecorationOrientation: {
+    parser::DecorationOrientationChangeEvent event;
+    event.time = record.time;
+    event.decorationId = static_cast<uint32_t>(record.id);
+    event.targetOrientation = record.values;
+    return emit(std::move(event));
+  }
+  case RecordType::NodeColor: {
+    parser::NodeColorChangeEvent event;
+    event.time = record.time;
+    event.nodeId = static_cast<unsigned int>(record.id);
+    event.type = (record.flags & HighlightColor) ? parser::NodeColorChangeEvent::ColorType::Highlight
+                                                  : parser::NodeColorChangeEvent::ColorType::Base;
+    if (record.flags & HasColor)
+      event.targetColor = getColor(record);
+    return emit(std::move(event));
+  }
+  case RecordType::XYSeriesAddValue: {
+    parser::XYSeriesAddValue event;
+    event.time = record.time;
+    event.seriesId = static_cast<uint32_t>(record.id);
+    event.point = {record.values[0], record.values[1]};
+    return emit(std::move(event));
+  }
+  case RecordType::XYSeriesAddValues: {
+    if (record.extra > pointCount || record.count > pointCount - record.extra)
+      return false;
+
+    parser::XYSeriesAddValues event;
+    event.time = record.time;
+    event.seriesId = static_cast<uint32_t>(record.id);
+    event.points.resize(record.count);
+    std::memcpy(event.points.data(), points + record.extra * sizeof(parser::XYPoint),
+                record.count * sizeof(parser::XYPoint));
+    return emit(std::move(event));
+  }
+  case RecordType::XYSeriesClear: {
+    parser::XYSeriesClear event;
+    event.time = record.time;
+    event.seriesId = static_cast<uint32_t>(record.id);
+    return emit(std::move(event));
+  }
+  case RecordType::CategorySeriesAddValue: {
+    parser::CategorySeriesAddValue event;
+    event.time = record.time;
+    event.seriesId = static_cast<uint32_t>(record.id);
+    event.category = static_cast<unsigned int>(record.extra);
+    event.value = record.values[0];
+    return emit(std::move(event));
+  }
+  case RecordType::StreamAppend: {
+    parser::StreamAppendEvent event;
+    event.time = record.time;
+    event.streamId = static_cast<unsigned int>(record.id);
+
+    auto value = getString(record.extra);
+    if (!value)
+      return false;
+    event.value = std::move(value.value());
+    return emit(std::move(event));
+  }
+  case RecordType::LogicalLinkCreate: {
+    parser::LogicalLinkCreate event;
+    event.time = record.time;
+    event.model.id = static_cast<parser::LogicalLink::LinkId>(record.id);
+    event.model.nodes = {static_cast<unsigned int>(record.extra), static_cast<unsigned int>(record.count)};
+    event.model.active = record.flags & Active;
+    event.model.color = getColor(record);
+    event.model.diameter = static_cast<float>(record.values[0]);
+    return emit(std::move(event));
+  }
+  case RecordType::LogicalLinkUpdate: {
+    parser::LogicalLinkUpdate event;
+    event.time = record.time;
+    event.id = static_cast<parser::LogicalLink::LinkId>(record.id);
+    event.nodes = {static_cast<unsigned int>(record.extra), static_cast<unsigned int>(record.count)};
+    event.active = record.flags & Active;
+    event.color = getColor(record);
+    event.diameter = static_cast<float>(record.values[0]);
+    return emit(std::move(event));
+  }
+  }
+
+  return false;
+}
+
+template <typename T>
+void writeRaw(std::ofstream &out, const T *values, std::size_t count) {
+  out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+namespace parser::cache {
+
+std::string cachePath(const std::filesystem::path &directory, const char *scenarioPath) {
+  std::error_code error;
+  auto source = std::filesystem::absolute(scenarioPath, error);
+  if (error)
+    source = scenarioPath;
+
+  const auto sourceName = source.lexically_normal().string();
+  std::array<char, 17> name{};
+  std::snprintf(name.data(), name.size(), "%016llx",
+                static_cast<unsigned long long>(hashContents(sourceName.data(), sourceName.size())));
+
+  return (directory / (std::string{name.data()} + ".nsz")).string();
+}
+
+std::optional<SourceStamp> stamp(const char *scenarioPath, const char *data, std::size_t size) {
+  std::error_code error;
+  const auto modified = std::filesystem::last_write_time(scenarioPath, error);
+  if (error)
+    return {};
+
+  return SourceStamp{size, static_cast<std::int64_t>(modified.time_since_epoch().count()), hashContents(data, size)};
+}
+
+bool write(const std::string &path, const SourceStamp &source, const FileParser &fileParser) {
+  const auto &sceneEvents = fileParser.getSceneEvents();
+  const auto &chartEvents = fileParser.getChartsEvents();
+  const auto &logEvents = fileParser.getLogEvents();
+
+  std::vector<EventRecord> records;
+  records.reserve(sceneEvents.size() + chartEvents.size() + logEvents.size());
+  std::vector<XYPoint> points;
+  StringTable strings;
+
+  const auto addRecord = [&records, &points, &strings](const auto &e) {
+    records.emplace_back(toRecord(e, points, strings));
+  };
+
+  for (const auto &event : sceneEvents)
+    std::visit(addRecord, event);
+  const auto sceneCount = records.size();
+
+  for (const auto &event : chartEvents)
+    std::visit(addRecord, event);
+  const auto chartCount = records.size() - sceneCount;
+
+  for (const auto &event : logEvents)
+    std::visit(addRecord, event);
+  const auto logCount = records.size() - sceneCount - chartCount;
+
+  ModelWriter models;
+  models(fileParser.getConfiguration(), fileParser.getNodes(), fileParser.getBuildings(), fileParser.getDecorations(),
+         fileParser.getAreas(), fileParser.getLinks(), fileParser.getLogicalLinks(), fileParser.getXYSeries(),
+         fileParser.getCategoryValueSeries(), fileParser.getSeriesCollections(), fileParser.getLogStreams());
+
+  Header header{};
+  header.magic = cacheMagic;
+  header.version = cacheVersion;
+  header.recordSize = sizeof(EventRecord);
+  header.sourceSize = source.size;
+  header.sourceModified = source.modified;
+  header.sourceHash = source.hash;
+  header.sceneCount = sceneCount;
+  header.chartCount = chartCount;
+  header.logCount = logCount;
+  header.pointCount = points.size();
+  header.stringCount = strings.entries.size();
+  header.stringBytes = strings.blob.size();
+  header.modelBytes = models.bytes.size();
+  header.bodyHash = hashBody({{reinterpret_cast<const char *>(records.data()), records.size() * sizeof(EventRecord)},
+                              {reinterpret_cast<const char *>(points.data()), points.size() * sizeof(XYPoint)},
+                              {reinterpret_cast<const char *>(strings.entries.data()),
+                               strings.entries.size() * sizeof(StringEntry)},
+                              {strings.blob.data(), strings.blob.size()},
+                              {models.bytes.data(), models.bytes.size()}});
+
+  const auto temporaryPath = path + ".tmp";
+  {
+    std::ofstream out{temporaryPath, std::ios::binary | std::ios::trunc};
+    if (!out)
+      return false;
+
+    writeRaw(out, &header, 1u);
+    writeRaw(out, records.data(), records.size());
+    writeRaw(out, points.data(), points.size());
+    writeRaw(out, strings.entries.data(), strings.entries.size());
+    writeRaw(out, strings.blob.data(), strings.blob.size());
+    writeRaw(out, models.bytes.data(), models.bytes.size());
+
+    if (!out.flush()) {
+      out.close();
+      std::filesystem::remove(temporaryPath);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+
+  return true;
+}
+
+std::optional<ParseResult> read(const std::string &path, const char *scenarioPath, const char *data,
+                                std::size_t size) {
+  MappedFile file{path.c_str()};
+  if (!file.isOpen() || file.size() < sizeof(Header))
+    return {};
+
+  Header header;
+  std::memcpy(&header, file.data(), sizeof(Header));
+
+  if (header.magic != cacheMagic || header.version != cacheVersion || header.recordSize != sizeof(EventRecord))
+    return {};
+
+  // Cheap checks first
+  std::error_code error;
+  const auto modified = std::filesystem::last_write_time(scenarioPath, error);
+  if (error || header.sourceSize != size ||
+      header.sourceModified != static_cast<std::int64_t>(modified.time_since_epoch().count()))
+    return {};
+
+  // The hash reads the whole scenario, so it runs while the cache is read.
+  // Nothing read from the cache is used unless it matches
+  auto sourceHash = std::async(std::launch::async, hashContents, data, size);
+
+  // Make sure every section fits in the file before reading
+  const auto recordCount = header.sceneCount + header.chartCount + header.logCount;
+  const std::array<std::pair<std::uint64_t, std::uint64_t>, 5> sections{
+      std::pair{recordCount, sizeof(EventRecord)}, std::pair{header.pointCount, sizeof(XYPoint)},
+      std::pair{header.stringCount, sizeof(StringEntry)}, std::pair{header.stringBytes, std::uint64_t{1u}},
+      std::pair{header.modelBytes, std::uint64_t{1u}}};
+
+  std::uint64_t expectedSize = sizeof(Header);
+  for (const auto &[count, elementSize] : sections) {
+    if (count > (file.size() - expectedSize) / elementSize)
+      return {};
+    expectedSize += count * elementSize;
+  }
+
+  if (expectedSize != file.size())
+    return {};
+
+  const auto records = file.data() + sizeof(Header);
+  const auto points = records + recordCount * sizeof(EventRecord);
+  const auto entries = points + header.pointCount * sizeof(XYPoint);
+  const auto blob = entries + header.stringCount * sizeof(StringEntry);
+  const auto modelData = blob + header.stringBytes;
+
+  // The stamp only covers the scenario, so check the records themselves
+  // have not been damaged before trusting any of them
+  if (header.bodyHash != hashBody({{records, recordCount * sizeof(EventRecord)},
+                                   {points, header.pointCount * sizeof(XYPoint)},
+                                   {entries, header.stringCount * sizeof(StringEntry)},
+                                   {blob, header.stringBytes},
+                                   {modelData, header.modelBytes}})) {
+    std::cerr << "Ignoring corrupt scenario cache: " << path << '\n';
+    return {};
+  }
+
+  ParseResult result;
+  ModelReader models{modelData, header.modelBytes};
+  models(result.configuration, result.nodes, result.buildings, result.decorations, result.areas, result.wiredLinks,
+         result.logicalLinks, result.xySeries, result.categoryValueSeries, result.seriesCollections,
+         result.logStreams);
+
+  if (!models.complete()) {
+    std::cerr << "Ignoring corrupt scenario cache: " << path << '\n';
+    return {};
+  }
+
+  // Events are stored after the `JsonHandler` bookkeeping,
+  // so they are read straight into their final collections
+  const auto readEvents = [&](auto &events, std::uint64_t first, std::uint64_t count) {
+    using Variant = typename std::decay_t<decltype(events)>::value_type;
+    const auto emit = [&events](auto &&event) {
+      using T = std::decay_t<decltype(event)>;
+      if constexpr (IsAlternative<T, Variant>::value) {
+        events.emplace_back(std::in_place_type<T>, std::forward<decltype(event)>(event));
+        return true;
+      } else
+        return false;
+    };
+
+    events.reserve(count);
+    for (auto index = first; index < first + count; index++) {
+      EventRecord record;
+      std::memcpy(&record, records + index * sizeof(EventRecord), sizeof(EventRecord));
+
+      if (!fromRecord(record, points, header.pointCount, entries, header.stringCount, blob, header.stringBytes,
+                      emit))
+        return false;
+    }
+    return true;
+  };
+
+  if (!readEvents(result.sceneEvents, 0u, header.sceneCount) ||
+      !readEvents(result.chartEvents, header.sceneCount, header.chartCount) ||
+      !readEvents(result.logEvents, header.sceneCount + header.chartCount, header.logCount)) {
+    std::cerr << "Ignoring corrupt scenario cache: " << path << '\n';
+    return {};
+  }
+
+  if (sourceHash.get() != header.sourceHash)
+    return {};
+
+  return result;
+}
+
+} // namespace parser::cache
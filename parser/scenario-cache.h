@@ -0,0 +1,138 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+#pragma once
+#include "file-parser.h"
+#include "model.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Binary cache ('.nsz') holding everything read from a scenario file,
+ * so later loads of the same file may skip parsing it entirely.
+ *
+ * Events are stored after the `JsonHandler` bookkeeping,
+ * as fixed size records. Strings are interned into a single table.
+ * The remaining models follow, serialized field by field
+ */
+namespace parser::cache {
+
+/**
+ * Identifies the exact scenario file a cache was built from
+ */
+struct SourceStamp {
+  std::uint64_t size;
+  std::int64_t modified;
+  std::uint64_t hash;
+};
+
+/**
+ * Get the path of the cache for a scenario file.
+ * Caches are named by a hash of the absolute path of the scenario,
+ * so each scenario has one cache, replaced when the scenario changes
+ *
+ * @param directory
+ * The directory caches are kept in
+ *
+ * @param scenarioPath
+ * The path to the scenario file
+ *
+ * @return
+ * The path to the cache in `directory`
+ */
+[[nodiscard]] std::string cachePath(const std::filesystem::path &directory, const char *scenarioPath);
+
+/**
+ * Build the stamp identifying a scenario file
+ *
+ * @param scenarioPath
+ * The path to the scenario file
+ *
+ * @param data
+ * The contents of the scenario file
+ *
+ * @param size
+ * The length of `data`
+ *
+ * @return
+ * The stamp for the file, or an empty optional
+ * if its modification time could not be read
+ */
+[[nodiscard]] std::optional<SourceStamp> stamp(const char *scenarioPath, const char *data, std::size_t size);
+
+/**
+ * Write the cache for a parsed scenario file.
+ * Written to a temporary file first, so a failed write
+ * never leaves a partial cache behind
+ *
+ * @param path
+ * Where to write the cache
+ *
+ * @param source
+ * The stamp of the scenario file
+ *
+ * @param fileParser
+ * The parser which just read the scenario file
+ *
+ * @return
+ * True if the cache was written, False otherwise
+ */
+bool write(const std::string &path, const SourceStamp &source, const FileParser &fileParser);
+
+/**
+ * Read everything from the cache at `path`,
+ * if it was built from the scenario file at `scenarioPath`
+ *
+ * @param path
+ * The path to the cache
+ *
+ * @param scenarioPath
+ * The path to the scenario file
+ *
+ * @param data
+ * The contents of the scenario file
+ *
+ * @param size
+ * The length of `data`
+ *
+ * @return
+ * The same result as parsing the scenario file, or an empty optional
+ * if the cache is missing, from another version, out of date, or corrupt
+ */
+[[nodiscard]] std::optional<ParseResult> read(const std::string &path, const char *scenarioPath, const char *data,
+                                              std::size_t size);
+
+} // namespace parser::cache
@@ -1,10 +1,14 @@
 #version 330
 
 layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec3 in_color;
 
 uniform mat4 view;
 uniform mat4 projection;
 
+out vec3 vertex_color;
+
 void main() {
     gl_Position = projection * view * vec4(in_position, 1.0);
+    vertex_color = in_color;
 }
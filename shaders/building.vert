@@ -1,10 +1,19 @@
 #version 330
 
 layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec3 in_color;
 
 uniform mat4 view;
 uniform mat4 projection;
 
+// Batched buildings carry their color in each vertex,
+// everything else drawn with this shader uses `color`
+uniform bool useVertexColor;
+uniform vec3 color;
+
+out vec3 vertex_color;
+
 void main() {
     gl_Position = projection * view * vec4(in_position, 1.0);
+    vertex_color = useVertexColor ? in_color : color;
 }
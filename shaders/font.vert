@@ -1,23 +1,34 @@
 #version 330 core
 
-layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+// One instance per quad, expanded into two triangles facing the camera
+layout (location = 0) in vec3 anchor;         // Bottom-center of the label, in world coordinates
+layout (location = 1) in vec4 bounds;         // <vec2 min, vec2 max>, relative to `anchor`
+layout (location = 2) in vec4 texture_bounds; // <vec2 top left, vec2 bottom right>
 out vec2 TexCoords;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// Inverse of the camera rotation
+uniform mat4 billboard;
+uniform float scale;
 
-void main() {
-    mat4 mvp = projection * view * model;
-    float d = sqrt(mvp[0][0] * mvp[0][0] + mvp[1][0] * mvp[1][0] + mvp[2][0]* mvp[2][0]);
+// Offset of the quad towards/away from the camera, before scaling
+uniform float depth_offset;
 
+// Corners of the two triangles, between the min (0) & max (1) of the quad
+const vec2 corners[6] = vec2[](
+    vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0),
+    vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 1.0)
+);
 
-    mvp[0] = vec4(1, 1, 1, mvp[0][3]);
-    mvp[1] = vec4(1, 1, 1, mvp[1][3]);
-    mvp[2] = vec4(1, 1, 1, mvp[2][3]);
+void main() {
+    vec2 corner = corners[gl_VertexID];
+    vec2 position = mix(bounds.xy, bounds.zw, corner);
 
+    vec4 offset = billboard * vec4(vec3(position, depth_offset) * scale, 0.0);
+    gl_Position = projection * view * vec4(anchor + offset.xyz, 1.0);
 
-    gl_Position = projection * view * model * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
+    // The atlas runs top to bottom
+    TexCoords = mix(texture_bounds.xy, texture_bounds.zw, vec2(corner.x, 1.0 - corner.y));
 }
@@ -3,12 +3,24 @@
 in vec2 texture_coordinates;
 in vec3 normal;
 in vec3 fragment_position;
+flat in vec3 base_color;
+flat in vec3 highlight_color;
+flat in uint flags;
 
 out vec4 final_color;
 
 const uint maxPointLights = 5u;
 const uint maxSpotLights = 5u;
 
+// Matches `Mesh::InstanceFlag`
+const uint hasBaseColor = 1u;
+const uint hasHighlightColor = 2u;
+const uint selected = 4u;
+
+// Matches `Material::MaterialType`
+const int materialBase = 1;
+const int materialHighlight = 2;
+
 struct Light {
     vec3 color;
     float ambient_intensity;
@@ -54,6 +66,11 @@ uniform vec3 eye_position;
 
 uniform vec3 material_color;
 
+// Set when drawing instances, which carry their own
+// colors & selection in `flags`
+uniform bool instanced = false;
+uniform int material_type = 0;
+
 uniform bool is_selected;
 
 vec4 lightByDirection(Light base, vec3 direction) {
@@ -136,14 +153,22 @@ vec4 calculateSpotLights() {
 
 void main()
 {
+    vec3 color = material_color;
+    if (instanced) {
+        if (material_type == materialBase && (flags & hasBaseColor) != 0u)
+            color = base_color;
+        else if (material_type == materialHighlight && (flags & hasHighlightColor) != 0u)
+            color = highlight_color;
+    }
+
     // Choose Material color or Texture for the base
-    final_color = mix(vec4(material_color, 1.0), texture(texture_sampler, texture_coordinates), int(useTexture));
+    final_color = mix(vec4(color, 1.0), texture(texture_sampler, texture_coordinates), int(useTexture));
 
     if (useLighting)
         final_color *= calculateDirectionalLight() + calculatePointLights() + calculateSpotLights();
     
     // Significantly decrease colors aside from green in selected items
-    if (is_selected) {
+    if (is_selected || (flags & selected) != 0u) {
         final_color *= vec4(0.5, 1.5, 0.5, 1.0);
         if (final_color.g < 0.1)
             final_color.g += 0.25;
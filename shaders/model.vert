@@ -4,22 +4,37 @@ layout (location = 0) in vec3 in_position;
 layout (location = 1) in vec3 in_normal;
 layout (location = 2) in vec2 in_texture;
 
+// Per-instance attributes, only used when `instanced` is set
+layout (location = 3) in mat4 instance_model;
+layout (location = 7) in vec3 instance_base_color;
+layout (location = 8) in vec3 instance_highlight_color;
+layout (location = 9) in uint instance_flags;
+
 out vec2 texture_coordinates;
 out vec3 normal;
 out vec3 fragment_position;
+flat out vec3 base_color;
+flat out vec3 highlight_color;
+flat out uint flags;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform bool instanced = false;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(in_position, 1.0);
+    mat4 model_matrix = instanced ? instance_model : model;
+    base_color = instance_base_color;
+    highlight_color = instance_highlight_color;
+    flags = instanced ? instance_flags : 0u;
+
+    gl_Position = projection * view * model_matrix * vec4(in_position, 1.0);
     texture_coordinates = in_texture;
 
     // Only nessary if we allow non-uniform scaling
-    mat3 Nonuniform_scale_model = mat3(transpose(inverse(model)));
+    mat3 Nonuniform_scale_model = mat3(transpose(inverse(model_matrix)));
 
     normal = Nonuniform_scale_model * in_normal;
-    fragment_position = (model * vec4(in_position, 1.0)).xyz;
+    fragment_position = (model_matrix * vec4(in_position, 1.0)).xyz;
 }
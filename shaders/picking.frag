@@ -1,7 +1,8 @@
 #version 330
 
+flat in uint id;
+
 uniform uint object_type;
-uniform uint object_id;
 
 out uvec3 picking_fragment;
 
@@ -10,5 +11,5 @@ void main() {
     // in the texture, since by default, OpenGL will, clear to 0
     // so, we need some way to tell an object was rendered at this
     // fragment
-    picking_fragment = uvec3(1.0, object_type, object_id);
+    picking_fragment = uvec3(1.0, object_type, id);
 }
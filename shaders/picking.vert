@@ -2,10 +2,16 @@
 
 layout (location = 0) in vec3 in_position;
 
-uniform mat4 model;
+// Per-instance attributes
+layout (location = 3) in mat4 instance_model;
+layout (location = 10) in uint instance_id;
+
+flat out uint id;
+
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
-    gl_Position = projection * view * model * vec4(in_position, 1.0);
+    id = instance_id;
+    gl_Position = projection * view * instance_model * vec4(in_position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+// Times `ChartManager` playback with many series & collections.
+// Synthetic XY series are spread over the collections, then a stream of chart events
+// is played through frame by frame, as the playback controls would.
+// Run with `QT_QPA_PLATFORM=offscreen` where there is no display.
+//
+// Usage: chart-bench [event count] [frame length (ms)]
+
+#include "src/window/chart/ChartManager.h"
+#include <QApplication>
+#include <QMainWindow>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned int seriesCount{3000u};
+const unsigned int collectionCount{50u};
+
+/**
+ * Each series is in this many collections
+ */
+const unsigned int collectionsPerSeries{2u};
+
+/**
+ * The ID of the first XY series.
+ * IDs before it are used by the collections
+ */
+const unsigned int firstSeriesId{collectionCount + 1u};
+
+parser::ValueAxis makeAxis(const std::string &name) {
+  parser::ValueAxis axis;
+  axis.name = name;
+  axis.boundMode = parser::ValueAxis::BoundMode::HighestValue;
+  return axis;
+}
+
+std::vector<parser::XYSeries> makeSeries() {
+  std::vector<parser::XYSeries> series;
+  series.reserve(seriesCount);
+
+  for (auto i = 0u; i < seriesCount; i++) {
+    parser::XYSeries model;
+    model.id = firstSeriesId + i;
+    model.visible = true;
+    model.name = "Series " + std::to_string(i);
+    model.legend = model.name;
+    model.color = {static_cast<uint8_t>(i), static_cast<uint8_t>(i * 7u), static_cast<uint8_t>(i * 13u)};
+    model.pointColor = model.color;
+    model.xAxis = makeAxis("X");
+    model.yAxis = makeAxis("Y");
+    series.emplace_back(std::move(model));
+  }
+
+  return series;
+}
+
+std::vector<parser::SeriesCollection> makeCollections() {
+  std::vector<parser::SeriesCollection> collections;
+  collections.reserve(collectionCount);
+
+  for (auto i = 0u; i < collectionCount; i++) {
+    parser::SeriesCollection collection;
+    collection.id = i + 1u;
+    collection.name = "Collection " + std::to_string(i);
+    collection.xAxis = makeAxis("X");
+    collection.yAxis = makeAxis("Y");
+    collections.emplace_back(std::move(collection));
+  }
+
+  // Spread the memberships of each series over collections `stride` apart
+  const auto stride = collectionCount / collectionsPerSeries;
+  for (auto i = 0u; i < seriesCount; i++) {
+    for (auto j = 0u; j < collectionsPerSeries; j++)
+      collections[(i + j * stride) % collectionCount].series.emplace_back(firstSeriesId + i);
+  }
+
+  return collections;
+}
+
+/**
+ * Generate `count` events for random series, 1us apart.
+ * Mostly single values, with some batches of values
+ */
+std::vector<parser::ChartEvent> makeEvents(std::size_t count) {
+  std::mt19937 random{42u};
+  std::uniform_int_distribution<unsigned int> seriesId{firstSeriesId, firstSeriesId + seriesCount - 1u};
+  std::uniform_real_distribution<double> value{0.0, 100.0};
+  std::uniform_int_distribution<int> type{0, 9};
+
+  std::vector<parser::ChartEvent> events;
+  events.reserve(count);
+
+  for (std::size_t i = 0u; i < count; i++) {
+    const auto time = static_cast<parser::nanoseconds>(i) * 1'000LL;
+    const auto x = static_cast<double>(time) / 1e9;
+
+    if (type(random) == 0) {
+      parser::XYSeriesAddValues event;
+      event.time = time;
+      event.seriesId = seriesId(random);
+      for (auto p = 0; p < 4; p++)
+        event.points.emplace_back(parser::XYPoint{x, value(random)});
+      events.emplace_back(std::move(event));
+    } else {
+      parser::XYSeriesAddValue event;
+      event.time = time;
+      event.seriesId = seriesId(random);
+      event.point = {x, value(random)};
+      events.emplace_back(event);
+    }
+  }
+
+  return events;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // Kept apart from the application's settings,
+  // so the user's chart layout is neither restored nor changed
+  QCoreApplication::setOrganizationName("NIST");
+  QCoreApplication::setApplicationName("chart-bench");
+  QApplication application{argc, argv};
+
+  const std::size_t eventCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000u;
+  const parser::nanoseconds frameLength = (argc > 2 ? std::atoll(argv[2]) : 16LL) * 1'000'000LL;
+
+  QMainWindow window;
+  netsimulyzer::ChartManager manager{&window};
+
+  manager.addSeries(makeSeries(), makeCollections(), {});
+
+  auto events = makeEvents(eventCount);
+  const auto endTime = static_cast<parser::nanoseconds>(eventCount) * 1'000LL;
+  manager.enqueueEvents(std::move(events), endTime);
+
+  std::printf("%u series, %u collections (%u per series), %zu events, %lld ms frames\n", seriesCount,
+              collectionCount, collectionsPerSeries, eventCount, frameLength / 1'000'000LL);
+
+  double total{0.0};
+  double worst{0.0};
+  std::size_t frames{0u};
+  for (parser::nanoseconds time = frameLength; time < endTime + frameLength; time += frameLength, frames++) {
+    const auto begin = std::chrono::steady_clock::now();
+    manager.timeChanged(time, frameLength);
+    const auto elapsed =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    total += elapsed;
+    worst = std::max(worst, elapsed);
+  }
+
+  std::printf("Total:       %9.1f ms\n", total);
+  std::printf("Mean frame:  %9.3f ms over %zu frames\n", total / static_cast<double>(frames), frames);
+  std::printf("Worst frame: %9.3f ms\n", worst);
+  return EXIT_SUCCESS;
+}
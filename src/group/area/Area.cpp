@@ -32,17 +32,19 @@
  */
 
 #include "Area.h"
-#include "../../conversion.h"
 #include <utility>
 
 namespace netsimulyzer {
 
 Area::Area(Area::RenderInfo renderInfo, parser::Area model) : renderInfo(renderInfo), model(std::move(model)) {
-  this->renderInfo.fillColor = toRenderColor(this->model.fillColor);
 }
 
 const Area::RenderInfo &Area::getRenderInfo() const {
   return renderInfo;
 }
 
+const parser::Area &Area::getModel() const {
+  return model;
+}
+
 } // namespace netsimulyzer
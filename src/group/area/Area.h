@@ -33,25 +33,22 @@
 
 #pragma once
 
-#include <glm/vec3.hpp>
+#include "../../render/mesh/StaticBatch.h"
 #include <model.h>
 
 namespace netsimulyzer {
 
 class Area {
 public:
+  /**
+   * Where the area is in the `Renderer`'s shared area batch
+   */
   struct RenderInfo {
-    bool renderBorder = true;
-    unsigned int borderVao = 0u;
-    unsigned int borderVbo = 0u;
-    unsigned int borderVbo_size = 0u;
-    glm::vec3 borderColor;
-
-    bool renderFill = true;
-    unsigned int fillVao = 0u;
-    unsigned int fillVbo = 0u;
-    unsigned int fillVbo_size = 0u;
-    glm::vec3 fillColor;
+    /**
+     * The fill, followed by the border.
+     * Either may be empty, depending on the draw modes of the area
+     */
+    StaticBatch::Range range;
   };
 
 private:
@@ -62,6 +59,7 @@ public:
   Area(RenderInfo renderInfo, parser::Area model);
 
   [[nodiscard]] const RenderInfo &getRenderInfo() const;
+  [[nodiscard]] const parser::Area &getModel() const;
 };
 
 } // namespace netsimulyzer
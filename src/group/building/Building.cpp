@@ -43,12 +43,13 @@ const Building::RenderInfo &Building::getRenderInfo() const {
   return renderInfo;
 }
 
+const parser::Building &Building::getModel() const {
+  return model;
+}
+
 const glm::vec3 &Building::getColor() const {
   return color;
 }
-void Building::setColor(const glm::vec3 &value) {
-  color = value;
-}
 
 bool Building::visible() const {
   return model.visible;
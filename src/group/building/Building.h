@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include "../../render/mesh/StaticBatch.h"
 #include "../../render/shader/Shader.h"
 #include <QOpenGLFunctions_4_5_Core>
 #include <array>
@@ -43,16 +44,20 @@ namespace netsimulyzer {
 
 class Building {
 public:
+  /**
+   * Where the building is in the `Renderer`'s shared building batches
+   */
   struct RenderInfo {
-    unsigned int vao = 0u;
-    unsigned int vbo = 0u;
-    unsigned int ibo = 0u;
-    unsigned int ibo_size = 0u;
+    /**
+     * The walls & floors, in the batch of building triangles.
+     * The color of the building is included in the vertices
+     */
+    StaticBatch::Range faces;
 
-    unsigned int lineVao = 0u;
-    unsigned int lineVbo = 0u;
-    unsigned int lineIbo = 0u;
-    unsigned int lineIboSize = 0u;
+    /**
+     * The border, in the batch of building outlines
+     */
+    StaticBatch::Range outline;
   };
 
 private:
@@ -64,9 +69,9 @@ public:
   Building(const Building::RenderInfo &renderInfo, const parser::Building &model);
 
   [[nodiscard]] const Building::RenderInfo &getRenderInfo() const;
+  [[nodiscard]] const parser::Building &getModel() const;
 
   [[nodiscard]] const glm::vec3 &getColor() const;
-  void setColor(const glm::vec3 &value);
   [[nodiscard]] bool visible() const;
 };
 
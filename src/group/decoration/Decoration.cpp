@@ -33,64 +33,77 @@
 
 #include "Decoration.h"
 #include "../../conversion.h"
-#include "../../util/undo-events.h"
 
 namespace netsimulyzer {
 
-Decoration::Decoration(const Model &model, const parser::Decoration &ns3Model) : model(model), ns3Model(ns3Model) {
-  this->model.setPosition(toRenderCoordinate(ns3Model.position));
-  this->model.setRotate(ns3Model.orientation[0], ns3Model.orientation[2], -ns3Model.orientation[1]);
+void Decoration::applyModelProperties() {
+  model.setPosition(toRenderCoordinate(ns3Model.position));
+  model.setRotate(ns3Model.orientation[0], ns3Model.orientation[2], -ns3Model.orientation[1]);
 
-  this->model.setKeepRatio(ns3Model.keepRatio);
+  model.setKeepRatio(ns3Model.keepRatio);
   const auto &bounds = model.getBounds();
   if (ns3Model.height) {
     const auto height = std::abs(bounds.max.y - bounds.min.y);
-    this->model.setTargetHeightScale(*ns3Model.height / height);
+    model.setTargetHeightScale(*ns3Model.height / height);
   }
 
   if (ns3Model.width) {
     const auto width = std::abs(bounds.max.x - bounds.min.x);
-    this->model.setTargetWidthScale(*ns3Model.width / width);
+    model.setTargetWidthScale(*ns3Model.width / width);
   }
 
   if (ns3Model.depth) {
     const auto depth = std::abs(bounds.max.z - bounds.min.z);
-    this->model.setTargetDepthScale(*ns3Model.depth / depth);
+    model.setTargetDepthScale(*ns3Model.depth / depth);
   }
 
-  this->model.setScale(toRenderArray(ns3Model.scale));
+  model.setScale(toRenderArray(ns3Model.scale));
 }
 
-const Model &Decoration::getModel() const {
-  return model;
+Decoration::Decoration(const Model &model, const parser::Decoration &ns3Model) : model(model), ns3Model(ns3Model) {
+  applyModelProperties();
 }
 
-undo::DecorationMoveEvent Decoration::handle(const parser::DecorationMoveEvent &e) {
-  undo::DecorationMoveEvent undo;
-  undo.position = model.getPosition();
-  undo.event = e;
+void Decoration::modelLoaded(const Model::ModelLoadInfo &info) {
+  if (model.getModelId() != info.id)
+    return;
 
-  this->model.setPosition(toRenderCoordinate(e.targetPosition));
+  // Keep the state set by events
+  const auto position = model.getPosition();
+  const auto rotate = model.getRotate();
+
+  // Reconstruct the model in place, as `Node` does
+  model.~Model();
+  new (&model) Model(info);
+  applyModelProperties();
 
-  return undo;
+  model.setPosition(position);
+  model.setRotate(rotate.x, rotate.y, rotate.z);
 }
 
-undo::DecorationOrientationChangeEvent Decoration::handle(const parser::DecorationOrientationChangeEvent &e) {
-  undo::DecorationOrientationChangeEvent undo;
-  undo.orientation = model.getRotate();
-  undo.event = e;
+const Model &Decoration::getModel() const {
+  return model;
+}
+
+void Decoration::handle(const parser::DecorationMoveEvent &e) {
+  this->model.setPosition(toRenderCoordinate(e.targetPosition));
+}
 
+void Decoration::handle(const parser::DecorationOrientationChangeEvent &e) {
   this->model.setRotate(e.targetOrientation[0], e.targetOrientation[2], -e.targetOrientation[1]);
+}
 
-  return undo;
+void Decoration::undoMove(const glm::vec3 &position) {
+  model.setPosition(position);
 }
 
-void Decoration::handle(const undo::DecorationMoveEvent &e) {
-  model.setPosition(e.position);
+void Decoration::undoOrientationChange(const glm::vec3 &orientation) {
+  model.setRotate(orientation[0], orientation[1], orientation[2]);
 }
 
-void Decoration::handle(const undo::DecorationOrientationChangeEvent &e) {
-  model.setRotate(e.orientation[0], e.orientation[2], e.orientation[1]);
+void Decoration::restore(const keyframe::DecorationState &state) {
+  model.setPosition(state.position);
+  model.setRotate(state.orientation[0], state.orientation[1], state.orientation[2]);
 }
 
 } // namespace netsimulyzer
@@ -34,7 +34,7 @@
 #pragma once
 
 #include "../../render/model/Model.h"
-#include "../../util/undo-events.h"
+#include "../../util/keyframe.h"
 #include <model.h>
 
 namespace netsimulyzer {
@@ -43,14 +43,47 @@ class Decoration {
   Model model;
   parser::Decoration ns3Model;
 
+  void applyModelProperties();
+
 public:
   Decoration(const Model &model, const parser::Decoration &ns3Model);
   [[nodiscard]] const Model &getModel() const;
-  undo::DecorationMoveEvent handle(const parser::DecorationMoveEvent &e);
-  undo::DecorationOrientationChangeEvent handle(const parser::DecorationOrientationChangeEvent &e);
+  void handle(const parser::DecorationMoveEvent &e);
+  void handle(const parser::DecorationOrientationChangeEvent &e);
+
+  /**
+   * Undo a `parser::DecorationMoveEvent`
+   *
+   * @param position
+   * The position before the event, in render coordinates
+   */
+  void undoMove(const glm::vec3 &position);
+
+  /**
+   * Undo a `parser::DecorationOrientationChangeEvent`
+   *
+   * @param orientation
+   * The orientation before the event, in the same form as `Model::getRotate()`
+   */
+  void undoOrientationChange(const glm::vec3 &orientation);
+
+  /**
+   * Replace the state of this Decoration with one from a keyframe
+   *
+   * @param state
+   * The state to restore
+   */
+  void restore(const keyframe::DecorationState &state);
 
-  void handle(const undo::DecorationMoveEvent &e);
-  void handle(const undo::DecorationOrientationChangeEvent &e);
+  /**
+   * Rebuild the model of this Decoration with the bounds of its uploaded model,
+   * if it was built while that model was still loading.
+   * The position & orientation are kept
+   *
+   * @param info
+   * The model which finished loading
+   */
+  void modelLoaded(const Model::ModelLoadInfo &info);
 };
 
 } // namespace netsimulyzer
@@ -34,7 +34,6 @@
 #include "LogicalLink.h"
 #include "src/conversion.h"
 #include "src/render/model/Model.h"
-#include "src/util/undo-events.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/norm.hpp>
@@ -137,13 +136,8 @@ void LogicalLink::updateModelMatrix(const glm::vec3 node1Position, const glm::ve
   modelMatrix = glm::scale(modelMatrix, glm::vec3{lengthScale, diameterScale, diameterScale});
 }
 
-undo::LogicalLinkUpdate LogicalLink::handle(const parser::LogicalLinkUpdate &e) {
-  undo::LogicalLinkUpdate undo;
-  undo.event = e;
-  undo.nodes = model.nodes;
-  undo.active = model.active;
-  undo.color = model.color;
-  undo.diameter = model.diameter;
+void LogicalLink::handle(const parser::LogicalLinkUpdate &e) {
+  const auto doUpdate = model.nodes == e.nodes;
 
   model.nodes = e.nodes;
   model.active = e.active;
@@ -157,19 +151,17 @@ undo::LogicalLinkUpdate LogicalLink::handle(const parser::LogicalLinkUpdate &e)
   // if not, then the `update()` call
   // in the `SceneWidget` with the
   // positions will update this
-  if (undo.nodes == model.nodes)
+  if (doUpdate)
     update();
-
-  return undo;
 }
 
-void LogicalLink::handle(const undo::LogicalLinkUpdate &e) {
-  bool doUpdate = model.nodes == e.nodes;
+void LogicalLink::undoUpdate(const parser::LogicalLink &state) {
+  const auto doUpdate = model.nodes == state.nodes;
 
-  model.nodes = e.nodes;
-  model.active = e.active;
-  model.color = e.color;
-  model.diameter = e.diameter;
+  model.nodes = state.nodes;
+  model.active = state.active;
+  model.color = state.color;
+  model.diameter = state.diameter;
 
   color = toRenderColor(model.color);
 
@@ -34,7 +34,6 @@
 #pragma once
 
 #include "src/render/model/Model.h"
-#include "src/util/undo-events.h"
 #include <model.h>
 
 namespace netsimulyzer {
@@ -66,9 +65,16 @@ public:
 
   void updateModelMatrix(glm::vec3 node1Position, glm::vec3 node2Position, float offset);
 
-  undo::LogicalLinkUpdate handle(const parser::LogicalLinkUpdate &e);
+  void handle(const parser::LogicalLinkUpdate &e);
 
-  void handle(const undo::LogicalLinkUpdate &e);
+  /**
+   * Undo a `parser::LogicalLinkUpdate`
+   *
+   * @param state
+   * The link before the event. Only the nodes, activity,
+   * color & diameter are used
+   */
+  void undoUpdate(const parser::LogicalLink &state);
 
   friend Renderer;
 };
@@ -36,7 +36,7 @@
 #include <utility>
 
 WiredLink::WiredLink(const WiredLink::RenderInfo &renderInfo, parser::WiredLink model)
-    : renderInfo(renderInfo), model(std::move(model)) {
+    : renderInfo(renderInfo), model(std::move(model)), positions(this->model.nodes.size()) {
   initializeOpenGLFunctions();
 }
 
@@ -52,6 +52,8 @@ void WiredLink::notifyNodeMoved(unsigned int nodeId, glm::vec3 position) {
       nodeIndex = i;
   }
 
+  positions[nodeIndex] = position;
+
   glBindBuffer(GL_ARRAY_BUFFER, renderInfo.vbo);
   glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * 3 * nodeIndex, sizeof(float) * 3,
                   reinterpret_cast<void *>(glm::value_ptr(position)));
@@ -60,6 +62,7 @@ void WiredLink::notifyNodeMoved(unsigned int nodeId, glm::vec3 position) {
 WiredLink::WiredLink(WiredLink &&other) noexcept {
   renderInfo = other.renderInfo;
   model = other.model;
+  positions = std::move(other.positions);
 
   // Clear the other RenderInfo so the destructor
   // doesn't delete the OpenGL buffers
@@ -73,6 +76,7 @@ WiredLink::WiredLink(WiredLink &&other) noexcept {
 WiredLink &WiredLink::operator=(WiredLink &&other) noexcept {
   renderInfo = other.renderInfo;
   model = other.model;
+  positions = std::move(other.positions);
 
   // Clear the other RenderInfo so the destructor
   // doesn't delete the OpenGL buffers
@@ -87,3 +91,7 @@ WiredLink &WiredLink::operator=(WiredLink &&other) noexcept {
 const WiredLink::RenderInfo &WiredLink::getRenderInfo() const {
   return renderInfo;
 }
+
+const std::vector<glm::vec3> &WiredLink::getPositions() const {
+  return positions;
+}
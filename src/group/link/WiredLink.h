@@ -36,6 +36,7 @@
 #include <QOpenGLFunctions_3_3_Core>
 #include <glm/vec3.hpp>
 #include <model.h>
+#include <vector>
 
 class WiredLink : protected QOpenGLFunctions_3_3_Core {
 public:
@@ -49,6 +50,11 @@ private:
   RenderInfo renderInfo;
   parser::WiredLink model;
 
+  /**
+   * The last position of each node in `model`, in render coordinates
+   */
+  std::vector<glm::vec3> positions;
+
 public:
   WiredLink(const RenderInfo &renderInfo, parser::WiredLink model);
   ~WiredLink() override;
@@ -58,4 +64,5 @@ public:
 
   void notifyNodeMoved(unsigned int nodeId, glm::vec3 position);
   [[nodiscard]] const RenderInfo &getRenderInfo() const;
+  [[nodiscard]] const std::vector<glm::vec3> &getPositions() const;
 };
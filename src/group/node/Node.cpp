@@ -33,7 +33,6 @@
 
 #include "Node.h"
 #include "../../conversion.h"
-#include "../../util/undo-events.h"
 #include <algorithm>
 #include <cmath>
 #include <glm/glm.hpp>
@@ -132,12 +131,7 @@ const std::vector<LogicalLink *> &Node::getActiveLogicalLinks() const {
   return activeLogicalLinks;
 }
 
-undo::MoveEvent Node::handle(const parser::MoveEvent &e) {
-  undo::MoveEvent undo;
-  undo.position = model.getPosition();
-  undo.ns3Position = ns3Node.position;
-  undo.event = e;
-
+void Node::handle(const parser::MoveEvent &e) {
   if (trailBuffer.empty()) {
     const auto currentPosition = model.getPosition();
     trailBuffer.append(currentPosition.x, currentPosition.y, currentPosition.z);
@@ -151,65 +145,42 @@ undo::MoveEvent Node::handle(const parser::MoveEvent &e) {
   for (auto link : wiredLinks) {
     link->notifyNodeMoved(ns3Node.id, getCenter());
   }
-
-  return undo;
 }
 
-undo::NodeModelChangeEvent Node::handle(const parser::NodeModelChangeEvent &e, ModelCache &modelCache) {
-  undo::NodeModelChangeEvent undo;
-  undo.model = ns3Node.model;
-  undo.event = e;
-
+void Node::handle(const SceneEventStore::NodeModelChange &e, ModelCache &modelCache) {
   ns3Node.model = e.model;
 
   // Deconstruct & Reconstruct the model in place
   // either the coolest trick ever, or the worst hack
   model.~Model();
-  new (&model) Model(modelCache.load(e.model));
+  new (&model) Model(modelCache.request(e.model));
 
   // re-apply model properties
   applyModelProperties();
-
-  return undo;
 }
 
-undo::NodeOrientationChangeEvent Node::handle(const parser::NodeOrientationChangeEvent &e) {
-  undo::NodeOrientationChangeEvent undo;
-  undo.orientation = model.getRotate();
-  undo.event = e;
-
+void Node::handle(const parser::NodeOrientationChangeEvent &e) {
   this->model.setRotate(e.targetOrientation[0], e.targetOrientation[2], -e.targetOrientation[1]);
-
-  return undo;
 }
 
-undo::NodeColorChangeEvent Node::handle(const parser::NodeColorChangeEvent &e) {
-  undo::NodeColorChangeEvent undo;
-  undo.event = e;
-
+void Node::handle(const parser::NodeColorChangeEvent &e) {
   if (e.type == parser::NodeColorChangeEvent::ColorType::Base) {
-    undo.originalColor = model.getBaseColor();
-
     if (!e.targetColor.has_value())
       model.unsetBaseColor();
     else
       model.setBaseColor(toRenderColor(e.targetColor.value()));
 
   } else { // Highlight
-    undo.originalColor = model.getHighlightColor();
-
     if (!e.targetColor.has_value())
       model.unsetHighlightColor();
     else
       model.setHighlightColor(toRenderColor(e.targetColor.value()));
   }
-
-  return undo;
 }
 
-void Node::handle(const undo::MoveEvent &e) {
-  model.setPosition(e.position);
-  ns3Node.position = e.ns3Position;
+void Node::undoMove(const parser::Ns3Coordinate &position) {
+  ns3Node.position = position;
+  model.setPosition(toRenderCoordinate(position) + offset);
 
   trailBuffer.pop();
 
@@ -218,53 +189,78 @@ void Node::handle(const undo::MoveEvent &e) {
   }
 }
 
-void Node::handle(const undo::NodeModelChangeEvent &e, ModelCache &modelCache) {
+void Node::undoModelChange(std::string_view modelPath, ModelCache &modelCache) {
   // Deconstruct & Reconstruct the model in place
   // either the coolest trick ever, or the worst hack
   model.~Model();
-  new (&model) Model(modelCache.load(e.model));
+  new (&model) Model(modelCache.request(modelPath));
 
-  ns3Node.model = e.model;
+  ns3Node.model = modelPath;
 
   // re-apply model properties
   applyModelProperties();
 }
 
-undo::TransmitEvent Node::handle(const parser::TransmitEvent &e) {
+void Node::modelLoaded(const Model::ModelLoadInfo &info) {
+  if (model.getModelId() != info.id)
+    return;
+
+  // Keep the state set by events,
+  // since `applyModelProperties()` sets the initial state
+  const auto position = model.getPosition();
+  const auto rotate = model.getRotate();
+  const auto baseColor = model.getBaseColor();
+  const auto highlightColor = model.getHighlightColor();
+
+  // Same trick as the model change event
+  model.~Model();
+  new (&model) Model(info);
+  applyModelProperties();
+
+  model.setPosition(position);
+  model.setRotate(rotate.x, rotate.y, rotate.z);
+
+  if (baseColor)
+    model.setBaseColor(*baseColor);
+  else
+    model.unsetBaseColor();
+
+  if (highlightColor)
+    model.setHighlightColor(*highlightColor);
+  else
+    model.unsetHighlightColor();
+
+  // The center moves with the bounds
+  for (auto link : wiredLinks) {
+    link->notifyNodeMoved(ns3Node.id, getCenter());
+  }
+}
+
+void Node::handle(const parser::TransmitEvent &e) {
   transmitInfo.isTransmitting = true;
   transmitInfo.startTime = e.time;
   transmitInfo.targetSize = e.targetSize;
   transmitInfo.duration = e.duration;
   transmitInfo.color = toRenderColor(e.color);
-
-  undo::TransmitEvent undo;
-  undo.stopTime = transmitInfo.startTime + transmitInfo.duration;
-  undo.event = e;
-  return undo;
 }
 
-undo::TransmitEndEvent Node::handle(const parser::TransmitEndEvent &e) {
+void Node::handle(const parser::TransmitEndEvent &) {
   transmitInfo.isTransmitting = false;
-
-  undo::TransmitEndEvent undo;
-  undo.event = e;
-
-  return undo;
 }
 
-void Node::handle(const undo::NodeOrientationChangeEvent &e) {
-  model.setRotate(e.orientation[0], e.orientation[2], e.orientation[1]);
+void Node::undoOrientationChange(const glm::vec3 &orientation) {
+  model.setRotate(orientation[0], orientation[1], orientation[2]);
 }
 
-void Node::handle(const undo::NodeColorChangeEvent &e) {
-  if (e.event.type == parser::NodeColorChangeEvent::ColorType::Base) {
-    if (e.originalColor.has_value())
-      model.setBaseColor(e.originalColor.value());
+void Node::undoColorChange(parser::NodeColorChangeEvent::ColorType type, const std::optional<glm::vec3> &color) {
+  if (type == parser::NodeColorChangeEvent::ColorType::Base) {
+    if (color.has_value())
+      model.setBaseColor(color.value());
     else
       model.unsetBaseColor();
   } else { // Highlight
-    if (e.originalColor.has_value())
-      model.setHighlightColor(e.originalColor.value());
+    if (color.has_value())
+      model.setHighlightColor(color.value());
     else
       model.unsetHighlightColor();
   }
@@ -281,15 +277,51 @@ const FontManager::FontBannerRenderInfo &Node::getBannerRenderInfo() const {
   return bannerRenderInfo;
 }
 
-void Node::handle(const undo::TransmitEvent &e) {
-  transmitInfo.startTime = e.event.time;
-  transmitInfo.duration = e.event.duration;
+void Node::undoTransmit(const parser::TransmitEvent &e) {
+  transmitInfo.startTime = e.time;
+  transmitInfo.duration = e.duration;
 }
 
-void Node::handle(const undo::TransmitEndEvent &e) {
-  const auto &startEvent = e.event.startEvent;
+void Node::undoTransmitEnd(const parser::TransmitEndEvent &e) {
+  const auto &startEvent = e.startEvent;
   transmitInfo.startTime = startEvent.time;
   transmitInfo.duration = startEvent.duration;
 }
 
+void Node::restore(const keyframe::NodeState &state, const std::string &modelPath, ModelCache &modelCache) {
+  if (ns3Node.model != modelPath) {
+    ns3Node.model = modelPath;
+
+    // Same trick as the model change event
+    model.~Model();
+    new (&model) Model(modelCache.request(modelPath));
+    applyModelProperties();
+  }
+
+  ns3Node.position = state.position;
+  model.setPosition(toRenderCoordinate(state.position) + offset);
+  model.setRotate(state.orientation[0], state.orientation[1], state.orientation[2]);
+
+  if (state.baseColor)
+    model.setBaseColor(state.baseColor.value());
+  else
+    model.unsetBaseColor();
+
+  if (state.highlightColor)
+    model.setHighlightColor(state.highlightColor.value());
+  else
+    model.unsetHighlightColor();
+
+  if (state.transmit)
+    handle(state.transmit.value());
+  else
+    transmitInfo.isTransmitting = false;
+
+  trailBuffer.clear();
+
+  for (auto link : wiredLinks) {
+    link->notifyNodeMoved(ns3Node.id, getCenter());
+  }
+}
+
 } // namespace netsimulyzer
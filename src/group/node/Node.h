@@ -34,7 +34,8 @@
 #pragma once
 
 #include "../../render/model/Model.h"
-#include "../../util/undo-events.h"
+#include "../../util/keyframe.h"
+#include "../../util/scene-event-store.h"
 #include "src/group/link/LogicalLink.h"
 #include "src/group/link/WiredLink.h"
 #include "src/group/node/TrailBuffer.h"
@@ -44,6 +45,7 @@
 #include <glm/glm.hpp>
 #include <model.h>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 namespace netsimulyzer {
@@ -88,19 +90,78 @@ public:
   void updateLogicalLink(LogicalLink *link);
   [[nodiscard]] const std::vector<LogicalLink *>& getActiveLogicalLinks() const;
 
-  undo::MoveEvent handle(const parser::MoveEvent &e);
-  undo::NodeModelChangeEvent handle(const parser::NodeModelChangeEvent &e, ModelCache &modelCache);
-  undo::TransmitEvent handle(const parser::TransmitEvent &e);
-  undo::TransmitEndEvent handle(const parser::TransmitEndEvent &e);
-  undo::NodeOrientationChangeEvent handle(const parser::NodeOrientationChangeEvent &e);
-  undo::NodeColorChangeEvent handle(const parser::NodeColorChangeEvent &e);
-
-  void handle(const undo::MoveEvent &e);
-  void handle(const undo::NodeModelChangeEvent &e, ModelCache &modelCache);
-  void handle(const undo::TransmitEvent &e);
-  void handle(const undo::TransmitEndEvent &e);
-  void handle(const undo::NodeOrientationChangeEvent &e);
-  void handle(const undo::NodeColorChangeEvent &e);
+  void handle(const parser::MoveEvent &e);
+  void handle(const SceneEventStore::NodeModelChange &e, ModelCache &modelCache);
+  void handle(const parser::TransmitEvent &e);
+  void handle(const parser::TransmitEndEvent &e);
+  void handle(const parser::NodeOrientationChangeEvent &e);
+  void handle(const parser::NodeColorChangeEvent &e);
+
+  /**
+   * Undo a `parser::MoveEvent`, and the trail point it added
+   *
+   * @param position
+   * The position of the Node before the event, in ns-3 coordinates
+   */
+  void undoMove(const parser::Ns3Coordinate &position);
+
+  /**
+   * Undo a `parser::NodeModelChangeEvent`
+   *
+   * @param modelPath
+   * The model used before the event
+   *
+   * @param modelCache
+   * The cache to load the model from
+   */
+  void undoModelChange(std::string_view modelPath, ModelCache &modelCache);
+
+  /**
+   * Undo a `parser::NodeOrientationChangeEvent`
+   *
+   * @param orientation
+   * The orientation before the event, in the same form as `Model::getRotate()`
+   */
+  void undoOrientationChange(const glm::vec3 &orientation);
+
+  /**
+   * Undo a `parser::NodeColorChangeEvent`
+   *
+   * @param type
+   * The color the event changed
+   *
+   * @param color
+   * The color before the event. Unset if there was none
+   */
+  void undoColorChange(parser::NodeColorChangeEvent::ColorType type, const std::optional<glm::vec3> &color);
+
+  void undoTransmit(const parser::TransmitEvent &e);
+  void undoTransmitEnd(const parser::TransmitEndEvent &e);
+
+  /**
+   * Replace the state of this Node with one from a keyframe.
+   * The motion trail is cleared, since it is not part of the keyframe
+   *
+   * @param state
+   * The state to restore
+   *
+   * @param modelPath
+   * The model referenced by `state`
+   *
+   * @param modelCache
+   * The cache to load the model from, should it differ from the current one
+   */
+  void restore(const keyframe::NodeState &state, const std::string &modelPath, ModelCache &modelCache);
+
+  /**
+   * Rebuild the model of this Node with the bounds of its uploaded model,
+   * if it was built while that model was still loading.
+   * The position, orientation & colors are kept
+   *
+   * @param info
+   * The model which finished loading
+   */
+  void modelLoaded(const Model::ModelLoadInfo &info);
 };
 
 } // namespace netsimulyzer
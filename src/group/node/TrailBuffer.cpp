@@ -33,18 +33,20 @@
 
 #include "TrailBuffer.h"
 #include <algorithm>
+#include <array>
 #include <utility>
 
 namespace netsimulyzer {
 
 TrailBuffer::TrailBuffer(QOpenGLFunctions_3_3_Core *openGl, unsigned int vao, unsigned int vbo, int initialSize,
                          int vertexSize) noexcept
-    : openGl{openGl}, vao{vao}, vbo{vbo}, bufferSize{initialSize}, vertexSize{vertexSize}, buffer(bufferSize) {
+    : openGl{openGl}, vao{vao}, vbo{vbo}, bufferSize{initialSize}, vertexSize{vertexSize}, buffer(bufferSize + 1) {
 }
 
 TrailBuffer::TrailBuffer(TrailBuffer &&other) noexcept
     : openGl{other.openGl}, vao{other.vao}, vbo{other.vbo}, bufferSize{other.bufferSize},
-      vertexSize{other.vertexSize}, index{other.index}, _empty{other._empty}, buffer{std::move(other.buffer)} {
+      vertexSize{other.vertexSize}, start{other.start}, count{other.count}, pending{other.pending},
+      buffer{std::move(other.buffer)} {
   // Clear these, so the `other` deconstructor doesn't delete our moved buffers
   other.vao = 0u;
   other.vbo = 0u;
@@ -55,56 +57,92 @@ TrailBuffer::~TrailBuffer() {
   openGl->glDeleteVertexArrays(1, &vao);
 }
 
+void TrailBuffer::upload() const {
+  if (pending == 0)
+    return;
+
+  openGl->glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+  const auto first = (start + count - pending) % bufferSize;
+  const auto last = first + pending;
+  pending = 0;
+
+  if (last <= bufferSize) {
+    upload(first, last);
+
+    // Keep the copy of the first point in sync
+    if (first == 0)
+      upload(bufferSize, bufferSize + 1);
+    return;
+  }
+
+  // The new points wrap around the end of the ring,
+  // so the copy of the first point is included here
+  upload(first, bufferSize + 1);
+  upload(0, last - bufferSize);
+}
+
+void TrailBuffer::upload(int first, int last) const {
+  openGl->glBufferSubData(GL_ARRAY_BUFFER, vertexSize * first, vertexSize * (last - first), buffer.data() + first);
+}
+
 void TrailBuffer::bind() const {
   openGl->glBindVertexArray(vao);
   openGl->glBindBuffer(GL_ARRAY_BUFFER, vbo);
 }
 
 void TrailBuffer::render() const {
-  if (empty())
+  // A single point has no line to draw
+  if (count < 2)
     return;
 
   bind();
-  openGl->glDrawArrays(GL_LINE_STRIP, 0, index);
-}
+  upload();
 
-void TrailBuffer::append(float x, float y, float z) {
-  if (index == bufferSize - 1) {
-    std::rotate(buffer.begin(), buffer.begin() + 1, buffer.end());
-
-    buffer[index].x = x;
-    buffer[index].y = y;
-    buffer[index].z = z;
-
-  } else {
-    if (_empty)
-      _empty = false;
-    else
-      index++;
-
-    buffer[index].x = x;
-    buffer[index].y = y;
-    buffer[index].z = z;
+  if (start + count <= bufferSize) {
+    openGl->glDrawArrays(GL_LINE_STRIP, start, count);
+    return;
   }
 
-  openGl->glBindVertexArray(vao);
-  openGl->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  openGl->glBufferSubData(GL_ARRAY_BUFFER, 0, vertexSize * (index + 1), buffer.data());
+  // Draw from the oldest point to the end of the ring,
+  // including the copy of the first point, then the rest from the front
+  const std::array<int, 2> firsts{start, 0};
+  const std::array<int, 2> counts{bufferSize - start + 1, start + count - bufferSize};
+  openGl->glMultiDrawArrays(GL_LINE_STRIP, firsts.data(), counts.data(), 2);
+}
+
+void TrailBuffer::append(float x, float y, float z) {
+  const auto position = (start + count) % bufferSize;
+  buffer[position] = {x, y, z};
+  if (position == 0)
+    buffer[bufferSize] = buffer[position];
+
+  // Full, overwrite the oldest point
+  if (count == bufferSize)
+    start = (start + 1) % bufferSize;
+  else
+    count++;
+
+  pending = std::min(pending + 1, count);
 }
 
 void TrailBuffer::pop() {
-  if (_empty)
+  if (count == 0)
     return;
 
-  index--;
-  if (index == -1) {
-    _empty = true;
-    index = 0;
-  }
+  count--;
+  if (pending > 0)
+    pending--;
+}
+
+void TrailBuffer::clear() {
+  start = 0;
+  count = 0;
+  pending = 0;
 }
 
 bool TrailBuffer::empty() const noexcept {
-  return _empty;
+  return count == 0;
 }
 
 } // namespace netsimulyzer
@@ -43,7 +43,11 @@ namespace netsimulyzer {
  * Class that stores the list of locations
  * a Node has visited. Once full, the oldest
  * points 'fall off' the front,
- * first in first out style
+ * first in first out style.
+ *
+ * Points are kept in a ring, so appending only
+ * writes the new point. Points appended since the last
+ * render are uploaded together, when the trail is next rendered
  */
 class TrailBuffer {
   // Make sure there is no padding is in this struct
@@ -60,8 +64,11 @@ class TrailBuffer {
   unsigned int vbo{0u};
 
   /**
-   * Total size of the internal buffer
-   * in elements
+   * The maximum number of points in the trail.
+   *
+   * The buffers hold one more vertex than this,
+   * a copy of the first, so a trail that wraps
+   * around the end of the ring stays connected
    */
   int bufferSize{0};
 
@@ -71,29 +78,76 @@ class TrailBuffer {
   const int vertexSize;
 
   /**
-   * The current position in the buffer
+   * The position of the oldest point in the ring
+   */
+  int start{0};
+
+  /**
+   * The number of points in the ring
    */
-  int index{0};
+  int count{0};
 
   /**
-   * FLag indicating that no points are in the buffer
+   * The number of the newest points
+   * which have not been uploaded yet
    */
-  bool _empty{true};
+  mutable int pending{0};
 
   /**
    * Application side buffer containing the appended points
    */
   std::vector<TrailVertex> buffer;
 
+  /**
+   * Upload the points appended since the last upload
+   */
+  void upload() const;
+
+  /**
+   * Upload the vertices in [first, last)
+   */
+  void upload(int first, int last) const;
+
 public:
+  /**
+   * @param openGl
+   * The functions to call for the `vao` & `vbo`
+   *
+   * @param vao
+   * The vertex array, with the layout of `vbo` bound
+   *
+   * @param vbo
+   * The vertex buffer. Must hold at least `initialSize + 1` vertices
+   *
+   * @param initialSize
+   * The maximum number of points in the trail
+   *
+   * @param vertexSize
+   * The size of a single vertex, in bytes
+   */
   explicit TrailBuffer(QOpenGLFunctions_3_3_Core *openGl, unsigned int vao, unsigned int vbo, int initialSize,
                        int vertexSize) noexcept;
   TrailBuffer(TrailBuffer &&other) noexcept;
   ~TrailBuffer();
   void bind() const;
+
+  /**
+   * Draw the trail as a line strip,
+   * uploading any newly appended points first
+   */
   void render() const;
   void append(float x, float y, float z);
+
+  /**
+   * Remove the newest point from the buffer.
+   * Points that have already fallen off the front are not restored
+   */
   void pop();
+
+  /**
+   * Remove all points from the buffer
+   */
+  void clear();
   [[nodiscard]] bool empty() const noexcept;
 };
 } // namespace netsimulyzer
@@ -130,6 +130,11 @@ void ArcCamera::move(const float deltaTime) {
   }
 }
 
+bool ArcCamera::isMoving() const {
+  return forwardPressed || backwardPressed || leftPressed || rightPressed || turnLeftPressed || turnRightPressed ||
+         upPressed || downPressed || zoomIn || zoomOut;
+}
+
 void ArcCamera::reset() {
   target = glm::vec3{0.0f};
   distance = defaultDistance;
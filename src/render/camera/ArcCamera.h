@@ -86,6 +86,13 @@ public:
   void handleKeyPress(int key);
   void handleKeyRelease(int key);
   void move(float deltaTime);
+
+  /**
+   * @return
+   * True if a movement or zoom key is held,
+   * so `move()` will change the view
+   */
+  [[nodiscard]] bool isMoving() const;
   void reset();
   void wheel(int delta);
   void zoom(float delta);
@@ -173,6 +173,12 @@ void Camera::move(const float delta_time) {
   update();
 }
 
+bool Camera::isMoving() const {
+  return active.front_back != active_directions::direction::none ||
+         active.left_right != active_directions::side::none ||
+         active.upDown != active_directions::verticalDirection::none || active.turn != active_directions::side::none;
+}
+
 void Camera::mouse_move(float delta_x, float delta_y) {
   if (mobility == move_state::frozen)
     return;
@@ -132,6 +132,13 @@ public:
   void setMobility(move_state state);
 
   void move(float delta_time);
+
+  /**
+   * @return
+   * True if a movement key is held,
+   * so `move()` will change the view
+   */
+  [[nodiscard]] bool isMoving() const;
   void mouse_move(float delta_x, float delta_y);
 
   [[nodiscard]] float getMoveSpeedSizeScale() const;
@@ -0,0 +1,163 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace netsimulyzer {
+
+/**
+ * Axis aligned bounding box, in render coordinates
+ */
+struct Aabb {
+  glm::vec3 min{0.0f};
+  glm::vec3 max{0.0f};
+
+  /**
+   * @return
+   * The smallest box containing both `a` & `b`
+   */
+  [[nodiscard]] static Aabb merge(const Aabb &a, const Aabb &b) {
+    return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+  }
+
+  /**
+   * @return
+   * The smallest box containing the points `a` & `b`
+   */
+  [[nodiscard]] static Aabb fromPoints(const glm::vec3 &a, const glm::vec3 &b) {
+    return {glm::min(a, b), glm::max(a, b)};
+  }
+
+  /**
+   * @return
+   * True if `other` is entirely inside this box
+   */
+  [[nodiscard]] bool contains(const Aabb &other) const {
+    return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+  }
+
+  /**
+   * @return
+   * The area of the faces of the box.
+   * Used as the cost of testing against it
+   */
+  [[nodiscard]] float surfaceArea() const {
+    const auto size = max - min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+  }
+
+  /**
+   * @param margin
+   * The distance to move each face out by
+   *
+   * @return
+   * This box, grown by `margin` on every side
+   */
+  [[nodiscard]] Aabb expanded(float margin) const {
+    return {min - glm::vec3{margin}, max + glm::vec3{margin}};
+  }
+
+  /**
+   * Find the box containing this one after it is transformed by `matrix`.
+   * Cheaper than transforming each corner
+   *
+   * @param matrix
+   * The affine transform to apply, e.g. a model matrix
+   *
+   * @return
+   * The smallest axis aligned box containing the transformed box
+   */
+  [[nodiscard]] Aabb transformed(const glm::mat4 &matrix) const {
+    const auto translation = glm::vec3{matrix[3]};
+    Aabb result{translation, translation};
+
+    // Each axis of the result is the translation,
+    // plus the smallest/largest contribution of each input axis
+    for (auto column = 0; column < 3; column++) {
+      for (auto row = 0; row < 3; row++) {
+        const auto a = matrix[column][row] * min[column];
+        const auto b = matrix[column][row] * max[column];
+        result.min[row] += std::min(a, b);
+        result.max[row] += std::max(a, b);
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * Test a ray against this box
+   *
+   * @param origin
+   * The start of the ray
+   *
+   * @param direction
+   * The direction of the ray. Need not be normalized
+   *
+   * @return
+   * The distance along `direction` to the first intersection,
+   * in multiples of its length. Unset if the ray misses the box
+   */
+  [[nodiscard]] std::optional<float> intersect(const glm::vec3 &origin, const glm::vec3 &direction) const {
+    auto tNear = 0.0f;
+    auto tFar = std::numeric_limits<float>::infinity();
+
+    for (auto i = 0; i < 3; i++) {
+      if (direction[i] == 0.0f) {
+        if (origin[i] < min[i] || origin[i] > max[i])
+          return {};
+        continue;
+      }
+
+      auto t1 = (min[i] - origin[i]) / direction[i];
+      auto t2 = (max[i] - origin[i]) / direction[i];
+      if (t1 > t2)
+        std::swap(t1, t2);
+
+      tNear = std::max(tNear, t1);
+      tFar = std::min(tFar, t2);
+      if (tNear > tFar)
+        return {};
+    }
+
+    return tNear;
+  }
+};
+
+} // namespace netsimulyzer
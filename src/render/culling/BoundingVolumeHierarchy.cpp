@@ -0,0 +1,293 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "BoundingVolumeHierarchy.h"
+#include <algorithm>
+
+namespace netsimulyzer {
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::allocateNode() {
+  if (freeList == nullProxy) {
+    treeNodes.emplace_back();
+    return static_cast<ProxyId>(treeNodes.size() - 1u);
+  }
+
+  const auto index = freeList;
+  freeList = treeNodes[index].parent;
+  treeNodes[index] = TreeNode{};
+  return index;
+}
+
+void BoundingVolumeHierarchy::freeNode(ProxyId index) {
+  treeNodes[index].parent = freeList;
+  treeNodes[index].height = -1;
+  freeList = index;
+}
+
+void BoundingVolumeHierarchy::insertLeaf(ProxyId leaf) {
+  if (root == nullProxy) {
+    root = leaf;
+    treeNodes[leaf].parent = nullProxy;
+    return;
+  }
+
+  // Find the best sibling for the leaf, by the increase
+  // in the surface area of the tree from adding it there
+  const auto leafBounds = treeNodes[leaf].bounds;
+  auto index = root;
+  while (!treeNodes[index].isLeaf()) {
+    const auto &node = treeNodes[index];
+    const auto area = node.bounds.surfaceArea();
+    const auto combinedArea = Aabb::merge(node.bounds, leafBounds).surfaceArea();
+
+    // Cost of making a new parent for this node & the leaf
+    const auto cost = 2.0f * combinedArea;
+
+    // Minimum cost of pushing the leaf further down
+    const auto inheritanceCost = 2.0f * (combinedArea - area);
+
+    const auto descendCost = [this, &leafBounds, inheritanceCost](ProxyId child) {
+      const auto &childNode = treeNodes[child];
+      const auto merged = Aabb::merge(leafBounds, childNode.bounds).surfaceArea();
+      if (childNode.isLeaf())
+        return merged + inheritanceCost;
+      return merged - childNode.bounds.surfaceArea() + inheritanceCost;
+    };
+
+    const auto leftCost = descendCost(node.left);
+    const auto rightCost = descendCost(node.right);
+
+    if (cost < leftCost && cost < rightCost)
+      break;
+
+    index = leftCost < rightCost ? node.left : node.right;
+  }
+
+  const auto sibling = index;
+  const auto oldParent = treeNodes[sibling].parent;
+  const auto newParent = allocateNode();
+
+  treeNodes[newParent].parent = oldParent;
+  treeNodes[newParent].bounds = Aabb::merge(leafBounds, treeNodes[sibling].bounds);
+  treeNodes[newParent].height = treeNodes[sibling].height + 1;
+  treeNodes[newParent].left = sibling;
+  treeNodes[newParent].right = leaf;
+  treeNodes[sibling].parent = newParent;
+  treeNodes[leaf].parent = newParent;
+
+  if (oldParent == nullProxy)
+    root = newParent;
+  else if (treeNodes[oldParent].left == sibling)
+    treeNodes[oldParent].left = newParent;
+  else
+    treeNodes[oldParent].right = newParent;
+
+  refit(oldParent);
+}
+
+void BoundingVolumeHierarchy::removeLeaf(ProxyId leaf) {
+  if (leaf == root) {
+    root = nullProxy;
+    return;
+  }
+
+  const auto parent = treeNodes[leaf].parent;
+  const auto grandParent = treeNodes[parent].parent;
+  const auto sibling = treeNodes[parent].left == leaf ? treeNodes[parent].right : treeNodes[parent].left;
+
+  // Replace the parent with the sibling
+  treeNodes[sibling].parent = grandParent;
+  freeNode(parent);
+
+  if (grandParent == nullProxy) {
+    root = sibling;
+    return;
+  }
+
+  if (treeNodes[grandParent].left == parent)
+    treeNodes[grandParent].left = sibling;
+  else
+    treeNodes[grandParent].right = sibling;
+
+  refit(grandParent);
+}
+
+void BoundingVolumeHierarchy::refit(ProxyId index) {
+  while (index != nullProxy) {
+    index = balance(index);
+
+    auto &node = treeNodes[index];
+    const auto &left = treeNodes[node.left];
+    const auto &right = treeNodes[node.right];
+    node.height = 1 + std::max(left.height, right.height);
+    node.bounds = Aabb::merge(left.bounds, right.bounds);
+
+    index = node.parent;
+  }
+}
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::balance(ProxyId index) {
+  auto &a = treeNodes[index];
+  if (a.isLeaf() || a.height < 2)
+    return index;
+
+  const auto indexB = a.left;
+  const auto indexC = a.right;
+  auto &b = treeNodes[indexB];
+  auto &c = treeNodes[indexC];
+
+  // Replaces `a` with `child` in `a`'s parent
+  const auto replaceInParent = [this, index, &a](ProxyId child) {
+    treeNodes[child].parent = a.parent;
+    a.parent = child;
+
+    if (treeNodes[child].parent == nullProxy)
+      root = child;
+    else if (treeNodes[treeNodes[child].parent].left == index)
+      treeNodes[treeNodes[child].parent].left = child;
+    else
+      treeNodes[treeNodes[child].parent].right = child;
+  };
+
+  const auto balance = c.height - b.height;
+
+  // Rotate `c` up
+  if (balance > 1) {
+    const auto indexF = c.left;
+    const auto indexG = c.right;
+    auto &f = treeNodes[indexF];
+    auto &g = treeNodes[indexG];
+
+    c.left = index;
+    replaceInParent(indexC);
+
+    // Keep the taller grandchild under `c`
+    if (f.height > g.height) {
+      c.right = indexF;
+      a.right = indexG;
+      g.parent = index;
+      a.bounds = Aabb::merge(b.bounds, g.bounds);
+      c.bounds = Aabb::merge(a.bounds, f.bounds);
+      a.height = 1 + std::max(b.height, g.height);
+      c.height = 1 + std::max(a.height, f.height);
+    } else {
+      c.right = indexG;
+      a.right = indexF;
+      f.parent = index;
+      a.bounds = Aabb::merge(b.bounds, f.bounds);
+      c.bounds = Aabb::merge(a.bounds, g.bounds);
+      a.height = 1 + std::max(b.height, f.height);
+      c.height = 1 + std::max(a.height, g.height);
+    }
+
+    return indexC;
+  }
+
+  // Rotate `b` up
+  if (balance < -1) {
+    const auto indexD = b.left;
+    const auto indexE = b.right;
+    auto &d = treeNodes[indexD];
+    auto &e = treeNodes[indexE];
+
+    b.left = index;
+    replaceInParent(indexB);
+
+    if (d.height > e.height) {
+      b.right = indexD;
+      a.left = indexE;
+      e.parent = index;
+      a.bounds = Aabb::merge(c.bounds, e.bounds);
+      b.bounds = Aabb::merge(a.bounds, d.bounds);
+      a.height = 1 + std::max(c.height, e.height);
+      b.height = 1 + std::max(a.height, d.height);
+    } else {
+      b.right = indexE;
+      a.left = indexD;
+      d.parent = index;
+      a.bounds = Aabb::merge(c.bounds, d.bounds);
+      b.bounds = Aabb::merge(a.bounds, e.bounds);
+      a.height = 1 + std::max(c.height, d.height);
+      b.height = 1 + std::max(a.height, e.height);
+    }
+
+    return indexB;
+  }
+
+  return index;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(float margin) : margin(margin) {
+}
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::insert(const Aabb &bounds, unsigned int item) {
+  const auto proxy = allocateNode();
+  treeNodes[proxy].bounds = bounds.expanded(margin);
+  treeNodes[proxy].item = item;
+  insertLeaf(proxy);
+  itemCount++;
+
+  return proxy;
+}
+
+void BoundingVolumeHierarchy::remove(ProxyId proxy) {
+  removeLeaf(proxy);
+  freeNode(proxy);
+  itemCount--;
+}
+
+bool BoundingVolumeHierarchy::move(ProxyId proxy, const Aabb &bounds) {
+  const auto &current = treeNodes[proxy].bounds;
+
+  // Still inside the grown box, and not so small the box is mostly empty
+  if (current.contains(bounds) && bounds.expanded(margin * 4.0f).contains(current))
+    return false;
+
+  removeLeaf(proxy);
+  treeNodes[proxy].bounds = bounds.expanded(margin);
+  insertLeaf(proxy);
+  return true;
+}
+
+void BoundingVolumeHierarchy::clear() {
+  treeNodes.clear();
+  root = nullProxy;
+  freeList = nullProxy;
+  itemCount = 0u;
+}
+
+std::size_t BoundingVolumeHierarchy::size() const {
+  return itemCount;
+}
+
+} // namespace netsimulyzer
@@ -0,0 +1,300 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+
+#include "Aabb.h"
+#include "Frustum.h"
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Dynamic tree of bounding boxes, for finding the items
+ * in a region without testing each of them.
+ *
+ * Each item is stored with a box grown by the margin,
+ * so items which move a little do not need to be reinserted.
+ * The tree is kept balanced as items are inserted & removed
+ */
+class BoundingVolumeHierarchy {
+public:
+  /**
+   * Handle to an item in the tree
+   */
+  using ProxyId = int;
+  static constexpr ProxyId nullProxy = -1;
+
+  /**
+   * Counts from queries, for debugging
+   */
+  struct QueryStats {
+    /**
+     * Boxes in the tree tested
+     */
+    unsigned int visited{0u};
+
+    /**
+     * Items found by the query
+     */
+    unsigned int accepted{0u};
+  };
+
+private:
+  struct TreeNode {
+    /**
+     * The box containing the children,
+     * or the grown box of the item for leaves
+     */
+    Aabb bounds;
+
+    /**
+     * The item, for leaves
+     */
+    unsigned int item{0u};
+
+    /**
+     * The parent of this node,
+     * or the next free node when this one is free
+     */
+    ProxyId parent{nullProxy};
+
+    ProxyId left{nullProxy};
+    ProxyId right{nullProxy};
+
+    /**
+     * 0 for leaves, -1 for free nodes
+     */
+    int height{0};
+
+    [[nodiscard]] bool isLeaf() const {
+      return left == nullProxy;
+    }
+  };
+
+  /**
+   * Entry in the stack of a query
+   */
+  struct QueryEntry {
+    ProxyId index;
+
+    /**
+     * Set if the parent was entirely inside the frustum,
+     * so this node need not be tested
+     */
+    bool inside;
+  };
+
+  std::vector<TreeNode> treeNodes;
+  ProxyId root{nullProxy};
+  ProxyId freeList{nullProxy};
+  float margin;
+  std::size_t itemCount{0u};
+
+  /**
+   * Nodes left to visit in a query.
+   * Kept between queries, so they do not allocate
+   */
+  mutable std::vector<QueryEntry> queryStack;
+
+  ProxyId allocateNode();
+  void freeNode(ProxyId index);
+  void insertLeaf(ProxyId leaf);
+  void removeLeaf(ProxyId leaf);
+
+  /**
+   * Rotate the subtree at `index` if one side is
+   * more than one level taller than the other
+   *
+   * @param index
+   * The root of the subtree to balance
+   *
+   * @return
+   * The new root of the subtree
+   */
+  ProxyId balance(ProxyId index);
+
+  /**
+   * Recalculate the bounds & heights from `index` up to the root,
+   * balancing along the way
+   *
+   * @param index
+   * The first node to update
+   */
+  void refit(ProxyId index);
+
+public:
+  /**
+   * @param margin
+   * The distance items may move from where they were
+   * last inserted before they are reinserted
+   */
+  explicit BoundingVolumeHierarchy(float margin = 0.0f);
+
+  /**
+   * Add an item to the tree
+   *
+   * @param bounds
+   * The bounds of the item
+   *
+   * @param item
+   * The value reported by queries which find this item
+   *
+   * @return
+   * The handle to move or remove the item with
+   */
+  ProxyId insert(const Aabb &bounds, unsigned int item);
+
+  /**
+   * Remove an item from the tree
+   *
+   * @param proxy
+   * The handle returned by `insert()`
+   */
+  void remove(ProxyId proxy);
+
+  /**
+   * Update the bounds of an item.
+   * Only reinserts the item if it left its grown box,
+   * or shrank well inside it
+   *
+   * @param proxy
+   * The handle returned by `insert()`
+   *
+   * @param bounds
+   * The new bounds of the item
+   *
+   * @return
+   * True if the item was reinserted
+   */
+  bool move(ProxyId proxy, const Aabb &bounds);
+
+  /**
+   * Remove every item
+   */
+  void clear();
+
+  /**
+   * @return
+   * The number of items in the tree
+   */
+  [[nodiscard]] std::size_t size() const;
+
+  /**
+   * Find the items which may be inside `frustum`.
+   * Subtrees entirely inside are reported without testing their items
+   *
+   * @param frustum
+   * The volume to search
+   *
+   * @param callback
+   * Called with the item of each box found
+   *
+   * @param stats
+   * Incremented with the boxes tested & items found
+   */
+  template <typename Callback>
+  void query(const Frustum &frustum, Callback &&callback, QueryStats &stats) const {
+    if (root == nullProxy)
+      return;
+
+    queryStack.clear();
+    queryStack.push_back({root, false});
+
+    while (!queryStack.empty()) {
+      const auto entry = queryStack.back();
+      queryStack.pop_back();
+      const auto &node = treeNodes[entry.index];
+
+      auto inside = entry.inside;
+      if (!inside) {
+        stats.visited++;
+        const auto containment = frustum.test(node.bounds);
+        if (containment == Frustum::Containment::Outside)
+          continue;
+        inside = containment == Frustum::Containment::Inside;
+      }
+
+      if (node.isLeaf()) {
+        stats.accepted++;
+        callback(node.item);
+        continue;
+      }
+
+      queryStack.push_back({node.left, inside});
+      queryStack.push_back({node.right, inside});
+    }
+  }
+
+  /**
+   * Find the items whose grown boxes a ray passes through
+   *
+   * @param origin
+   * The start of the ray
+   *
+   * @param direction
+   * The direction of the ray
+   *
+   * @param callback
+   * Called with the item of each box hit,
+   * in no particular order
+   */
+  template <typename Callback>
+  void query(const glm::vec3 &origin, const glm::vec3 &direction, Callback &&callback) const {
+    if (root == nullProxy)
+      return;
+
+    queryStack.clear();
+    queryStack.push_back({root, false});
+
+    while (!queryStack.empty()) {
+      const auto &node = treeNodes[queryStack.back().index];
+      queryStack.pop_back();
+
+      if (!node.bounds.intersect(origin, direction))
+        continue;
+
+      if (node.isLeaf()) {
+        callback(node.item);
+        continue;
+      }
+
+      queryStack.push_back({node.left, false});
+      queryStack.push_back({node.right, false});
+    }
+  }
+};
+
+} // namespace netsimulyzer
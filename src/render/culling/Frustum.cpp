@@ -0,0 +1,79 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "Frustum.h"
+
+namespace netsimulyzer {
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+  // Rows of the matrix, which is stored by column
+  std::array<glm::vec4, 4> rows;
+  for (auto i = 0; i < 4; i++) {
+    rows[i] = {viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+  }
+
+  // A point is inside when -w <= x, y, z <= w in clip space,
+  // so each plane is the last row plus or minus one of the others
+  planes[0] = rows[3] + rows[0];
+  planes[1] = rows[3] - rows[0];
+  planes[2] = rows[3] + rows[1];
+  planes[3] = rows[3] - rows[1];
+  planes[4] = rows[3] + rows[2];
+  planes[5] = rows[3] - rows[2];
+
+  for (auto &plane : planes) {
+    plane /= glm::length(glm::vec3{plane});
+  }
+}
+
+Frustum::Containment Frustum::test(const Aabb &box) const {
+  auto result = Containment::Inside;
+
+  for (const auto &plane : planes) {
+    const auto normal = glm::vec3{plane};
+
+    // The corners furthest along & against the normal
+    const auto positive = glm::mix(box.min, box.max, glm::greaterThanEqual(normal, glm::vec3{0.0f}));
+    const auto negative = glm::mix(box.max, box.min, glm::greaterThanEqual(normal, glm::vec3{0.0f}));
+
+    if (glm::dot(normal, positive) + plane.w < 0.0f)
+      return Containment::Outside;
+
+    if (glm::dot(normal, negative) + plane.w < 0.0f)
+      result = Containment::Intersecting;
+  }
+
+  return result;
+}
+
+} // namespace netsimulyzer
@@ -34,7 +34,6 @@
 #include "FontManager.h"
 #include "src/render/font/undefined-medium-font.h"
 #include <algorithm>
-#include <iostream>
 
 namespace netsimulyzer {
 
@@ -44,16 +43,7 @@ FontManager::FontManager(TextureCache &textureCache) // NOLINT(cppcoreguidelines
     : textureCache(textureCache) {
 }
 
-FontManager::~FontManager() {
-  reset();
-}
-
 void FontManager::init(const std::string &atlasFilePath) {
-  if (!gl.initializeOpenGLFunctions()) {
-    std::cerr << "Failed to initialize FontManager OpenGL Functions!\n";
-    std::abort();
-  }
-
   // Use `GL_NEAREST` filtering, since this is a
   // pixelated font
   atlasTexture = textureCache.loadInternal(atlasFilePath, GL_NEAREST);
@@ -64,24 +54,14 @@ void FontManager::init(const std::string &atlasFilePath) {
 }
 
 void FontManager::reset() {
-  for (const auto &font : createdFontMeshes) {
-    gl.glDeleteBuffers(1, &font.glyphVbo);
-    gl.glDeleteBuffers(1, &font.backgroundVbo);
-
-    gl.glDeleteVertexArrays(1, &font.glyphVao);
-    gl.glDeleteVertexArrays(1, &font.backgroundVao);
-  }
-
-  createdFontMeshes.clear();
+  glyphs.clear();
 }
 
 FontManager::FontBannerRenderInfo FontManager::allocate(std::string_view text) {
-  textureCache.use(atlasTexture);
   FontBannerRenderInfo renderInfo; // NOLINT(cppcoreguidelines-pro-type-member-init)
 
+  renderInfo.firstGlyph = static_cast<int>(glyphs.size());
   renderInfo.size = static_cast<int>(text.size());
-  renderInfo.glyphVboSize = renderInfo.size * 6; // 3 Vertices per triangle, 2 triangles per glyph
-  renderInfo.backgroundVboSize = 3 * 2;          // 3 Vertices per triangle, 2 triangles in the rectangle
 
   // ----- Glyphs -----
   // Fixed scale factor for the font + background
@@ -97,21 +77,9 @@ FontManager::FontBannerRenderInfo FontManager::allocate(std::string_view text) {
   const auto estimatedAdvance = 32.0f * scale;
   const auto startX = -1.0f * (estimatedAdvance * text.size()) / 2.0f;
 
-  gl.glGenVertexArrays(1, &renderInfo.glyphVao);
-  gl.glGenBuffers(1, &renderInfo.glyphVbo);
-
-  gl.glBindVertexArray(renderInfo.glyphVao);
-  gl.glBindBuffer(GL_ARRAY_BUFFER, renderInfo.glyphVbo);
-
-  gl.glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4 * text.size(), nullptr, GL_STATIC_DRAW);
-
-  // Location
-  gl.glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
-  gl.glEnableVertexAttribArray(0);
-
   // Loop through each character in the string,
   // calculate the size, offsets, etc. for each glyph
-  // then, add the mesh for the glyph to `renderInfo.glyphVbo`
+  // then, add the glyph to `glyphs`
   float maxX = 0.0f; // Max X/Y for the borders of the background
   float maxY = 0.0f;
   float minY = 0.0f;
@@ -121,8 +89,7 @@ FontManager::FontBannerRenderInfo FontManager::allocate(std::string_view text) {
   // Halfway to the left, to center the text
   float x = startX;
   float y = 0.0f;
-  // Index of the glyph
-  auto i = 0;
+  glyphs.reserve(glyphs.size() + text.size());
   for (const auto &c : text) {
     // use `at()` since there's no const `[]`
     const auto &ch = undefined_medium::fontGlyphs.at(c);
@@ -148,30 +115,14 @@ FontManager::FontBannerRenderInfo FontManager::allocate(std::string_view text) {
     const auto highX = (ch.x + ch.size.x) / atlasWidth;
     const auto highY = (ch.y + ch.size.y) / atlasHeight;
 
-    // clang-format off
-    float vertices[6][4] ={
-         {positionX,                  positionY + characterHeight,   lowX, lowY},
-         {positionX,                  positionY,                     lowX, highY},
-         {positionX + characterWidth, positionY,                     highX, highY},
-
-         {positionX,                  positionY + characterHeight,  lowX, lowY},
-         {positionX + characterWidth, positionY,                    highX, highY},
-         {positionX + characterWidth, positionY + characterHeight,  highX, lowY}
-        };
-    // clang-format on
+    glyphs.push_back({{positionX, positionY, positionX + characterWidth, positionY + characterHeight},
+                      {lowX, lowY, highX, highY}});
     x += estimatedAdvance;
-
-    gl.glBufferSubData(GL_ARRAY_BUFFER, sizeof(vertices) * i, sizeof(vertices), vertices);
-    i++;
   }
 
   // ----- Background -----
   // The background is one quad, rendered in black/grey
   // behind the glyphs
-  gl.glGenVertexArrays(1, &renderInfo.backgroundVao);
-  gl.glGenBuffers(1, &renderInfo.backgroundVbo);
-  gl.glBindVertexArray(renderInfo.backgroundVao);
-  gl.glBindBuffer(GL_ARRAY_BUFFER, renderInfo.backgroundVbo);
 
   // Grab the offset for the last character,
   // so we may get the correct right border for the background
@@ -179,26 +130,7 @@ FontManager::FontBannerRenderInfo FontManager::allocate(std::string_view text) {
 
   // Add/Subtract `estimatedAdvance` to give some extra
   // overhang to the background
-  // clang-format off
-  float bgVertices[6][2] = {
-      {startX           - estimatedAdvance, maxY},
-      {startX           - estimatedAdvance, minY},
-      {maxX + endOffset + estimatedAdvance, minY},
-
-      {startX           - estimatedAdvance, maxY},
-      {maxX + endOffset + estimatedAdvance, minY},
-      {maxX + endOffset + estimatedAdvance, maxY},
-  };
-  // clang-format on
-
-  gl.glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 2 * 6, bgVertices, GL_STATIC_DRAW);
-
-  // Location
-  gl.glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-  gl.glEnableVertexAttribArray(0);
-
-  gl.glBindBuffer(GL_ARRAY_BUFFER, 0);
-  gl.glBindVertexArray(0);
+  renderInfo.backgroundBounds = {startX - estimatedAdvance, minY, maxX + endOffset + estimatedAdvance, maxY};
 
   return renderInfo;
 }
@@ -207,4 +139,8 @@ texture_id FontManager::getAtlasTexture() const {
   return atlasTexture;
 }
 
+const std::vector<FontManager::Glyph> &FontManager::getGlyphs() const {
+  return glyphs;
+}
+
 } // namespace netsimulyzer
@@ -34,33 +34,53 @@
 #pragma once
 
 #include "src/render/texture/TextureCache.h"
-#include <QOpenGLFunctions_3_3_Core>
+#include <glm/vec4.hpp>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace netsimulyzer {
 
 class FontManager {
 public:
-  struct FontBannerRenderInfo {
-    unsigned int glyphVao;
-    unsigned int glyphVbo;
-    unsigned int backgroundVao;
-    unsigned int backgroundVbo;
+  /**
+   * A single character of a banner
+   */
+  struct Glyph {
+    /**
+     * The corners of the glyph, relative to the
+     * bottom-center of the banner, before scaling.
+     * <vec2 min, vec2 max>
+     */
+    glm::vec4 bounds;
 
     /**
-     * Size of the string to render (in characters)
+     * The corners of the glyph on the atlas, in texture coordinates.
+     * <vec2 top left, vec2 bottom right>
      */
-    int size;
+    glm::vec4 textureBounds;
+  };
 
+  /**
+   * Layout of a banner, drawn by `Renderer::queueLabel()`
+   */
+  struct FontBannerRenderInfo {
     /**
-     * Number of vertices of the VBO holding the glyphs
+     * Index of the first glyph of the banner in `getGlyphs()`
      */
-    int glyphVboSize;
+    int firstGlyph;
 
     /**
-     * Number of vertices of the VBO holding the background banner
+     * Size of the string to render (in characters)
+     */
+    int size;
+
+    /**
+     * The corners of the background behind the glyphs,
+     * relative to the bottom-center of the banner, before scaling.
+     * <vec2 min, vec2 max>
      */
-    int backgroundVboSize;
+    glm::vec4 backgroundBounds;
   };
 
 private:
@@ -68,16 +88,19 @@ private:
   texture_id atlasTexture;
   float atlasWidth;
   float atlasHeight;
-  QOpenGLFunctions_3_3_Core gl;
-  std::vector<FontBannerRenderInfo> createdFontMeshes;
+
+  /**
+   * The glyphs of every allocated banner
+   */
+  std::vector<Glyph> glyphs;
 
 public:
   explicit FontManager(TextureCache &textureCache);
-  ~FontManager();
   void init(const std::string &atlasFilePath);
   void reset();
 
   [[nodiscard]] texture_id getAtlasTexture() const;
+  [[nodiscard]] const std::vector<Glyph> &getGlyphs() const;
 
   FontBannerRenderInfo allocate(std::string_view text);
 };
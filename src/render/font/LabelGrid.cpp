@@ -0,0 +1,80 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "LabelGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace netsimulyzer {
+
+LabelGrid::LabelGrid(float cellSize) : cellSize(cellSize) {
+}
+
+void LabelGrid::reset(int width, int height) {
+  columns = std::max(1, static_cast<int>(std::ceil(static_cast<float>(width) / cellSize)));
+  rows = std::max(1, static_cast<int>(std::ceil(static_cast<float>(height) / cellSize)));
+  cells.assign(static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows), 0u);
+}
+
+bool LabelGrid::tryPlace(const glm::vec2 &min, const glm::vec2 &max) {
+  const auto firstColumn = static_cast<int>(std::floor(min.x / cellSize));
+  const auto lastColumn = static_cast<int>(std::floor(max.x / cellSize));
+  const auto firstRow = static_cast<int>(std::floor(min.y / cellSize));
+  const auto lastRow = static_cast<int>(std::floor(max.y / cellSize));
+
+  if (lastColumn < 0 || lastRow < 0 || firstColumn >= columns || firstRow >= rows)
+    return false;
+
+  // Only the part of the label on the screen may overlap another
+  const auto startColumn = std::max(firstColumn, 0);
+  const auto endColumn = std::min(lastColumn, columns - 1);
+  const auto startRow = std::max(firstRow, 0);
+  const auto endRow = std::min(lastRow, rows - 1);
+
+  for (auto row = startRow; row <= endRow; row++) {
+    const auto rowStart = cells.begin() + static_cast<std::ptrdiff_t>(row) * columns;
+    if (std::any_of(rowStart + startColumn, rowStart + endColumn + 1, [](std::uint8_t cell) {
+          return cell != 0u;
+        }))
+      return false;
+  }
+
+  for (auto row = startRow; row <= endRow; row++) {
+    const auto rowStart = cells.begin() + static_cast<std::ptrdiff_t>(row) * columns;
+    std::fill(rowStart + startColumn, rowStart + endColumn + 1, 1u);
+  }
+
+  return true;
+}
+
+} // namespace netsimulyzer
@@ -0,0 +1,96 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Coarse grid over the screen, marking where labels were placed.
+ * Used to drop labels which would overlap one already placed
+ */
+class LabelGrid {
+  /**
+   * The size of each cell, in pixels
+   */
+  float cellSize;
+
+  int columns{0};
+  int rows{0};
+
+  /**
+   * If each cell is covered by a placed label, row by row
+   */
+  std::vector<std::uint8_t> cells;
+
+public:
+  /**
+   * @param cellSize
+   * The size of each cell, in pixels.
+   * Smaller cells allow labels to be placed closer together,
+   * but are slower to check
+   */
+  explicit LabelGrid(float cellSize = 8.0f);
+
+  /**
+   * Remove every placed label,
+   * and size the grid for a new frame
+   *
+   * @param width
+   * The width of the screen, in pixels
+   *
+   * @param height
+   * The height of the screen, in pixels
+   */
+  void reset(int width, int height);
+
+  /**
+   * Place a label, if it does not overlap any placed label
+   *
+   * @param min
+   * The bottom left corner of the label, in pixels
+   *
+   * @param max
+   * The top right corner of the label, in pixels
+   *
+   * @return
+   * True if the label was placed,
+   * False if it overlaps another label or is off the screen
+   */
+  bool tryPlace(const glm::vec2 &min, const glm::vec2 &max);
+};
+
+} // namespace netsimulyzer
@@ -42,6 +42,7 @@ void Mesh::move(Mesh &&other) noexcept {
   renderInfo = other.renderInfo;
   material = other.material;
   bounds = other.bounds;
+  instanceVbo = other.instanceVbo;
 
   // Clear the other one
   // so it doesn't delete the mesh
@@ -49,6 +50,42 @@ void Mesh::move(Mesh &&other) noexcept {
   other.renderInfo.vbo = 0u;
   other.renderInfo.ibo = 0u;
   other.renderInfo.indexCount = 0u;
+  other.instanceVbo = 0u;
+}
+
+void Mesh::bindInstanceBuffer(unsigned int buffer) {
+  instanceVbo = buffer;
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+  // Model matrix, takes one location per column
+  for (auto i = 0u; i < 4u; i++) {
+    glVertexAttribPointer(3u + i, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                          reinterpret_cast<void *>(offsetof(Instance, model) + sizeof(glm::vec4) * i));
+    glEnableVertexAttribArray(3u + i);
+    glVertexAttribDivisor(3u + i, 1u);
+  }
+
+  // Base Color
+  glVertexAttribPointer(7u, 3, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                        reinterpret_cast<void *>(offsetof(Instance, baseColor)));
+  glEnableVertexAttribArray(7u);
+  glVertexAttribDivisor(7u, 1u);
+
+  // Highlight Color
+  glVertexAttribPointer(8u, 3, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                        reinterpret_cast<void *>(offsetof(Instance, highlightColor)));
+  glEnableVertexAttribArray(8u);
+  glVertexAttribDivisor(8u, 1u);
+
+  // Flags
+  glVertexAttribIPointer(9u, 1, GL_UNSIGNED_INT, sizeof(Instance), reinterpret_cast<void *>(offsetof(Instance, flags)));
+  glEnableVertexAttribArray(9u);
+  glVertexAttribDivisor(9u, 1u);
+
+  // ID
+  glVertexAttribIPointer(10u, 1, GL_UNSIGNED_INT, sizeof(Instance), reinterpret_cast<void *>(offsetof(Instance, id)));
+  glEnableVertexAttribArray(10u);
+  glVertexAttribDivisor(10u, 1u);
 }
 
 const Material &Mesh::getMaterial() const {
@@ -59,7 +96,7 @@ void Mesh::setMaterial(const Material &value) {
   material = value;
 }
 
-Mesh::Mesh(const Vertex vertices[], unsigned int indices[], unsigned int vertexCount, int indexCount) {
+Mesh::Mesh(const Vertex vertices[], const unsigned int indices[], unsigned int vertexCount, int indexCount) {
   initializeOpenGLFunctions();
   renderInfo.indexCount = indexCount;
 
@@ -125,6 +162,17 @@ void Mesh::render() {
   glBindVertexArray(0);
 }
 
+void Mesh::renderInstanced(unsigned int buffer, int count) {
+  glBindVertexArray(renderInfo.vao);
+  if (instanceVbo != buffer)
+    bindInstanceBuffer(buffer);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderInfo.ibo);
+  glDrawElementsInstanced(GL_TRIANGLES, renderInfo.indexCount, GL_UNSIGNED_INT, nullptr, count);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
 Mesh::~Mesh() {
   glDeleteBuffers(1, &renderInfo.ibo);
   renderInfo.ibo = 0;
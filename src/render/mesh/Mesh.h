@@ -55,15 +55,55 @@ public:
     glm::vec3 max{0.0f};
   };
 
+  /**
+   * Flags for `Instance::flags`
+   */
+  enum InstanceFlag : unsigned int { HasBaseColor = 1u, HasHighlightColor = 2u, Selected = 4u };
+
+  /**
+   * Attributes for a single copy of a mesh,
+   * drawn by `renderInstanced()`
+   */
+  struct Instance {
+    glm::mat4 model;
+    glm::vec3 baseColor;
+    glm::vec3 highlightColor;
+
+    /**
+     * Combination of `InstanceFlag`s
+     */
+    unsigned int flags;
+
+    /**
+     * ID of the object drawn, written by the picking pass
+     */
+    unsigned int id;
+  };
+
 private:
   MeshRenderInfo renderInfo;
   MeshBounds bounds;
   Material material;
 
+  /**
+   * The buffer of `Instance`s the vertex array
+   * reads per-instance attributes from.
+   * 0 if the mesh has not been drawn instanced
+   */
+  unsigned int instanceVbo = 0u;
+
+  /**
+   * Point the per-instance attributes of the vertex array at `buffer`
+   *
+   * @param buffer
+   * The buffer of `Instance`s to read from
+   */
+  void bindInstanceBuffer(unsigned int buffer);
+
   void move(Mesh &&other) noexcept;
 
 public:
-  Mesh(const Vertex vertices[], unsigned int indices[], unsigned int vertexCount, int indexCount);
+  Mesh(const Vertex vertices[], const unsigned int indices[], unsigned int vertexCount, int indexCount);
 
   // Allow Moves
   Mesh(Mesh &&other) noexcept {
@@ -88,6 +128,17 @@ public:
 
   void render();
 
+  /**
+   * Draw `count` copies of the mesh in a single call
+   *
+   * @param buffer
+   * The buffer holding at least `count` `Instance`s
+   *
+   * @param count
+   * The number of copies to draw
+   */
+  void renderInstanced(unsigned int buffer, int count);
+
   ~Mesh() override;
 };
 
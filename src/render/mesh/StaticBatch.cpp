@@ -0,0 +1,107 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "StaticBatch.h"
+#include <cstdint>
+
+namespace netsimulyzer {
+
+StaticBatch::Range StaticBatch::add(const std::vector<Vertex> &objectVertices,
+                                    const std::vector<unsigned int> &objectIndices) {
+  const auto base = static_cast<unsigned int>(vertices.size());
+  const Range range{static_cast<unsigned int>(indices.size()), static_cast<unsigned int>(objectIndices.size())};
+
+  vertices.insert(vertices.end(), objectVertices.begin(), objectVertices.end());
+
+  indices.reserve(indices.size() + objectIndices.size());
+  for (const auto index : objectIndices)
+    indices.emplace_back(base + index);
+
+  dirty = true;
+  return range;
+}
+
+void StaticBatch::clear() {
+  vertices.clear();
+  indices.clear();
+  clearQueue();
+  dirty = true;
+}
+
+void StaticBatch::queue(const Range &range) {
+  if (range.count == 0u)
+    return;
+
+  if (!drawCounts.empty() && range.offset == queueEnd) {
+    drawCounts.back() += static_cast<int>(range.count);
+    queueEnd += range.count;
+    return;
+  }
+
+  drawCounts.emplace_back(static_cast<int>(range.count));
+  drawOffsets.emplace_back(
+      reinterpret_cast<const void *>(static_cast<std::uintptr_t>(range.offset) * sizeof(unsigned int)));
+  queueEnd = range.offset + range.count;
+}
+
+void StaticBatch::clearQueue() {
+  drawCounts.clear();
+  drawOffsets.clear();
+  queueEnd = 0u;
+}
+
+void StaticBatch::uploaded() {
+  dirty = false;
+}
+
+bool StaticBatch::isDirty() const {
+  return dirty;
+}
+
+const std::vector<StaticBatch::Vertex> &StaticBatch::getVertices() const {
+  return vertices;
+}
+
+const std::vector<unsigned int> &StaticBatch::getIndices() const {
+  return indices;
+}
+
+const std::vector<int> &StaticBatch::getDrawCounts() const {
+  return drawCounts;
+}
+
+const std::vector<const void *> &StaticBatch::getDrawOffsets() const {
+  return drawOffsets;
+}
+
+} // namespace netsimulyzer
@@ -0,0 +1,151 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include <cstddef>
+#include <glm/vec3.hpp>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Geometry of many static objects, merged into one
+ * vertex & index buffer so they may be drawn together.
+ *
+ * Objects are added with `add()`, which returns the
+ * indices they occupy. Each frame, the ranges of the objects
+ * to draw are given to `queue()`, then drawn by the `Renderer`
+ * with a single multi-draw call
+ */
+class StaticBatch {
+public:
+  struct Vertex {
+    glm::vec3 position;
+    glm::vec3 color;
+  };
+
+  /**
+   * A run of indices in the batch
+   */
+  struct Range {
+    /**
+     * Index of the first index in the run
+     */
+    unsigned int offset{0u};
+
+    /**
+     * The number of indices in the run
+     */
+    unsigned int count{0u};
+  };
+
+  struct RenderInfo {
+    unsigned int vao = 0u;
+    unsigned int vbo = 0u;
+    unsigned int ibo = 0u;
+  };
+
+private:
+  std::vector<Vertex> vertices;
+  std::vector<unsigned int> indices;
+
+  /**
+   * If `vertices` and `indices` changed since
+   * they were last uploaded
+   */
+  bool dirty{false};
+
+  /**
+   * Index counts & byte offsets of the runs queued for the next draw.
+   * Kept between frames, so queueing does not allocate
+   */
+  std::vector<int> drawCounts;
+  std::vector<const void *> drawOffsets;
+
+  /**
+   * One past the last index of the last queued run
+   */
+  unsigned int queueEnd{0u};
+
+public:
+  RenderInfo renderInfo;
+
+  /**
+   * Append an object to the batch
+   *
+   * @param objectVertices
+   * The vertices of the object
+   *
+   * @param objectIndices
+   * Indices into `objectVertices`.
+   * Rebased to the position of the object in the batch
+   *
+   * @return
+   * The indices the object occupies
+   */
+  Range add(const std::vector<Vertex> &objectVertices, const std::vector<unsigned int> &objectIndices);
+
+  /**
+   * Remove every object, and empty the queue
+   */
+  void clear();
+
+  /**
+   * Queue a range for the next draw.
+   * Runs following directly from the previously queued run
+   * are merged into it, so objects queued in the order they were added
+   * are drawn as one run
+   *
+   * @param range
+   * The indices to draw
+   */
+  void queue(const Range &range);
+
+  /**
+   * Empty the queue, after it has been drawn
+   */
+  void clearQueue();
+
+  /**
+   * Mark the batch as uploaded
+   */
+  void uploaded();
+
+  [[nodiscard]] bool isDirty() const;
+  [[nodiscard]] const std::vector<Vertex> &getVertices() const;
+  [[nodiscard]] const std::vector<unsigned int> &getIndices() const;
+  [[nodiscard]] const std::vector<int> &getDrawCounts() const;
+  [[nodiscard]] const std::vector<const void *> &getDrawOffsets() const;
+};
+
+} // namespace netsimulyzer
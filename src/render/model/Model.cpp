@@ -38,6 +38,7 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <iostream>
+#include <limits>
 #include <utility>
 #include <glm/gtx/norm.hpp>
 
@@ -280,6 +281,42 @@ Model::ModelBounds Model::getBounds() const {
   return {min, max};
 }
 
+std::optional<float> Model::intersect(const glm::vec3 &origin, const glm::vec3 &direction) const {
+  // Move the ray into the model's space, so it may be
+  // tested against the untransformed bounds
+  const auto inverseModel = glm::inverse(modelMatrix);
+  const glm::vec3 localOrigin = inverseModel * glm::vec4{origin, 1.0f};
+  const glm::vec3 localDirection = inverseModel * glm::vec4{direction, 0.0f};
+
+  auto tNear = -std::numeric_limits<float>::infinity();
+  auto tFar = std::numeric_limits<float>::infinity();
+
+  // Clip the ray to the slab between `min` & `max` on each axis
+  for (auto i = 0; i < 3; i++) {
+    if (localDirection[i] == 0.0f) {
+      if (localOrigin[i] < min[i] || localOrigin[i] > max[i])
+        return {};
+      continue;
+    }
+
+    auto t1 = (min[i] - localOrigin[i]) / localDirection[i];
+    auto t2 = (max[i] - localOrigin[i]) / localDirection[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+
+    tNear = std::max(tNear, t1);
+    tFar = std::min(tFar, t2);
+    if (tNear > tFar)
+      return {};
+  }
+
+  // Box is behind the ray
+  if (tFar < 0.0f)
+    return {};
+
+  return std::max(tNear, 0.0f);
+}
+
 void Model::setBaseColor(const glm::vec3 &value) {
   baseColor.emplace(value);
 }
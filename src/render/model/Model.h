@@ -129,6 +129,22 @@ public:
 
   [[nodiscard]] ModelBounds getBounds() const;
 
+  /**
+   * Test a ray against the bounding box of the model,
+   * after the model's position, rotation & scale are applied
+   *
+   * @param origin
+   * The start of the ray, in world space
+   *
+   * @param direction
+   * The direction of the ray, in world space
+   *
+   * @return
+   * The distance along the ray to the box, in multiples of `direction`.
+   * Unset if the ray misses the box
+   */
+  [[nodiscard]] std::optional<float> intersect(const glm::vec3 &origin, const glm::vec3 &direction) const;
+
   void setBaseColor(const glm::vec3 &value);
   void unsetBaseColor();
   [[nodiscard]] const std::optional<glm::vec3> &getBaseColor() const;
@@ -35,52 +35,116 @@
 #include "../shader/Shader.h"
 #include <QDebug>
 #include <QFileInfo>
+#include <QStandardPaths>
 #include <algorithm>
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <chrono>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <unordered_map>
 #include <utility>
 
 namespace netsimulyzer {
 
-void ModelRenderInfo::updateBounds() {
-  if (!meshes.empty()) {
-    const auto &firstBounds = meshes.front().getBounds();
-    bounds.min = firstBounds.min;
-    bounds.max = firstBounds.max;
-  }
+namespace {
 
-  for (const auto &mesh : meshes) {
-    const auto &meshBounds = mesh.getBounds();
-    bounds.max.x = std::max(bounds.max.x, meshBounds.max.x);
-    bounds.min.x = std::min(bounds.min.x, meshBounds.min.x);
+const unsigned int importFlags =
+    aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices;
 
-    bounds.max.y = std::max(bounds.max.y, meshBounds.max.y);
-    bounds.min.y = std::min(bounds.min.y, meshBounds.min.y);
+/**
+ * Default file access, which notes the path of each file opened,
+ * so the files a model was imported from are known
+ */
+class RecordingIOSystem : public Assimp::DefaultIOSystem {
+  std::vector<std::string> &opened;
 
-    bounds.max.z = std::max(bounds.max.z, meshBounds.max.z);
-    bounds.min.z = std::min(bounds.min.z, meshBounds.min.z);
+public:
+  explicit RecordingIOSystem(std::vector<std::string> &opened) : opened(opened) {
   }
-}
 
-void ModelRenderInfo::loadNode(aiNode const *node, aiScene const *scene) {
-  for (auto i = 0u; i < node->mNumMeshes; i++) {
-    loadMesh(scene->mMeshes[node->mMeshes[i]], scene);
+  Assimp::IOStream *Open(const char *file, const char *mode) override {
+    auto stream = DefaultIOSystem::Open(file, mode);
+    if (stream && std::find(opened.begin(), opened.end(), file) == opened.end())
+      opened.emplace_back(file);
+
+    return stream;
   }
+};
 
-  for (auto i = 0u; i < node->mNumChildren; i++) {
-    loadNode(node->mChildren[i], scene);
+/**
+ * Get the directory for `ModelDiskCache`
+ *
+ * @return
+ * The directory, or an empty path if there is
+ * nowhere to write it, which disables the cache
+ */
+std::filesystem::path diskCacheDirectory() {
+  const auto location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (location.isEmpty())
+    return {};
+
+  return std::filesystem::path{location.toStdU16String()} / "models";
+}
+
+void readMaterials(aiScene const *scene, ModelData &data) {
+  using MaterialType = Material::MaterialType;
+
+  data.materials.reserve(scene->mNumMaterials);
+  for (auto i = 0u; i < scene->mNumMaterials; i++) {
+    auto const *material = scene->mMaterials[i];
+    auto &materialData = data.materials.emplace_back();
+    auto &m = materialData.material;
+
+    material->Get(AI_MATKEY_OPACITY, m.opacity);
+
+    aiString name;
+    material->Get(AI_MATKEY_NAME, name);
+
+    // Check for configurable materials
+    if (std::strcmp(name.data, "netsimulyzer.base") == 0) {
+      m.materialType = MaterialType::Base;
+    } else if (std::strcmp(name.data, "netsimulyzer.highlight") == 0)
+      m.materialType = MaterialType::Highlight;
+    else
+      m.materialType = MaterialType::Unclassified;
+
+    if (material->GetTextureCount(aiTextureType_DIFFUSE)) {
+      aiString path;
+
+      if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS) {
+        std::string pathCppString{path.data};
+        // Strips back to the last '\' character (i.e. 'C:\Users\Evan\projects' -> 'projects')
+        materialData.texture = pathCppString.substr(pathCppString.rfind('\\') + 1);
+      } else {
+        materialData.useFallbackTexture = true;
+      }
+    } else {
+      aiColor3D color;
+
+      // Diffuse diffuse & transparent color are separate for some reason...
+      if (m.opacity < 1.0f)
+        material->Get(AI_MATKEY_COLOR_TRANSPARENT, color);
+      else
+        material->Get(AI_MATKEY_COLOR_DIFFUSE, color);
+
+      m.color = {color.r, color.g, color.b};
+    }
+
+    material->Get(AI_MATKEY_SHININESS, m.shininess);                  // Errors Ignored
+    material->Get(AI_MATKEY_SHININESS_STRENGTH, m.specularIntensity); // Errors Ignored
   }
 }
 
-void ModelRenderInfo::loadMesh(aiMesh const *m, aiScene const *) {
-  std::vector<Vertex> vertices;
-  vertices.reserve(m->mNumVertices);
+void readMesh(aiMesh const *m, ModelData &data) {
+  auto &mesh = data.meshes.emplace_back();
+  mesh.materialIndex = m->mMaterialIndex;
 
-  std::vector<unsigned int> indices;
+  auto &vertices = mesh.vertices;
+  vertices.reserve(m->mNumVertices);
 
   for (auto i = 0u; i < m->mNumVertices; i++) {
     Vertex v;
@@ -102,22 +166,59 @@ void ModelRenderInfo::loadMesh(aiMesh const *m, aiScene const *) {
     const auto &face = m->mFaces[i];
 
     for (auto j = 0u; j < face.mNumIndices; j++) {
-      indices.emplace_back(face.mIndices[j]);
+      mesh.indices.emplace_back(face.mIndices[j]);
     }
   }
+}
+
+void readNode(aiNode const *node, aiScene const *scene, ModelData &data) {
+  for (auto i = 0u; i < node->mNumMeshes; i++) {
+    readMesh(scene->mMeshes[node->mMeshes[i]], data);
+  }
+
+  for (auto i = 0u; i < node->mNumChildren; i++) {
+    readNode(node->mChildren[i], scene, data);
+  }
+}
+
+} // namespace
+
+void ModelRenderInfo::updateBounds() {
+  if (!meshes.empty()) {
+    const auto &firstBounds = meshes.front().getBounds();
+    bounds.min = firstBounds.min;
+    bounds.max = firstBounds.max;
+  }
 
-  const auto &material = materials[m->mMaterialIndex];
+  for (const auto &mesh : meshes) {
+    const auto &meshBounds = mesh.getBounds();
+    bounds.max.x = std::max(bounds.max.x, meshBounds.max.x);
+    bounds.min.x = std::min(bounds.min.x, meshBounds.min.x);
+
+    bounds.max.y = std::max(bounds.max.y, meshBounds.max.y);
+    bounds.min.y = std::min(bounds.min.y, meshBounds.min.y);
+
+    bounds.max.z = std::max(bounds.max.z, meshBounds.max.z);
+    bounds.min.z = std::min(bounds.min.z, meshBounds.min.z);
+  }
+}
+
+void ModelRenderInfo::loadMesh(const ModelData::MeshData &m) {
+  const auto &material = materials[m.materialIndex];
   if (material.opacity < 1.0f)
-    transparentMeshes.emplace_back(vertices.data(), indices.data(), vertices.size(), indices.size())
+    transparentMeshes.emplace_back(m.vertices.data(), m.indices.data(), m.vertices.size(), m.indices.size())
         .setMaterial(material);
   else
-    meshes.emplace_back(vertices.data(), indices.data(), vertices.size(), indices.size()).setMaterial(material);
+    meshes.emplace_back(m.vertices.data(), m.indices.data(), m.vertices.size(), m.indices.size())
+        .setMaterial(material);
 }
 
-ModelRenderInfo::ModelRenderInfo(aiScene const *scene, TextureCache &textureCache) : textureCache(textureCache) {
+ModelRenderInfo::ModelRenderInfo(const ModelData &data, TextureCache &textureCache) : textureCache(textureCache) {
   initializeOpenGLFunctions();
-  loadMaterials(scene);
-  loadNode(scene->mRootNode, scene);
+  loadMaterials(data);
+  for (const auto &mesh : data.meshes) {
+    loadMesh(mesh);
+  }
 
   updateBounds();
 }
@@ -133,54 +234,21 @@ ModelRenderInfo::~ModelRenderInfo() {
   clear();
 }
 
-void ModelRenderInfo::loadMaterials(aiScene const *scene) {
-  using MaterialType = Material::MaterialType;
+void ModelRenderInfo::loadMaterials(const ModelData &data) {
   auto fallbackTexture = textureCache.getFallbackTexture();
 
-  for (auto i = 0u; i < scene->mNumMaterials; i++) {
-    auto const *material = scene->mMaterials[i];
-    Material m;
-
-    material->Get(AI_MATKEY_OPACITY, m.opacity);
-
-    aiString name;
-    material->Get(AI_MATKEY_NAME, name);
-
-    // Check for configurable materials
-    if (std::strcmp(name.data, "netsimulyzer.base") == 0) {
-      m.materialType = MaterialType::Base;
-    } else if (std::strcmp(name.data, "netsimulyzer.highlight") == 0)
-      m.materialType = MaterialType::Highlight;
-    else
-      m.materialType = MaterialType::Unclassified;
-
-    if (material->GetTextureCount(aiTextureType_DIFFUSE)) {
-      aiString path;
-
-      if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS) {
-        std::string pathCppString{path.data};
-        // Strips back to the last '\' character (i.e. 'C:\Users\Evan\projects' -> 'projects')
-        auto filepath = pathCppString.substr(pathCppString.rfind('\\') + 1);
-        m.textureId = textureCache.load(filepath);
-      } else {
-        m.textureId = fallbackTexture;
-      }
-    } else {
-      aiColor3D color;
+  materials.reserve(data.materials.size());
+  for (const auto &material : data.materials) {
+    auto &m = materials.emplace_back(material.material);
 
-      // Diffuse diffuse & transparent color are separate for some reason...
-      if (m.opacity < 1.0f)
-        material->Get(AI_MATKEY_COLOR_TRANSPARENT, color);
+    if (material.texture) {
+      const auto texture = data.textures.find(*material.texture);
+      if (texture != data.textures.end())
+        m.textureId = textureCache.load(*material.texture, texture->second);
       else
-        material->Get(AI_MATKEY_COLOR_DIFFUSE, color);
-
-      m.color = {color.r, color.g, color.b};
-    }
-
-    material->Get(AI_MATKEY_SHININESS, m.shininess);                  // Errors Ignored
-    material->Get(AI_MATKEY_SHININESS_STRENGTH, m.specularIntensity); // Errors Ignored
-
-    materials.emplace_back(m);
+        m.textureId = fallbackTexture;
+    } else if (material.useFallbackTexture)
+      m.textureId = fallbackTexture;
   }
 }
 
@@ -261,6 +329,26 @@ void ModelRenderInfo::renderTransparent(Shader &s, const Model &model) {
   }
 }
 
+void ModelRenderInfo::renderInstanced(Shader &s, unsigned int buffer, int count) {
+  for (auto &m : meshes) {
+    const auto &material = m.getMaterial();
+
+    s.uniform("useTexture", material.textureId.has_value());
+
+    // Only materials with a color may be replaced by the instance colors
+    auto materialType = Material::MaterialType::Unclassified;
+    if (material.textureId) {
+      textureCache.use(*material.textureId);
+    } else if (material.color) {
+      s.uniform("material_color", material.color.value());
+      materialType = material.materialType;
+    }
+    s.uniform("material_type", static_cast<int>(materialType));
+
+    m.renderInstanced(buffer, count);
+  }
+}
+
 void ModelRenderInfo::clear() {
   meshes.clear();
 }
@@ -273,7 +361,13 @@ std::vector<Mesh> &ModelRenderInfo::getTransparentMeshes() {
   return transparentMeshes;
 }
 
-ModelCache::ModelCache(TextureCache &textureCache) : textureCache(textureCache) {
+ModelCache::ModelCache(TextureCache &textureCache) : textureCache(textureCache), diskCache(diskCacheDirectory()) {
+}
+
+ModelCache::~ModelCache() {
+  // The models being read are discarded, but the threads must stop first
+  loaders.clear();
+  loaders.waitForDone();
 }
 
 void ModelCache::setBasePath(std::string value) {
@@ -290,6 +384,74 @@ void ModelCache::init(std::string_view fallbackModelPath) {
   fallbackModel = load(_fallbackModelPath).id;
 }
 
+std::optional<ModelData> ModelCache::read(const std::string &path, const QDir &textureDirectory) const {
+  auto data = readModel(path);
+  if (!data)
+    return {};
+
+  // Decode the textures here as well, so the GL thread only uploads them
+  for (const auto &material : data->materials) {
+    if (!material.texture || data->textures.find(*material.texture) != data->textures.end())
+      continue;
+
+    auto texture = textureCache.decode(textureDirectory, *material.texture);
+    if (texture)
+      data->textures.emplace(*material.texture, std::move(texture.value()));
+  }
+
+  return data;
+}
+
+std::optional<ModelData> ModelCache::readModel(const std::string &path) const {
+  auto cached = diskCache.read(path, importFlags);
+  if (cached)
+    return cached;
+
+  // Each thread uses its own importer, they are not shared
+  Assimp::Importer importer;
+
+  // The model itself is always the first file opened
+  std::vector<std::string> sources;
+  importer.SetIOHandler(new RecordingIOSystem{sources}); // Owned by `importer`
+
+  const auto *const scene = importer.ReadFile(path.c_str(), importFlags);
+  if (!scene) {
+    std::cerr << "Model (" << path << ") failed to load: " << importer.GetErrorString() << '\n';
+    return {};
+  }
+
+  ModelData data;
+  readMaterials(scene, data);
+  readNode(scene->mRootNode, scene, data);
+
+  // Assimp may open the model by another spelling of its path,
+  // but the cache is looked up by `path`
+  if (!sources.empty())
+    sources.front() = path;
+  if (diskCache.enabled() && !diskCache.write(path, importFlags, sources, data))
+    std::cerr << "Failed to write model cache for: " << path << '\n';
+
+  return data;
+}
+
+void ModelCache::finish(PendingModel &model) {
+  auto data = model.data.get();
+  if (!data) {
+    // Later requests for the same path get the fallback directly
+    indexMap.insert_or_assign(model.path, fallbackModel);
+    return;
+  }
+
+  models[model.id] = std::make_unique<ModelRenderInfo>(*data, textureCache);
+  uploaded.emplace_back(model.id);
+}
+
+Model::ModelLoadInfo ModelCache::loadInfo(model_id id) const {
+  const auto &model = models[id] ? models[id] : models[fallbackModel];
+  const auto &bounds = model->getBounds();
+  return {id, bounds.min, bounds.max};
+}
+
 Model::ModelLoadInfo ModelCache::load(const std::string &path) {
   return loadAbsolute(basePath + path);
 }
@@ -297,36 +459,98 @@ Model::ModelLoadInfo ModelCache::load(const std::string &path) {
 Model::ModelLoadInfo ModelCache::loadAbsolute(const std::string &path) {
   auto existing = indexMap.find(path);
   if (existing != indexMap.end()) {
-    const auto &bounds = get(existing->second).getBounds();
-    return {existing->second, bounds.min, bounds.max};
-  }
+    const auto id = existing->second;
+
+    // Already requested, but not read yet, so wait for it here
+    auto pendingModel =
+        std::find_if(pending.begin(), pending.end(), [id](const PendingModel &model) { return model.id == id; });
+    if (pendingModel != pending.end()) {
+      finish(*pendingModel);
+      pending.erase(pendingModel);
+      return loadInfo(indexMap[path]);
+    }
 
-  Assimp::Importer importer;
-  const auto *const scene =
-      importer.ReadFile(path.c_str(), aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals |
-                                          aiProcess_JoinIdenticalVertices);
-  if (!scene) {
-    std::cerr << "Model (" << path << ") failed to load: " << importer.GetErrorString() << '\n';
+    return loadInfo(id);
+  }
 
+  auto data = read(path, textureCache.getResourceDirectory());
+  if (!data) {
     // Make sure we have a fallback model
     if (models.empty()) {
       std::cerr << "Failed loading fallback model at: " << path << '\n';
       std::abort();
     }
 
-    const auto &bounds = get(fallbackModel).getBounds();
-    return {fallbackModel, bounds.min, bounds.max};
+    return loadInfo(fallbackModel);
   }
 
-  const auto &newModel = models.emplace_back(scene, textureCache);
+  models.emplace_back(std::make_unique<ModelRenderInfo>(*data, textureCache));
   indexMap.emplace(path, models.size() - 1);
 
-  const auto bounds = newModel.getBounds();
-  return {models.size() - 1, bounds.min, bounds.max};
+  return loadInfo(models.size() - 1);
+}
+
+Model::ModelLoadInfo ModelCache::request(std::string_view path) {
+  auto absolutePath = basePath;
+  absolutePath.append(path);
+  auto existing = indexMap.find(absolutePath);
+  if (existing != indexMap.end())
+    return loadInfo(existing->second);
+
+  const model_id id = models.size();
+  models.emplace_back(nullptr);
+  indexMap.emplace(absolutePath, id);
+
+  // The pool is drained before `this` is destroyed, so the task may use it.
+  // `std::packaged_task` is move only, but `QThreadPool` requires a copyable callable
+  auto task = std::make_shared<std::packaged_task<std::optional<ModelData>()>>(
+      [this, absolutePath, textureDirectory = textureCache.getResourceDirectory()]() {
+        return read(absolutePath, textureDirectory);
+      });
+  pending.push_back({id, std::move(absolutePath), task->get_future()});
+  loaders.start([task]() { (*task)(); });
+
+  return loadInfo(id);
+}
+
+void ModelCache::prefetch(const std::string &path) {
+  request(path);
+}
+
+std::vector<Model::ModelLoadInfo> ModelCache::uploadLoaded() {
+  using namespace std::chrono_literals;
+
+  auto iter = pending.begin();
+  while (iter != pending.end()) {
+    if (iter->data.wait_for(0s) != std::future_status::ready) {
+      iter++;
+      continue;
+    }
+
+    finish(*iter);
+    iter = pending.erase(iter);
+  }
+
+  std::vector<Model::ModelLoadInfo> result;
+  result.reserve(uploaded.size());
+  for (const auto id : uploaded) {
+    result.emplace_back(loadInfo(id));
+  }
+  uploaded.clear();
+
+  return result;
+}
+
+bool ModelCache::isLoading() const {
+  return !pending.empty();
 }
 
 ModelRenderInfo &ModelCache::get(model_id index) {
-  return models[index];
+  const auto &model = models[index];
+  if (!model)
+    return *models[fallbackModel];
+
+  return *model;
 }
 
 model_id ModelCache::getFallbackModelId() const {
@@ -334,12 +558,15 @@ model_id ModelCache::getFallbackModelId() const {
 }
 
 void ModelCache::reset() {
+  // Drop the models not yet read
+  loaders.clear();
+  loaders.waitForDone();
+  pending.clear();
+  uploaded.clear();
+
   models.clear();
   indexMap.clear();
 
-  // Use a total clear instead of erasing a range
-  // since we'd need a move implementation for that.
-
   // Reload the fallback model
   fallbackModel = load(_fallbackModelPath).id;
 }
@@ -37,11 +37,17 @@
 #include "../texture/TextureCache.h"
 #include "../texture/texture.h"
 #include "Model.h"
+#include "ModelData.h"
+#include "ModelDiskCache.h"
+#include <QDir>
 #include <QOpenGLFunctions_3_3_Core>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
+#include <QThreadPool>
+#include <future>
 #include <glm/glm.hpp>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -64,13 +70,23 @@ private:
 
   void updateBounds();
 
-  void loadNode(aiNode const *node, aiScene const *scene);
-  void loadMesh(aiMesh const *m, aiScene const *scene);
-  void loadMaterials(aiScene const *scene);
+  void loadMesh(const ModelData::MeshData &m);
+  void loadMaterials(const ModelData &data);
 
 public:
   ~ModelRenderInfo() override;
-  ModelRenderInfo(aiScene const *scene, TextureCache &textureCache);
+
+  /**
+   * Upload `data` to the GPU.
+   * Must be called on the thread with the current OpenGL context
+   *
+   * @param data
+   * The model read by `ModelCache`
+   *
+   * @param textureCache
+   * The cache to load the model's textures into
+   */
+  ModelRenderInfo(const ModelData &data, TextureCache &textureCache);
   ModelRenderInfo(std::vector<Mesh> meshes, TextureCache &textureCache);
 
   // Allow Moves
@@ -93,28 +109,172 @@ public:
   void render(Shader &s, const Model &model);
   void render(Shader &s, const std::optional<glm::vec3> &baseColor, const std::optional<glm::vec3> &highlightColor);
   void renderTransparent(Shader &s, const Model &model);
+
+  /**
+   * Draw `count` copies of the opaque meshes,
+   * one draw call per mesh.
+   * The colors & model matrix of each copy come from `buffer`
+   *
+   * @param s
+   * The model shader, with `instanced` set
+   *
+   * @param buffer
+   * The buffer holding at least `count` `Mesh::Instance`s
+   *
+   * @param count
+   * The number of copies to draw
+   */
+  void renderInstanced(Shader &s, unsigned int buffer, int count);
   std::vector<Mesh> &getMeshes();
   std::vector<Mesh> &getTransparentMeshes();
   void clear();
 };
 
 class ModelCache : protected QOpenGLFunctions_3_3_Core {
+  /**
+   * A model being read on `loaders`
+   */
+  struct PendingModel {
+    model_id id;
+    std::string path;
+    std::future<std::optional<ModelData>> data;
+  };
+
   std::unordered_map<std::string, std::size_t> indexMap;
-  std::vector<ModelRenderInfo> models;
+
+  /**
+   * The uploaded models, by ID.
+   * Models which are still being read, or failed to read, are null
+   */
+  std::vector<std::unique_ptr<ModelRenderInfo>> models;
   TextureCache &textureCache;
   std::string basePath;
   std::string _fallbackModelPath;
   model_id fallbackModel = 0u;
 
+  /**
+   * Models already processed by Assimp, from earlier runs
+   */
+  ModelDiskCache diskCache;
+
+  /**
+   * Threads reading model files
+   */
+  QThreadPool loaders;
+  std::vector<PendingModel> pending;
+
+  /**
+   * IDs of the requested models uploaded since the last `uploadLoaded()` call
+   */
+  std::vector<model_id> uploaded;
+
+  /**
+   * Read the model file at `path`, from `diskCache` if possible,
+   * and decode its textures.
+   * Models imported by Assimp are added to `diskCache`. Thread safe
+   *
+   * @param path
+   * The absolute path to the model file
+   *
+   * @param textureDirectory
+   * The directory to search for the model's textures
+   *
+   * @return
+   * The model, or an unset optional if it could not be read
+   */
+  [[nodiscard]] std::optional<ModelData> read(const std::string &path, const QDir &textureDirectory) const;
+
+  /**
+   * Read the meshes & materials of the model file at `path`,
+   * without its textures. Thread safe
+   *
+   * @param path
+   * The absolute path to the model file
+   *
+   * @return
+   * The model, or an unset optional if it could not be read
+   */
+  [[nodiscard]] std::optional<ModelData> readModel(const std::string &path) const;
+
+  /**
+   * Upload the model read for `model`, once it is done,
+   * and point its path at the fallback model if it failed.
+   * Blocks until the model is read
+   *
+   * @param model
+   * The model to finish. Should be removed from `pending` afterwards
+   */
+  void finish(PendingModel &model);
+
+  /**
+   * Get the IDs & bounds of the model with `id`.
+   * Models which are not uploaded have the bounds of the fallback model
+   */
+  [[nodiscard]] Model::ModelLoadInfo loadInfo(model_id id) const;
+
 public:
   explicit ModelCache(TextureCache &textureCache);
-  ~ModelCache() override = default;
+  ~ModelCache() override;
 
   void setBasePath(std::string value);
   void init(std::string_view fallbackModelPath);
+
+  /**
+   * Read & upload the model at `path`, relative to the base path,
+   * before returning
+   *
+   * @param path
+   * The path to the model, relative to the base path
+   *
+   * @return
+   * The loaded model, or the fallback model if it could not be read
+   */
   Model::ModelLoadInfo load(const std::string &path);
   Model::ModelLoadInfo loadAbsolute(const std::string &path);
 
+  /**
+   * Start reading the model at `path` on another thread,
+   * if it was not already requested.
+   *
+   * The returned ID draws the fallback model until the model is
+   * uploaded by `uploadLoaded()`. Until then,
+   * the bounds returned are the fallback model's
+   *
+   * @param path
+   * The path to the model, relative to the base path
+   *
+   * @return
+   * The ID the model will have, with its bounds if it is already uploaded
+   */
+  Model::ModelLoadInfo request(std::string_view path);
+
+  /**
+   * Start reading the model at `path`, so it is ready
+   * by the time it is used.
+   * Equivalent to `request()`, ignoring the result
+   *
+   * @param path
+   * The path to the model, relative to the base path
+   */
+  void prefetch(const std::string &path);
+
+  /**
+   * Upload the requested models which have been read.
+   * Must be called on the thread with the current OpenGL context
+   *
+   * @return
+   * The ID & bounds of each model uploaded, so
+   * `Model`s built with the fallback bounds may be rebuilt
+   */
+  std::vector<Model::ModelLoadInfo> uploadLoaded();
+
+  /**
+   * @return
+   * True if any requested or prefetched models
+   * have not been uploaded by `uploadLoaded()` yet
+   */
+  [[nodiscard]] bool isLoading() const;
+
   ModelRenderInfo &get(model_id index);
   [[nodiscard]] model_id getFallbackModelId() const;
 
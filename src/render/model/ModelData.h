@@ -0,0 +1,84 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include "../material/material.h"
+#include "../mesh/Vertex.h"
+#include "../texture/TextureData.h"
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * A model read from disk, before anything is uploaded to the GPU.
+ * Contains no OpenGL objects, so it may be built on any thread
+ */
+struct ModelData {
+  struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int materialIndex{0u};
+  };
+
+  struct MaterialData {
+    /**
+     * The material, without its `textureId` set
+     */
+    Material material;
+
+    /**
+     * The file name of the diffuse texture, if the material has one
+     */
+    std::optional<std::string> texture;
+
+    /**
+     * Set if the material has a texture which could not be read,
+     * so the fallback texture should be used
+     */
+    bool useFallbackTexture{false};
+  };
+
+  std::vector<MaterialData> materials;
+  std::vector<MeshData> meshes;
+
+  /**
+   * The decoded textures of `materials`, by file name.
+   * Textures which could not be decoded are not included
+   */
+  std::unordered_map<std::string, TextureData> textures;
+};
+
+} // namespace netsimulyzer
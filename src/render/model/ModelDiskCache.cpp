@@ -0,0 +1,420 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "ModelDiskCache.h"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mapped-file.h>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+/**
+ * Change whenever the layout of the file,
+ * or the meaning of a record field changes
+ */
+const std::uint32_t cacheVersion = 1u;
+const std::array<char, 8> cacheMagic{'N', 'S', 'M', 'C', 'A', 'C', 'H', 'E'};
+
+/**
+ * A file read to import the model,
+ * and the state it was in when it was read
+ */
+struct SourceRecord {
+  std::uint64_t size;
+  std::int64_t modified;
+
+  /**
+   * The path, in the source path table
+   */
+  std::uint64_t offset;
+  std::uint64_t length;
+};
+static_assert(std::is_trivially_copyable_v<SourceRecord>);
+
+/**
+ * Flags for `MaterialRecord::flags`
+ */
+enum MaterialFlag : std::uint8_t { HasColor = 1u, HasTexture = 2u, FallbackTexture = 4u };
+
+struct MaterialRecord {
+  float specularIntensity;
+  float shininess;
+  float opacity;
+  std::array<float, 3> color;
+  std::uint8_t flags;
+  std::uint8_t materialType;
+  std::array<std::uint8_t, 2> padding;
+
+  /**
+   * The texture file name, in the string table
+   */
+  std::uint32_t textureLength;
+  std::uint64_t textureOffset;
+};
+static_assert(std::is_trivially_copyable_v<MaterialRecord>);
+static_assert(sizeof(MaterialRecord) == 40u);
+
+struct MeshRecord {
+  std::uint64_t vertexCount;
+  std::uint64_t indexCount;
+  std::uint32_t materialIndex;
+  std::uint32_t padding;
+};
+static_assert(std::is_trivially_copyable_v<MeshRecord>);
+
+/**
+ * Layout:
+ * Header, SourceRecord[sourceCount], MaterialRecord[materialCount], MeshRecord[meshCount],
+ * Vertex[vertexCount], uint32_t[indexCount], char[sourceBytes], char[stringBytes]
+ *
+ * The vertices & indices of each mesh follow those of the previous mesh
+ */
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t vertexSize;
+  std::uint32_t importFlags;
+  std::uint32_t padding;
+  std::uint64_t sourceCount;
+  std::uint64_t materialCount;
+  std::uint64_t meshCount;
+  std::uint64_t vertexCount;
+  std::uint64_t indexCount;
+  std::uint64_t sourceBytes;
+  std::uint64_t stringBytes;
+};
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<netsimulyzer::Vertex>);
+static_assert(sizeof(unsigned int) == sizeof(std::uint32_t));
+
+/**
+ * FNV-1a, since the result must be the same between runs
+ */
+std::uint64_t hashPath(std::string_view path) {
+  std::uint64_t hash = 0xCBF29CE484222325ULL;
+  for (const auto c : path) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001B3ULL;
+  }
+
+  return hash;
+}
+
+/**
+ * Get the size & modification time of the file at `path`
+ *
+ * @return
+ * The stamp for the file, with its path unset,
+ * or an empty optional if the file could not be read
+ */
+std::optional<SourceRecord> stamp(const std::string &path) {
+  std::error_code error;
+  const auto size = std::filesystem::file_size(path, error);
+  if (error)
+    return {};
+
+  const auto modified = std::filesystem::last_write_time(path, error);
+  if (error)
+    return {};
+
+  return SourceRecord{size, static_cast<std::int64_t>(modified.time_since_epoch().count()), 0u, 0u};
+}
+
+template <typename T>
+void writeRaw(std::ofstream &out, const T *values, std::size_t count) {
+  out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+namespace netsimulyzer {
+
+ModelDiskCache::ModelDiskCache(std::filesystem::path directory) : directory(std::move(directory)) {
+}
+
+bool ModelDiskCache::enabled() const {
+  return !directory.empty();
+}
+
+std::filesystem::path ModelDiskCache::entryPath(const std::string &modelPath) const {
+  std::array<char, 17> name{};
+  std::snprintf(name.data(), name.size(), "%016llx", static_cast<unsigned long long>(hashPath(modelPath)));
+
+  return directory / (std::string{name.data()} + ".nsm");
+}
+
+std::optional<ModelData> ModelDiskCache::read(const std::string &modelPath, unsigned int importFlags) const {
+  if (directory.empty())
+    return {};
+
+  const auto path = entryPath(modelPath).string();
+  parser::MappedFile file{path.c_str()};
+  if (!file.isOpen() || file.size() < sizeof(Header))
+    return {};
+
+  Header header;
+  std::memcpy(&header, file.data(), sizeof(Header));
+
+  if (header.magic != cacheMagic || header.version != cacheVersion || header.vertexSize != sizeof(Vertex) ||
+      header.importFlags != importFlags || header.sourceCount == 0u)
+    return {};
+
+  // Make sure every section fits in the file before reading
+  const std::array<std::pair<std::uint64_t, std::uint64_t>, 7> sections{
+      std::pair{header.sourceCount, sizeof(SourceRecord)},  std::pair{header.materialCount, sizeof(MaterialRecord)},
+      std::pair{header.meshCount, sizeof(MeshRecord)},      std::pair{header.vertexCount, sizeof(Vertex)},
+      std::pair{header.indexCount, sizeof(std::uint32_t)}, std::pair{header.sourceBytes, std::uint64_t{1u}},
+      std::pair{header.stringBytes, std::uint64_t{1u}}};
+
+  std::uint64_t expectedSize = sizeof(Header);
+  for (const auto &[count, elementSize] : sections) {
+    if (count > (file.size() - expectedSize) / elementSize)
+      return {};
+    expectedSize += count * elementSize;
+  }
+
+  if (expectedSize != file.size())
+    return {};
+
+  const auto sources = file.data() + sizeof(Header);
+  const auto materials = sources + header.sourceCount * sizeof(SourceRecord);
+  const auto meshes = materials + header.materialCount * sizeof(MaterialRecord);
+  const auto vertices = meshes + header.meshCount * sizeof(MeshRecord);
+  const auto indices = vertices + header.vertexCount * sizeof(Vertex);
+  const auto sourcePaths = indices + header.indexCount * sizeof(std::uint32_t);
+  const auto strings = sourcePaths + header.sourceBytes;
+
+  // Every file the model was imported from must be unchanged.
+  // The first is the model itself, which guards against two paths sharing an entry
+  for (std::uint64_t i = 0u; i < header.sourceCount; i++) {
+    SourceRecord record;
+    std::memcpy(&record, sources + i * sizeof(SourceRecord), sizeof(SourceRecord));
+    if (record.offset > header.sourceBytes || record.length > header.sourceBytes - record.offset)
+      return {};
+
+    const std::string sourcePath{sourcePaths + record.offset, record.length};
+    if (i == 0u && sourcePath != modelPath)
+      return {};
+
+    const auto current = stamp(sourcePath);
+    if (!current || current->size != record.size || current->modified != record.modified)
+      return {};
+  }
+
+  ModelData data;
+  data.materials.reserve(header.materialCount);
+  for (std::uint64_t i = 0u; i < header.materialCount; i++) {
+    MaterialRecord record;
+    std::memcpy(&record, materials + i * sizeof(MaterialRecord), sizeof(MaterialRecord));
+
+    if (record.materialType > static_cast<std::uint8_t>(Material::MaterialType::Highlight))
+      return {};
+
+    auto &material = data.materials.emplace_back();
+    auto &m = material.material;
+    m.specularIntensity = record.specularIntensity;
+    m.shininess = record.shininess;
+    m.opacity = record.opacity;
+    m.materialType = static_cast<Material::MaterialType>(record.materialType);
+
+    if (record.flags & HasColor)
+      m.color = {record.color[0], record.color[1], record.color[2]};
+
+    if (record.flags & HasTexture) {
+      if (record.textureOffset > header.stringBytes || record.textureLength > header.stringBytes - record.textureOffset)
+        return {};
+      material.texture = std::string{strings + record.textureOffset, record.textureLength};
+    }
+
+    material.useFallbackTexture = record.flags & FallbackTexture;
+  }
+
+  std::uint64_t vertexOffset = 0u;
+  std::uint64_t indexOffset = 0u;
+  data.meshes.reserve(header.meshCount);
+  for (std::uint64_t i = 0u; i < header.meshCount; i++) {
+    MeshRecord record;
+    std::memcpy(&record, meshes + i * sizeof(MeshRecord), sizeof(MeshRecord));
+
+    if (record.materialIndex >= header.materialCount || record.vertexCount > header.vertexCount - vertexOffset ||
+        record.indexCount > header.indexCount - indexOffset)
+      return {};
+
+    auto &mesh = data.meshes.emplace_back();
+    mesh.materialIndex = record.materialIndex;
+
+    mesh.vertices.resize(record.vertexCount);
+    std::memcpy(mesh.vertices.data(), vertices + vertexOffset * sizeof(Vertex), record.vertexCount * sizeof(Vertex));
+
+    mesh.indices.resize(record.indexCount);
+    std::memcpy(mesh.indices.data(), indices + indexOffset * sizeof(std::uint32_t),
+                record.indexCount * sizeof(std::uint32_t));
+
+    // Indices are handed directly to the GPU, so never let a bad one through
+    for (const auto index : mesh.indices) {
+      if (index >= record.vertexCount) {
+        std::cerr << "Ignoring corrupt model cache: " << path << '\n';
+        return {};
+      }
+    }
+
+    vertexOffset += record.vertexCount;
+    indexOffset += record.indexCount;
+  }
+
+  if (vertexOffset != header.vertexCount || indexOffset != header.indexCount)
+    return {};
+
+  return data;
+}
+
+bool ModelDiskCache::write(const std::string &modelPath, unsigned int importFlags,
+                           const std::vector<std::string> &sources, const ModelData &data) const {
+  if (directory.empty() || sources.empty() || sources.front() != modelPath)
+    return false;
+
+  std::vector<SourceRecord> sourceRecords;
+  sourceRecords.reserve(sources.size());
+  std::string sourceBytes;
+  for (const auto &source : sources) {
+    auto record = stamp(source);
+    if (!record)
+      return false;
+
+    record->offset = sourceBytes.size();
+    record->length = source.size();
+    sourceBytes.append(source);
+    sourceRecords.emplace_back(record.value());
+  }
+
+  std::vector<MaterialRecord> materialRecords;
+  materialRecords.reserve(data.materials.size());
+  std::string stringBytes;
+  for (const auto &material : data.materials) {
+    const auto &m = material.material;
+    MaterialRecord record{};
+    record.specularIntensity = m.specularIntensity;
+    record.shininess = m.shininess;
+    record.opacity = m.opacity;
+    record.materialType = static_cast<std::uint8_t>(m.materialType);
+
+    if (m.color) {
+      record.flags |= HasColor;
+      record.color = {m.color->x, m.color->y, m.color->z};
+    }
+
+    if (material.texture) {
+      record.flags |= HasTexture;
+      record.textureOffset = stringBytes.size();
+      record.textureLength = static_cast<std::uint32_t>(material.texture->size());
+      stringBytes.append(material.texture.value());
+    }
+
+    if (material.useFallbackTexture)
+      record.flags |= FallbackTexture;
+
+    materialRecords.emplace_back(record);
+  }
+
+  std::vector<MeshRecord> meshRecords;
+  meshRecords.reserve(data.meshes.size());
+  std::uint64_t vertexCount = 0u;
+  std::uint64_t indexCount = 0u;
+  for (const auto &mesh : data.meshes) {
+    meshRecords.emplace_back(MeshRecord{mesh.vertices.size(), mesh.indices.size(), mesh.materialIndex, 0u});
+    vertexCount += mesh.vertices.size();
+    indexCount += mesh.indices.size();
+  }
+
+  Header header{};
+  header.magic = cacheMagic;
+  header.version = cacheVersion;
+  header.vertexSize = sizeof(Vertex);
+  header.importFlags = importFlags;
+  header.sourceCount = sourceRecords.size();
+  header.materialCount = materialRecords.size();
+  header.meshCount = meshRecords.size();
+  header.vertexCount = vertexCount;
+  header.indexCount = indexCount;
+  header.sourceBytes = sourceBytes.size();
+  header.stringBytes = stringBytes.size();
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if (error)
+    return false;
+
+  const auto path = entryPath(modelPath);
+  auto temporaryPath = path;
+  temporaryPath += ".tmp";
+  {
+    std::ofstream out{temporaryPath, std::ios::binary | std::ios::trunc};
+    if (!out)
+      return false;
+
+    writeRaw(out, &header, 1u);
+    writeRaw(out, sourceRecords.data(), sourceRecords.size());
+    writeRaw(out, materialRecords.data(), materialRecords.size());
+    writeRaw(out, meshRecords.data(), meshRecords.size());
+    for (const auto &mesh : data.meshes)
+      writeRaw(out, mesh.vertices.data(), mesh.vertices.size());
+    for (const auto &mesh : data.meshes)
+      writeRaw(out, mesh.indices.data(), mesh.indices.size());
+    writeRaw(out, sourceBytes.data(), sourceBytes.size());
+    writeRaw(out, stringBytes.data(), stringBytes.size());
+
+    if (!out.flush()) {
+      out.close();
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace netsimulyzer
@@ -0,0 +1,120 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include "ModelData.h"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * On disk cache of models after they were processed by Assimp,
+ * so later loads may skip importing them.
+ *
+ * Each model is kept in its own file, named for the model's path.
+ * An entry is only used if every file read to import the model
+ * (e.g. an OBJ file and its materials) is unchanged since it was written,
+ * and it was imported with the same flags
+ */
+class ModelDiskCache {
+  /**
+   * Where entries are kept. Empty if the cache is disabled
+   */
+  std::filesystem::path directory;
+
+  /**
+   * Get the path of the entry for `modelPath`
+   *
+   * @param modelPath
+   * The absolute path to the model file
+   */
+  [[nodiscard]] std::filesystem::path entryPath(const std::string &modelPath) const;
+
+public:
+  /**
+   * @param directory
+   * Where to keep entries. Created on the first write.
+   * An empty path disables the cache
+   */
+  explicit ModelDiskCache(std::filesystem::path directory);
+
+  /**
+   * @return
+   * True if entries are read & written, False otherwise
+   */
+  [[nodiscard]] bool enabled() const;
+
+  /**
+   * Read the cached model for `modelPath`. Thread safe
+   *
+   * @param modelPath
+   * The absolute path to the model file
+   *
+   * @param importFlags
+   * The Assimp post processing flags the model would be imported with
+   *
+   * @return
+   * The cached model, or an empty optional if there is no entry,
+   * or it is from another version, or out of date
+   */
+  [[nodiscard]] std::optional<ModelData> read(const std::string &modelPath, unsigned int importFlags) const;
+
+  /**
+   * Write the entry for an imported model.
+   * Written to a temporary file first, so a failed write
+   * never leaves a partial entry behind. Thread safe,
+   * so long as no two threads write the same model
+   *
+   * @param modelPath
+   * The absolute path to the model file
+   *
+   * @param importFlags
+   * The Assimp post processing flags the model was imported with
+   *
+   * @param sources
+   * Every file read to import the model, including `modelPath`
+   *
+   * @param data
+   * The imported model
+   *
+   * @return
+   * True if the entry was written, False otherwise
+   */
+  bool write(const std::string &modelPath, unsigned int importFlags, const std::vector<std::string> &sources,
+             const ModelData &data) const;
+};
+
+} // namespace netsimulyzer
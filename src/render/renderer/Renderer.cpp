@@ -38,8 +38,10 @@
 #include <QMessageBox>
 #include <QString>
 #include <QTextStream>
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
@@ -68,6 +70,61 @@ Renderer::Renderer(ModelCache &modelCache, TextureCache &textureCache, FontManag
     : modelCache(modelCache), textureCache(textureCache), fontManager(fontManager) {
 }
 
+void Renderer::upload(StaticBatch &batch) {
+  auto &info = batch.renderInfo;
+  if (info.vao == 0u) {
+    glGenVertexArrays(1, &info.vao);
+    glBindVertexArray(info.vao);
+
+    glGenBuffers(1, &info.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, info.vbo);
+
+    // The index buffer is part of the VAO state,
+    // so binding the VAO is enough to draw
+    glGenBuffers(1, &info.ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, info.ibo);
+
+    // Location
+    glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, sizeof(StaticBatch::Vertex),
+                          reinterpret_cast<void *>(offsetof(StaticBatch::Vertex, position)));
+    glEnableVertexAttribArray(0u);
+
+    // Color
+    glVertexAttribPointer(1u, 3, GL_FLOAT, GL_FALSE, sizeof(StaticBatch::Vertex),
+                          reinterpret_cast<void *>(offsetof(StaticBatch::Vertex, color)));
+    glEnableVertexAttribArray(1u);
+  } else {
+    glBindVertexArray(info.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, info.vbo);
+  }
+
+  // The buffers are reused between scenarios,
+  // so respecify them entirely
+  const auto &vertices = batch.getVertices();
+  glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(StaticBatch::Vertex) * vertices.size()),
+               vertices.data(), GL_STATIC_DRAW);
+
+  const auto &indices = batch.getIndices();
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(unsigned int) * indices.size()),
+               indices.data(), GL_STATIC_DRAW);
+
+  batch.uploaded();
+}
+
+void Renderer::render(StaticBatch &batch, GLenum mode) {
+  if (batch.isDirty())
+    upload(batch);
+
+  const auto &counts = batch.getDrawCounts();
+  if (counts.empty())
+    return;
+
+  glBindVertexArray(batch.renderInfo.vao);
+  glMultiDrawElements(mode, counts.data(), GL_UNSIGNED_INT, batch.getDrawOffsets().data(),
+                      static_cast<GLsizei>(counts.size()));
+  batch.clearQueue();
+}
+
 void Renderer::init() {
   initializeOpenGLFunctions();
 
@@ -79,10 +136,33 @@ void Renderer::init() {
   gridShader.uniform("height", -0.001f);
 
   initShader(modelShader, ":shader/shaders/model.vert", ":shader/shaders/model.frag");
+  glGenBuffers(1, &nodeInstanceVbo);
+  glBindBuffer(GL_ARRAY_BUFFER, nodeInstanceVbo);
+  // Meshes drawn instanced read one instance from here
+  // during regular draws too, so never leave this empty
+  glBufferData(GL_ARRAY_BUFFER, sizeof(Mesh::Instance), nullptr, GL_STREAM_DRAW);
   initShader(skyBoxShader, ":shader/shaders/skybox.vert", ":shader/shaders/skybox.frag");
   initShader(pickingShader, ":/shader/shaders/picking.vert", ":/shader/shaders/picking.frag");
+
+  // Both label shaders expand the same quads,
+  // only how they are colored differs
   initShader(fontShader, ":/shader/shaders/font.vert", ":/shader/shaders/font.frag");
-  initShader(fontBackgroundShader, ":/shader/shaders/font_bg.vert", ":/shader/shaders/font_bg.frag");
+  fontShader.uniform("depth_offset", 0.0f);
+  initShader(fontBackgroundShader, ":/shader/shaders/font.vert", ":/shader/shaders/font_bg.frag");
+  // Push backgrounds slightly behind the glyphs
+  fontBackgroundShader.uniform("depth_offset", -0.01f);
+
+  glGenVertexArrays(1, &labelVao);
+  glBindVertexArray(labelVao);
+  glGenBuffers(1, &labelVbo);
+  glBindBuffer(GL_ARRAY_BUFFER, labelVbo);
+
+  // One quad per instance, the corners come from `gl_VertexID`
+  for (auto i = 0u; i < 3u; i++) {
+    glEnableVertexAttribArray(i);
+    glVertexAttribDivisor(i, 1u);
+  }
+  glBindVertexArray(0u);
 }
 
 void Renderer::setPerspective(const glm::mat4 &perspective) {
@@ -120,7 +200,8 @@ TrailBuffer Renderer::allocateTrailBuffer(QOpenGLFunctions_3_3_Core *openGl, int
   unsigned int vbo;
   openGl->glGenBuffers(1, &vbo);
   openGl->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  openGl->glBufferData(GL_ARRAY_BUFFER, vertexSize * size, nullptr, GL_DYNAMIC_DRAW);
+  // One extra vertex for the copy of the first point, see `TrailBuffer::bufferSize`
+  openGl->glBufferData(GL_ARRAY_BUFFER, vertexSize * (size + 1), nullptr, GL_DYNAMIC_DRAW);
 
   // Location
   openGl->glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, nullptr);
@@ -135,17 +216,18 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
 
   auto min = toRenderCoordinate(building.min);
   auto max = toRenderCoordinate(building.max);
+  const auto color = toRenderColor(building.color);
 
   // clang-format off
-  std::vector<float> vertices{
-      min.x, min.y, min.z, // 0
-      max.x, min.y, min.z, // 1
-      max.x, min.y, max.z, // 2
-      min.x, min.y, max.z, // 3
-      min.x, max.y, min.z, // 4
-      max.x, max.y, min.z, // 5
-      max.x, max.y, max.z, // 6
-      min.x, max.y, max.z  // 7
+  std::vector<StaticBatch::Vertex> vertices{
+      {{min.x, min.y, min.z}, color}, // 0
+      {{max.x, min.y, min.z}, color}, // 1
+      {{max.x, min.y, max.z}, color}, // 2
+      {{min.x, min.y, max.z}, color}, // 3
+      {{min.x, max.y, min.z}, color}, // 4
+      {{max.x, max.y, min.z}, color}, // 5
+      {{max.x, max.y, max.z}, color}, // 6
+      {{min.x, max.y, max.z}, color}  // 7
   };
   std::vector<unsigned int> indices{
       0u, 1u, 2u,
@@ -165,9 +247,6 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
 
   auto last_index = 7u;
 
-  glGenVertexArrays(1, &info.vao);
-  glBindVertexArray(info.vao);
-
   // Floors
   //   All floors are exactly the same height
   //   abs() just in case our coordinates are negative
@@ -175,10 +254,10 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
   for (auto currentFloor = 1; currentFloor < building.floors; currentFloor++) {
     const auto currentHeight = floor_height * currentFloor + min.y;
 
-    vertices.insert(vertices.end(), {min.x, currentHeight, min.z});
-    vertices.insert(vertices.end(), {max.x, currentHeight, min.z});
-    vertices.insert(vertices.end(), {max.x, currentHeight, max.z});
-    vertices.insert(vertices.end(), {min.x, currentHeight, max.z});
+    vertices.push_back({{min.x, currentHeight, min.z}, color});
+    vertices.push_back({{max.x, currentHeight, min.z}, color});
+    vertices.push_back({{max.x, currentHeight, max.z}, color});
+    vertices.push_back({{min.x, currentHeight, max.z}, color});
 
     // 0, 1, 2, 3, 0, 2
     indices.insert(indices.end(),
@@ -195,10 +274,10 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
   for (auto currentRoom = 1; currentRoom < building.roomsX; currentRoom++) {
     auto currentWallPosition = roomLengthX * currentRoom + min.x;
 
-    vertices.insert(vertices.end(), {currentWallPosition, min.y, min.z});
-    vertices.insert(vertices.end(), {currentWallPosition, max.y, min.z});
-    vertices.insert(vertices.end(), {currentWallPosition, max.y, max.z});
-    vertices.insert(vertices.end(), {currentWallPosition, min.y, max.z});
+    vertices.push_back({{currentWallPosition, min.y, min.z}, color});
+    vertices.push_back({{currentWallPosition, max.y, min.z}, color});
+    vertices.push_back({{currentWallPosition, max.y, max.z}, color});
+    vertices.push_back({{currentWallPosition, min.y, max.z}, color});
 
     // 0, 1, 2, 3, 0, 2
     indices.insert(indices.end(),
@@ -212,10 +291,10 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
   for (auto currentRoom = 1; currentRoom < building.roomsY; currentRoom++) {
     auto currentWallPosition = roomLengthY * currentRoom + min.z;
 
-    vertices.insert(vertices.end(), {min.x, min.y, currentWallPosition});
-    vertices.insert(vertices.end(), {max.x, min.y, currentWallPosition});
-    vertices.insert(vertices.end(), {max.x, max.y, currentWallPosition});
-    vertices.insert(vertices.end(), {min.x, max.y, currentWallPosition});
+    vertices.push_back({{min.x, min.y, currentWallPosition}, color});
+    vertices.push_back({{max.x, min.y, currentWallPosition}, color});
+    vertices.push_back({{max.x, max.y, currentWallPosition}, color});
+    vertices.push_back({{min.x, max.y, currentWallPosition}, color});
 
     // 0, 1, 2, 3, 0, 2
     indices.insert(indices.end(),
@@ -223,19 +302,7 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
     last_index += 4;
   }
 
-  info.ibo_size = indices.size();
-
-  glGenBuffers(1, &info.ibo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, info.ibo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_STATIC_DRAW);
-
-  glGenBuffers(1, &info.vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, info.vbo);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-  // Location
-  glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, nullptr);
-  glEnableVertexAttribArray(0u);
+  info.faces = buildingBatch.add(vertices, indices);
 
   // Border Lines
 
@@ -244,18 +311,22 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
   // intersect the walls
   const float offset = 0.01f;
 
+  // Outlines are drawn with a single color for every building,
+  // so the vertex color is unused
+  const glm::vec3 lineColor{0.0f};
+
   // clang-format off
-  const std::array<float, 24> borderVertices {
-      min.x - offset, min.y - offset, min.z - offset, // 0
-      max.x + offset, min.y - offset, min.z - offset, // 1
-      max.x + offset, min.y - offset, max.z + offset, // 2
-      min.x - offset, min.y - offset, max.z + offset, // 3
-      min.x - offset, max.y + offset, min.z - offset, // 4
-      max.x + offset, max.y + offset, min.z - offset, // 5
-      max.x + offset, max.y + offset, max.z + offset, // 6
-      min.x - offset, max.y + offset, max.z + offset  // 7
+  const std::vector<StaticBatch::Vertex> borderVertices {
+      {{min.x - offset, min.y - offset, min.z - offset}, lineColor}, // 0
+      {{max.x + offset, min.y - offset, min.z - offset}, lineColor}, // 1
+      {{max.x + offset, min.y - offset, max.z + offset}, lineColor}, // 2
+      {{min.x - offset, min.y - offset, max.z + offset}, lineColor}, // 3
+      {{min.x - offset, max.y + offset, min.z - offset}, lineColor}, // 4
+      {{max.x + offset, max.y + offset, min.z - offset}, lineColor}, // 5
+      {{max.x + offset, max.y + offset, max.z + offset}, lineColor}, // 6
+      {{min.x - offset, max.y + offset, max.z + offset}, lineColor}  // 7
   };
-  const std::array<unsigned int, 24> lineIndices {
+  const std::vector<unsigned int> lineIndices {
       0u, 1u, // Bottom
       1u, 2u,
       2u, 3u,
@@ -271,22 +342,7 @@ Building::RenderInfo Renderer::allocate(const parser::Building &building) {
   };
   // clang-format on
 
-  glGenVertexArrays(1, &info.lineVao);
-  glBindVertexArray(info.lineVao);
-
-  info.lineIboSize = lineIndices.size();
-
-  glGenBuffers(1, &info.lineIbo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, info.lineIbo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * lineIndices.size(), lineIndices.data(), GL_STATIC_DRAW);
-
-  glGenBuffers(1, &info.lineVbo);
-  glBindBuffer(GL_ARRAY_BUFFER, info.lineVbo);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * borderVertices.size(), borderVertices.data(), GL_STATIC_DRAW);
-
-  // Location
-  glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, nullptr);
-  glEnableVertexAttribArray(0u);
+  info.outline = buildingOutlineBatch.add(borderVertices, lineIndices);
 
   return info;
 }
@@ -296,99 +352,93 @@ Area::RenderInfo Renderer::allocate(const parser::Area &area) {
 
   // Convert to OpenGl coordinates
   // for easier reading later
-  // Also handle the fill
   std::vector<glm::vec3> convertedPoints;
   convertedPoints.reserve(area.points.size());
   for (const auto &point : area.points) {
-    auto converted = toRenderCoordinate(point);
-    convertedPoints.emplace_back(converted);
-
-    // Handle the fill vertexes
-    // since we're already looping through all the points
+    convertedPoints.emplace_back(toRenderCoordinate(point));
   }
 
   using DrawMode = parser::Area::DrawMode;
 
-  // Fill
-  info.renderFill = area.fillMode == DrawMode::Solid;
-  if (info.renderFill) {
-    std::vector<float> fillVertices;
-    fillVertices.reserve(area.points.size() * 3uL);
+  // The fill & border are both put in the area batch,
+  // so the whole area is one range.
+  // Since the batch is drawn as triangles,
+  // the fan & strip these used to be drawn as
+  // are split into separate triangles here
+  std::vector<StaticBatch::Vertex> vertices;
+  std::vector<unsigned int> indices;
 
+  // Fill
+  if (area.fillMode == DrawMode::Solid) {
+    const auto fillColor = toRenderColor(area.fillColor);
+    vertices.reserve(convertedPoints.size());
     for (const auto &point : convertedPoints) {
-      // It's easiest to pass a flat array of floats
-      // with only one vertex attribute
-      // (Location in this case)
-      fillVertices.insert(fillVertices.end(), {point.x, point.y, point.z});
+      vertices.push_back({point, fillColor});
     }
 
-    glGenVertexArrays(1, &info.fillVao);
-    glBindVertexArray(info.fillVao);
-
-    // Size is in number of three component vertices
-    // not raw number of floats
-    // so the ns-3 or converted point count would work
-    info.fillVbo_size = area.points.size();
-
-    glGenBuffers(1, &info.fillVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, info.fillVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * fillVertices.size(), fillVertices.data(), GL_STATIC_DRAW);
-
-    // Location Attribute
-    glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, nullptr);
-    glEnableVertexAttribArray(0u);
+    // Fan around the first point
+    for (auto i = 1u; i + 1u < convertedPoints.size(); i++) {
+      indices.insert(indices.end(), {0u, i, i + 1u});
+    }
   }
 
   // Border
-  info.renderBorder = area.borderMode == DrawMode::Solid;
-  if (info.renderBorder) {
+  if (area.borderMode == DrawMode::Solid) {
     const auto borderWidth = 0.5f; // TODO: Make configurable?
+    const auto borderColor = toRenderColor(area.borderColor);
 
     // TODO: Filled Corners?
-    float borderPoints[] = {
+    // clang-format off
+    const std::array<glm::vec3, 14> borderPoints{
         // Top Left
-        convertedPoints[0].x, convertedPoints[0].y, convertedPoints[0].z,               // 0
-        convertedPoints[0].x - borderWidth, convertedPoints[0].y, convertedPoints[0].z, // 1
+        convertedPoints[0],                                       // 0
+        convertedPoints[0] + glm::vec3{-borderWidth, 0.0f, 0.0f}, // 1
 
         // Bottom Left
-        convertedPoints[1].x, convertedPoints[1].y, convertedPoints[1].z,               // 2
-        convertedPoints[1].x - borderWidth, convertedPoints[1].y, convertedPoints[1].z, // 3
-        convertedPoints[1].x, convertedPoints[1].y, convertedPoints[1].z + borderWidth, // 4
+        convertedPoints[1],                                       // 2
+        convertedPoints[1] + glm::vec3{-borderWidth, 0.0f, 0.0f}, // 3
+        convertedPoints[1] + glm::vec3{0.0f, 0.0f, borderWidth},  // 4
 
         // Bottom Right
-        convertedPoints[2].x, convertedPoints[2].y, convertedPoints[2].z,               // 5
-        convertedPoints[2].x, convertedPoints[2].y, convertedPoints[2].z + borderWidth, // 6
-        convertedPoints[2].x + borderWidth, convertedPoints[2].y, convertedPoints[2].z, // 7
+        convertedPoints[2],                                       // 5
+        convertedPoints[2] + glm::vec3{0.0f, 0.0f, borderWidth},  // 6
+        convertedPoints[2] + glm::vec3{borderWidth, 0.0f, 0.0f},  // 7
 
         // Top Right
-        convertedPoints[3].x, convertedPoints[3].y, convertedPoints[3].z,               // 8
-        convertedPoints[3].x + borderWidth, convertedPoints[3].y, convertedPoints[3].z, // 9
-        convertedPoints[3].x, convertedPoints[3].y, convertedPoints[3].z - borderWidth, // 10
+        convertedPoints[3],                                       // 8
+        convertedPoints[3] + glm::vec3{borderWidth, 0.0f, 0.0f},  // 9
+        convertedPoints[3] + glm::vec3{0.0f, 0.0f, -borderWidth}, // 10
 
         // Top Left (Again)
-        convertedPoints[0].x, convertedPoints[0].y, convertedPoints[0].z,               // 11 (same as 0)
-        convertedPoints[0].x, convertedPoints[0].y, convertedPoints[0].z - borderWidth, // 12
-        convertedPoints[0].x - borderWidth, convertedPoints[0].y, convertedPoints[0].z, // 13 (same as 1)
+        convertedPoints[0],                                       // 11 (same as 0)
+        convertedPoints[0] + glm::vec3{0.0f, 0.0f, -borderWidth}, // 12
+        convertedPoints[0] + glm::vec3{-borderWidth, 0.0f, 0.0f}, // 13 (same as 1)
     };
+    // clang-format on
 
-    info.borderVbo_size = 14u;
-    info.borderColor = toRenderColor(area.borderColor);
-
-    glGenVertexArrays(1, &info.borderVao);
-    glBindVertexArray(info.borderVao);
-
-    glGenBuffers(1, &info.borderVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, info.borderVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(borderPoints), borderPoints, GL_STATIC_DRAW);
+    const auto first = static_cast<unsigned int>(vertices.size());
+    for (const auto &point : borderPoints) {
+      vertices.push_back({point, borderColor});
+    }
 
-    // Location
-    glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, nullptr);
-    glEnableVertexAttribArray(0u);
+    // Each triangle of the strip is the next point,
+    // and the two before it
+    for (auto i = first + 2u; i < vertices.size(); i++) {
+      indices.insert(indices.end(), {i - 2u, i - 1u, i});
+    }
   }
 
+  info.range = areaBatch.add(vertices, indices);
+
   return info;
 }
 
+void Renderer::resetStaticGeometry() {
+  buildingBatch.clear();
+  buildingOutlineBatch.clear();
+  areaBatch.clear();
+}
+
 WiredLink::RenderInfo Renderer::allocate(const parser::WiredLink &link) {
   WiredLink::RenderInfo info;
 
@@ -563,7 +613,9 @@ void Renderer::use(const Camera &cam) {
   cameraRotateInverse = glm::inverse(glm::mat3x3(cam.view_matrix()));
 
   fontShader.uniform("view", cam.view_matrix());
+  fontShader.uniform("billboard", cameraRotateInverse);
   fontBackgroundShader.uniform("view", cam.view_matrix());
+  fontBackgroundShader.uniform("billboard", cameraRotateInverse);
 }
 
 void Renderer::use(const ArcCamera &cam) {
@@ -589,7 +641,9 @@ void Renderer::use(const ArcCamera &cam) {
   cameraRotateInverse = glm::inverse(glm::mat3x3(cam.viewMatrix()));
 
   fontShader.uniform("view", cam.viewMatrix());
+  fontShader.uniform("billboard", cameraRotateInverse);
   fontBackgroundShader.uniform("view", cam.viewMatrix());
+  fontBackgroundShader.uniform("billboard", cameraRotateInverse);
 }
 
 void Renderer::render(const DirectionalLight &light) {
@@ -627,51 +681,38 @@ void Renderer::render(const SpotLight &light) {
   modelShader.uniform(light.prefix + "edge", light.processedEdge);
 }
 
-void Renderer::render(const std::vector<Area> &areas) {
-  areaShader.bind();
-
-  for (const auto &area : areas) {
-    const auto &renderInfo = area.getRenderInfo();
-    if (renderInfo.renderFill) {
-      areaShader.uniform("color", renderInfo.fillColor);
-      glBindVertexArray(renderInfo.fillVao);
-      glDrawArrays(GL_TRIANGLE_FAN, 0, renderInfo.fillVbo_size);
-    }
-
-    if (renderInfo.renderBorder) {
-      areaShader.uniform("color", renderInfo.borderColor);
-      glBindVertexArray(renderInfo.borderVao);
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, renderInfo.borderVbo_size);
-    }
+void Renderer::render(const std::vector<const Area *> &areas) {
+  for (const auto area : areas) {
+    areaBatch.queue(area->getRenderInfo().range);
   }
+
+  areaShader.bind();
+  render(areaBatch, GL_TRIANGLES);
 }
 
-void Renderer::render(const std::vector<Building> &buildings) {
-  buildingShader.bind();
-  for (const auto &building : buildings) {
-    if (!building.visible())
+void Renderer::render(const std::vector<const Building *> &buildings) {
+  for (const auto building : buildings) {
+    if (!building->visible())
       continue;
-    const auto &renderInfo = building.getRenderInfo();
-    buildingShader.uniform("color", building.getColor());
-
-    glBindVertexArray(renderInfo.vao);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderInfo.ibo);
-    glDrawElements(GL_TRIANGLES, renderInfo.ibo_size, GL_UNSIGNED_INT, nullptr);
+    buildingBatch.queue(building->getRenderInfo().faces);
   }
-}
 
-void Renderer::renderOutlines(const std::vector<Building> &buildings, const glm::vec3 &color) {
   buildingShader.bind();
-  for (const auto &building : buildings) {
-    if (!building.visible())
-      continue;
-    const auto &renderInfo = building.getRenderInfo();
+  buildingShader.uniform("useVertexColor", true);
+  render(buildingBatch, GL_TRIANGLES);
+  buildingShader.uniform("useVertexColor", false);
+}
 
-    glBindVertexArray(renderInfo.lineVao);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderInfo.lineIbo);
-    buildingShader.uniform("color", color);
-    glDrawElements(GL_LINES, renderInfo.lineIboSize, GL_UNSIGNED_INT, nullptr);
+void Renderer::renderOutlines(const std::vector<const Building *> &buildings, const glm::vec3 &color) {
+  for (const auto building : buildings) {
+    if (!building->visible())
+      continue;
+    buildingOutlineBatch.queue(building->getRenderInfo().outline);
   }
+
+  buildingShader.bind();
+  buildingShader.uniform("color", color);
+  render(buildingOutlineBatch, GL_LINES);
 }
 
 void Renderer::renderTrail(const TrailBuffer &buffer, const glm::vec3 &color) {
@@ -684,16 +725,43 @@ void Renderer::renderTrail(const TrailBuffer &buffer, const glm::vec3 &color) {
   glDisable(GL_LINE_SMOOTH);
 }
 
-void Renderer::render(const Node &node, bool isSelected, LightingMode lightingMode) {
+void Renderer::queue(const Node &node, bool isSelected) {
   const auto &m = node.getModel();
 
+  auto flags = 0u;
+  if (m.getBaseColor())
+    flags |= Mesh::HasBaseColor;
+  if (m.getHighlightColor())
+    flags |= Mesh::HasHighlightColor;
+  if (isSelected)
+    flags |= Mesh::Selected;
+
+  nodeInstances[m.getModelId()].push_back({m.getModelMatrix(), m.getBaseColor().value_or(glm::vec3{0.0f}),
+                                           m.getHighlightColor().value_or(glm::vec3{0.0f}), flags,
+                                           node.getNs3Model().id});
+}
+
+void Renderer::renderNodes(LightingMode lightingMode) {
   modelShader.bind();
-  modelShader.uniform("is_selected", isSelected);
-  modelShader.uniform("model", m.getModelMatrix());
+  modelShader.uniform("instanced", true);
+  modelShader.uniform("is_selected", false);
   modelShader.uniform("useLighting", lightingMode == LightingMode::LightingEnabled);
-  modelCache.get(m.getModelId()).render(modelShader, m);
 
-  modelShader.uniform("is_selected", false);
+  glBindBuffer(GL_ARRAY_BUFFER, nodeInstanceVbo);
+  for (auto &[modelId, instances] : nodeInstances) {
+    if (instances.empty())
+      continue;
+
+    // Respecify the whole buffer, so the driver may hand us new storage
+    // rather than waiting on the draw using the last group
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Mesh::Instance) * instances.size()),
+                 instances.data(), GL_STREAM_DRAW);
+
+    modelCache.get(modelId).renderInstanced(modelShader, nodeInstanceVbo, static_cast<int>(instances.size()));
+    instances.clear();
+  }
+
+  modelShader.uniform("instanced", false);
 }
 
 void Renderer::render(const Model &m, LightingMode lightingMode) {
@@ -762,15 +830,15 @@ void Renderer::render(CoordinateGrid &coordinateGrid) {
   glDepthMask(GL_TRUE);
 }
 
-void Renderer::render(const std::vector<WiredLink> &wiredLinks) {
+void Renderer::render(const std::vector<const WiredLink *> &wiredLinks) {
   glEnable(GL_LINE_SMOOTH);
 
   buildingShader.bind();
   // TODO: Make configurable
   buildingShader.uniform("color", {0.0f, 0.0f, 0.0f});
 
-  for (const auto &wiredLink : wiredLinks) {
-    const auto &renderInfo = wiredLink.getRenderInfo();
+  for (const auto wiredLink : wiredLinks) {
+    const auto &renderInfo = wiredLink->getRenderInfo();
     glBindVertexArray(renderInfo.vao);
     glBindBuffer(GL_ARRAY_BUFFER, renderInfo.vbo);
     glDrawArrays(GL_LINES, 0, renderInfo.size);
@@ -788,40 +856,78 @@ void Renderer::render(const LogicalLink &link) {
   modelCache.get(link.linkCylinder.id).render(modelShader, std::optional{link.color}, {});
 }
 
-void Renderer::renderPickingNode(unsigned int nodeId, const Model &m) {
-  auto &model = modelCache.get(m.getModelId());
-
-  pickingShader.uniform("model", m.getModelMatrix());
-  pickingShader.uniform("object_id", nodeId);
+void Renderer::renderPickingNodes() {
+  pickingShader.bind();
   pickingShader.uniform("object_type", 1u);
 
-  pickingShader.bind();
-  auto &meshes = model.getMeshes();
-  for (auto &mesh : meshes) {
-    mesh.render();
+  glBindBuffer(GL_ARRAY_BUFFER, nodeInstanceVbo);
+  for (auto &[modelId, instances] : nodeInstances) {
+    if (instances.empty())
+      continue;
+
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Mesh::Instance) * instances.size()),
+                 instances.data(), GL_STREAM_DRAW);
+
+    const auto count = static_cast<int>(instances.size());
+    auto &model = modelCache.get(modelId);
+    for (auto &mesh : model.getMeshes()) {
+      mesh.renderInstanced(nodeInstanceVbo, count);
+    }
+    for (auto &mesh : model.getTransparentMeshes()) {
+      mesh.renderInstanced(nodeInstanceVbo, count);
+    }
+    instances.clear();
   }
-  auto &transparentMeshes = model.getTransparentMeshes();
-  for (auto &mesh : transparentMeshes) {
-    mesh.render();
+}
+
+void Renderer::useLabelQuads(std::size_t offset) {
+  const auto stride = static_cast<GLsizei>(sizeof(LabelQuad));
+
+  glVertexAttribPointer(0u, 3, GL_FLOAT, GL_FALSE, stride,
+                        reinterpret_cast<void *>(offset + offsetof(LabelQuad, anchor)));
+  glVertexAttribPointer(1u, 4, GL_FLOAT, GL_FALSE, stride,
+                        reinterpret_cast<void *>(offset + offsetof(LabelQuad, bounds)));
+  glVertexAttribPointer(2u, 4, GL_FLOAT, GL_FALSE, stride,
+                        reinterpret_cast<void *>(offset + offsetof(LabelQuad, textureBounds)));
+}
+
+void Renderer::queueLabel(const FontManager::FontBannerRenderInfo &info, const glm::vec3 &anchor) {
+  labelBackgrounds.push_back({anchor, info.backgroundBounds, glm::vec4{0.0f}});
+
+  const auto &glyphs = fontManager.getGlyphs();
+  for (auto i = info.firstGlyph; i < info.firstGlyph + info.size; i++) {
+    const auto &glyph = glyphs[static_cast<std::size_t>(i)];
+    labelGlyphs.push_back({anchor, glyph.bounds, glyph.textureBounds});
   }
 }
 
-void Renderer::renderFont(const FontManager::FontBannerRenderInfo &info, const glm::vec3 &location, float scale) {
-  // TODO: Maybe make this configurable?
-  const glm::vec3 offset{0.0f, 2.0f, 0.0f};
+void Renderer::renderLabels(float scale) {
+  if (labelBackgrounds.empty())
+    return;
+
+  const auto backgroundSize = sizeof(LabelQuad) * labelBackgrounds.size();
+  const auto glyphSize = sizeof(LabelQuad) * labelGlyphs.size();
+
+  glBindVertexArray(labelVao);
+  glBindBuffer(GL_ARRAY_BUFFER, labelVbo);
 
-  auto modelMatrix = glm::translate(glm::identity<glm::mat4>(), location + offset);
-  modelMatrix = glm::scale(modelMatrix, glm::vec3{scale});
-  modelMatrix *= cameraRotateInverse;
+  // Grow the buffer in steps, so it is not resized every time the
+  // number of labels changes.
+  // Otherwise, orphan it, so we do not wait on the last frame's draw
+  if (backgroundSize + glyphSize > labelVboCapacity)
+    labelVboCapacity = std::max(backgroundSize + glyphSize, labelVboCapacity * 2u);
+  glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(labelVboCapacity), nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(backgroundSize), labelBackgrounds.data());
+  glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(backgroundSize), static_cast<GLsizeiptr>(glyphSize),
+                  labelGlyphs.data());
 
-  // ----- Background -----
+  // ----- Backgrounds -----
   startTransparentDark();
   fontBackgroundShader.bind();
-  fontBackgroundShader.uniform("model", glm::translate(modelMatrix, {0.0, 0.0, -0.01f}));
+  fontBackgroundShader.uniform("scale", scale);
 
-  glBindVertexArray(info.backgroundVao);
-  glBindBuffer(GL_ARRAY_BUFFER, info.backgroundVbo);
-  glDrawArrays(GL_TRIANGLES, 0, info.backgroundVboSize);
+  useLabelQuads(0u);
+  glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(labelBackgrounds.size()));
 
   // ----- Glyphs -----
   startTransparentLight();
@@ -829,11 +935,13 @@ void Renderer::renderFont(const FontManager::FontBannerRenderInfo &info, const g
   textureCache.use(fontManager.getAtlasTexture());
 
   fontShader.bind();
-  fontShader.uniform("model", modelMatrix);
+  fontShader.uniform("scale", scale);
+
+  useLabelQuads(backgroundSize);
+  glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(labelGlyphs.size()));
 
-  glBindVertexArray(info.glyphVao);
-  glBindBuffer(GL_ARRAY_BUFFER, info.glyphVbo);
-  glDrawArrays(GL_TRIANGLES, 0, info.glyphVboSize);
+  labelBackgrounds.clear();
+  labelGlyphs.clear();
 }
 
 } // namespace netsimulyzer
@@ -38,6 +38,7 @@
 #include "../camera/Camera.h"
 #include "../helper/Floor.h"
 #include "../mesh/Mesh.h"
+#include "../mesh/StaticBatch.h"
 #include "../model/Model.h"
 #include "../model/ModelCache.h"
 #include "../shader/Shader.h"
@@ -52,8 +53,10 @@
 #include "src/render/helper/CoordinateGrid.h"
 #include "src/render/helper/SkyBox.h"
 #include <QOpenGLFunctions_3_3_Core>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 namespace netsimulyzer {
@@ -82,8 +85,108 @@ class Renderer : protected QOpenGLFunctions_3_3_Core {
   Shader fontShader;
   Shader fontBackgroundShader;
 
+  /**
+   * Buffer of `Mesh::Instance`s for the
+   * group of nodes currently being drawn
+   */
+  unsigned int nodeInstanceVbo{0u};
+
+  /**
+   * Nodes queued by `queue()`, grouped by the model they use.
+   * The lists are kept between frames, so queueing does not allocate
+   */
+  std::unordered_map<model_id, std::vector<Mesh::Instance>> nodeInstances;
+
+  /**
+   * One quad of a label, expanded to face the camera by the font shaders
+   */
+  struct LabelQuad {
+    /**
+     * The bottom-center of the label, in world coordinates
+     */
+    glm::vec3 anchor;
+
+    /**
+     * The corners of the quad, relative to `anchor`, before scaling.
+     * <vec2 min, vec2 max>
+     */
+    glm::vec4 bounds;
+
+    /**
+     * The corners of the quad on the font atlas.
+     * Unused for backgrounds
+     */
+    glm::vec4 textureBounds;
+  };
+
+  /**
+   * Backgrounds & glyphs of the labels queued by `queueLabel()`.
+   * Kept between frames, so queueing does not allocate
+   */
+  std::vector<LabelQuad> labelBackgrounds;
+  std::vector<LabelQuad> labelGlyphs;
+
+  /**
+   * Streaming buffer of `LabelQuad`s, with the backgrounds
+   * followed by the glyphs, rewritten every frame
+   */
+  unsigned int labelVao{0u};
+  unsigned int labelVbo{0u};
+
+  /**
+   * Size of `labelVbo`, in bytes
+   */
+  std::size_t labelVboCapacity{0u};
+
+  /**
+   * Point the attributes of `labelVao` at the quads in `labelVbo`
+   * starting at `offset`
+   *
+   * @param offset
+   * Byte offset of the first quad to draw
+   */
+  void useLabelQuads(std::size_t offset);
+
+  /**
+   * The walls & floors of every building, with their colors
+   */
+  StaticBatch buildingBatch;
+
+  /**
+   * The borders of every building, drawn as lines
+   */
+  StaticBatch buildingOutlineBatch;
+
+  /**
+   * The fill & border of every area, with their colors
+   */
+  StaticBatch areaBatch;
+
   void initShader(Shader &s, const QString &vertexPath, const QString &fragmentPath);
 
+  /**
+   * Copy the geometry of `batch` into its buffers,
+   * creating them if necessary
+   *
+   * @param batch
+   * The batch to upload
+   */
+  void upload(StaticBatch &batch);
+
+  /**
+   * Draw the ranges queued in `batch` with a single call,
+   * uploading it first if it changed.
+   * Empties the queue.
+   * The shader should be bound first
+   *
+   * @param batch
+   * The batch to draw
+   *
+   * @param mode
+   * The primitive the batch is made of
+   */
+  void render(StaticBatch &batch, GLenum mode);
+
 public:
   enum class LightingMode { LightingEnabled, LightingDisabled };
   const unsigned int maxPointLights = 5u;
@@ -97,8 +200,33 @@ public:
   void setSpotLightCount(unsigned int count);
 
   TrailBuffer allocateTrailBuffer(QOpenGLFunctions_3_3_Core *openGl, int size);
+  /**
+   * Add `building` to the shared building batches
+   *
+   * @param building
+   * The building to add
+   *
+   * @return
+   * Where the building is in the batches
+   */
   Building::RenderInfo allocate(const parser::Building &building);
+
+  /**
+   * Add `area` to the shared area batch
+   *
+   * @param area
+   * The area to add
+   *
+   * @return
+   * Where the area is in the batch
+   */
   Area::RenderInfo allocate(const parser::Area &area);
+
+  /**
+   * Remove every building & area from the shared batches.
+   * Their buffers are kept, and reused by the next scenario
+   */
+  void resetStaticGeometry();
   WiredLink::RenderInfo allocate(const parser::WiredLink &link);
   Mesh allocateFloor(float size);
   void resize(Floor &f, float size);
@@ -109,26 +237,105 @@ public:
   void startTransparentLight();
   void endTransparent();
 
-  void renderPickingNode(unsigned int nodeId, const Model &m);
+  /**
+   * Draw the IDs of every node queued by `queue()`
+   * into the bound picking framebuffer.
+   * Nodes sharing a model are drawn together,
+   * with one instanced draw call per mesh.
+   * Empties the queue
+   */
+  void renderPickingNodes();
 
   void use(const Camera &cam);
   void use(const ArcCamera &cam);
   void render(const DirectionalLight &light);
   void render(const PointLight &light);
   void render(const SpotLight &light);
-  void render(const std::vector<Area> &areas);
-  void render(const std::vector<Building> &buildings);
-  void renderOutlines(const std::vector<Building> &buildings, const glm::vec3 &color);
+
+  /**
+   * Draw `areas`, with one draw call for all of them.
+   * Areas in the order they were allocated
+   * are drawn as a single range
+   *
+   * @param areas
+   * The areas to draw
+   */
+  void render(const std::vector<const Area *> &areas);
+
+  /**
+   * Draw the visible buildings in `buildings`,
+   * with one draw call for all of them.
+   * Buildings in the order they were allocated
+   * are drawn as a single range
+   *
+   * @param buildings
+   * The buildings to draw
+   */
+  void render(const std::vector<const Building *> &buildings);
+
+  /**
+   * Draw the borders of the visible buildings in `buildings`,
+   * with one draw call for all of them
+   *
+   * @param buildings
+   * The buildings to draw the borders of
+   *
+   * @param color
+   * The color of the borders
+   */
+  void renderOutlines(const std::vector<const Building *> &buildings, const glm::vec3 &color);
   void renderTrail(const TrailBuffer &buffer, const glm::vec3 &color);
-  void render(const Node &node, bool isSelected, LightingMode lightingMode = LightingMode::LightingEnabled);
+
+  /**
+   * Queue `node` to be drawn by the next `renderNodes()` call
+   *
+   * @param node
+   * The node to draw
+   *
+   * @param isSelected
+   * If the node should be drawn as selected
+   */
+  void queue(const Node &node, bool isSelected);
+
+  /**
+   * Draw the opaque meshes of every node queued by `queue()`.
+   * Nodes sharing a model are drawn together,
+   * with one instanced draw call per mesh.
+   * Empties the queue
+   *
+   * @param lightingMode
+   * If the nodes should be lit
+   */
+  void renderNodes(LightingMode lightingMode = LightingMode::LightingEnabled);
   void render(const Model &m, LightingMode lightingMode = LightingMode::LightingEnabled);
   void renderTransparent(const Model &m, LightingMode lightingMode = LightingMode::LightingEnabled);
   void render(Floor &f);
   void render(SkyBox &skyBox);
   void render(CoordinateGrid &coordinateGrid);
-  void render(const std::vector<WiredLink> &wiredLinks);
+  void render(const std::vector<const WiredLink *> &wiredLinks);
   void render(const LogicalLink &link);
-  void renderFont(const FontManager::FontBannerRenderInfo &info, const glm::vec3 &location, float scale);
+
+  /**
+   * Queue a label to be drawn by the next `renderLabels()` call
+   *
+   * @param info
+   * The banner to draw
+   *
+   * @param anchor
+   * The bottom-center of the label, in world coordinates
+   */
+  void queueLabel(const FontManager::FontBannerRenderInfo &info, const glm::vec3 &anchor);
+
+  /**
+   * Draw every label queued by `queueLabel()`, facing the camera.
+   * All backgrounds are drawn with one call, then all glyphs with another.
+   * May end in the light transparent mode.
+   * Empties the queue
+   *
+   * @param scale
+   * The scale of every label
+   */
+  void renderLabels(float scale);
 };
 
 } // namespace netsimulyzer
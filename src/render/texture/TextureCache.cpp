@@ -32,16 +32,83 @@
  */
 
 #include "TextureCache.h"
+#include <QByteArray>
 #include <QColor>
 #include <QDebug>
 #include <QDir>
 #include <QImage>
+#include <QOpenGLContext>
+#include <QStandardPaths>
 #include <QString>
+#include <QThreadPool>
 #include <Qt>
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <utility>
 
 namespace {
+
+// From GL_EXT_texture_compression_s3tc, which is not part of core OpenGL
+const GLenum compressedRgbDxt1 = 0x83F0;
+const GLenum compressedRgbaDxt5 = 0x83F3;
+
+/**
+ * Get the directory for `TextureDiskCache`
+ *
+ * @return
+ * The directory, or an empty path if there is
+ * nowhere to write it, which disables the cache
+ */
+std::filesystem::path diskCacheDirectory() {
+  const auto location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (location.isEmpty())
+    return {};
+
+  return std::filesystem::path{location.toStdU16String()} / "textures";
+}
+
+/**
+ * Build the next mip level from `source`,
+ * averaging each 2x2 block of pixels
+ *
+ * @param source
+ * A `TextureData::Format::BGRA8` level, larger than 1x1
+ *
+ * @return
+ * The level half the size of `source`
+ */
+netsimulyzer::TextureData::Level downsample(const netsimulyzer::TextureData::Level &source) {
+  netsimulyzer::TextureData::Level level;
+  level.width = std::max(1, source.width / 2);
+  level.height = std::max(1, source.height / 2);
+  level.data.resize(static_cast<std::size_t>(level.width) * level.height * 4u);
+
+  const auto pixel = [&source](int x, int y) {
+    return source.data.data() + (static_cast<std::size_t>(y) * source.width + x) * 4u;
+  };
+
+  for (auto y = 0; y < level.height; y++) {
+    // Clamp for sides of length 1, which are not halved
+    const auto y0 = std::min(y * 2, source.height - 1);
+    const auto y1 = std::min(y * 2 + 1, source.height - 1);
+
+    for (auto x = 0; x < level.width; x++) {
+      const auto x0 = std::min(x * 2, source.width - 1);
+      const auto x1 = std::min(x * 2 + 1, source.width - 1);
+
+      auto *out = level.data.data() + (static_cast<std::size_t>(y) * level.width + x) * 4u;
+      for (auto channel = 0u; channel < 4u; channel++) {
+        const auto sum = pixel(x0, y0)[channel] + pixel(x1, y0)[channel] + pixel(x0, y1)[channel] +
+                         pixel(x1, y1)[channel] + 2u;
+        out[channel] = static_cast<unsigned char>(sum / 4u);
+      }
+    }
+  }
+
+  return level;
+}
 std::optional<QFileInfo> findTexture(const QDir &base, const QString &fileName, unsigned int max = 25u) {
   // Cut us off after `max` levels
   if (max == 0u)
@@ -73,10 +140,17 @@ std::optional<QFileInfo> findTexture(const QDir &base, const QString &fileName,
 
 namespace netsimulyzer {
 
+TextureCache::TextureCache() : diskCache(diskCacheDirectory()) {
+}
+
 void TextureCache::setResourceDirectory(const QDir &value) {
   resourceDirectory = value;
 }
 
+const QDir &TextureCache::getResourceDirectory() const {
+  return resourceDirectory;
+}
+
 TextureCache::~TextureCache() {
   clear();
 }
@@ -85,6 +159,9 @@ bool TextureCache::init() {
   if (!initializeOpenGLFunctions())
     return false;
 
+  const auto context = QOpenGLContext::currentContext();
+  compressTextures = context->hasExtension(QByteArrayLiteral("GL_EXT_texture_compression_s3tc"));
+
   // Generate a fallback texture
   QImage fallback{64, 64, QImage::Format::Format_ARGB32};
   fallback.fill(Qt::GlobalColor::magenta);
@@ -114,61 +191,168 @@ bool TextureCache::init() {
   return true;
 }
 
-texture_id TextureCache::load(const std::string &filename) {
+std::optional<TextureData> TextureCache::decode(const QDir &directory, const std::string &filename) const {
+  auto result = findTexture(directory, QString::fromStdString(filename));
+  if (!result)
+    return {};
 
-  // If we've already loaded the texture, use that ID
-  auto existing = indexMap.find(filename);
-  if (existing != indexMap.end()) {
-    return existing->second;
-  }
+  const auto path = result->canonicalFilePath().toStdString();
 
-  auto result = findTexture(resourceDirectory, QString::fromStdString(filename));
-  if (!result)
-    return fallbackTexture;
+  // Compressed entries are only usable where the driver supports them
+  auto cached = diskCache.read(path);
+  if (cached && (cached->format == TextureData::Format::BGRA8 || compressTextures))
+    return cached;
 
   QImage image{result->canonicalFilePath()};
   if (image.isNull())
-    return fallbackTexture;
+    return {};
 
-  unsigned int glFormat;
+  TextureData data;
+  data.path = path;
+
+  // Both formats are 4 byte BGRA, RGB32 just has an unused alpha
   switch (image.format()) {
   case QImage::Format::Format_RGB32:
-    glFormat = GL_RGB;
+    data.hasAlpha = false;
     break;
   case QImage::Format::Format_ARGB32:
-    glFormat = GL_RGBA;
+    data.hasAlpha = true;
     break;
   default:
-    qDebug() << "Unsupported format: " << image.format() << "\nAttempting conversion...";
+    data.hasAlpha = image.hasAlphaChannel();
     image = image.convertToFormat(QImage::Format_ARGB32);
-    glFormat = GL_RGBA;
 
     if (image.isNull())
-      return fallbackTexture;
+      return {};
+  }
+
+  auto &base = data.levels.emplace_back();
+  base.width = image.width();
+  base.height = image.height();
+  base.data.assign(image.constBits(), image.constBits() + image.sizeInBytes());
+
+  while (data.levels.back().width > 1 || data.levels.back().height > 1) {
+    data.levels.emplace_back(downsample(data.levels.back()));
   }
 
+  // Otherwise written once the driver compresses it
+  if (!compressTextures && diskCache.enabled() && !diskCache.write(data))
+    std::cerr << "Failed to write texture cache for: " << path << '\n';
+
+  return data;
+}
+
+texture_id TextureCache::upload(const TextureData &data) {
   Texture t;
-  t.height = image.height();
-  t.width = image.width();
+  t.width = data.levels.front().width;
+  t.height = data.levels.front().height;
+  t.location = data.path;
 
   glGenTextures(1, &t.id);
   glBindTexture(GL_TEXTURE_2D, t.id);
 
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(data.levels.size() - 1u));
+
+  const auto compress = data.format == TextureData::Format::BGRA8 && compressTextures;
+  for (auto i = 0u; i < data.levels.size(); i++) {
+    const auto &level = data.levels[i];
+    const auto levelIndex = static_cast<GLint>(i);
+
+    switch (data.format) {
+    case TextureData::Format::Dxt1:
+      glCompressedTexImage2D(GL_TEXTURE_2D, levelIndex, compressedRgbDxt1, level.width, level.height, 0,
+                             static_cast<GLsizei>(level.data.size()), level.data.data());
+      break;
+    case TextureData::Format::Dxt5:
+      glCompressedTexImage2D(GL_TEXTURE_2D, levelIndex, compressedRgbaDxt5, level.width, level.height, 0,
+                             static_cast<GLsizei>(level.data.size()), level.data.data());
+      break;
+    case TextureData::Format::BGRA8: {
+      GLint internalFormat;
+      if (compress)
+        internalFormat = data.hasAlpha ? compressedRgbaDxt5 : compressedRgbDxt1;
+      else
+        internalFormat = data.hasAlpha ? GL_RGBA : GL_RGB;
+
+      // QImage keeps BGRA format, event without an alpha channel
+      glTexImage2D(GL_TEXTURE_2D, levelIndex, internalFormat, level.width, level.height, 0, GL_BGRA,
+                   GL_UNSIGNED_BYTE, level.data.data());
+    } break;
+    }
+  }
 
-  // QImage keeps BGRA format, event without an alpha channel
-  glTexImage2D(GL_TEXTURE_2D, 0, glFormat, t.width, t.height, 0, GL_BGRA, GL_UNSIGNED_BYTE, image.constBits());
-
-  glGenerateMipmap(GL_TEXTURE_2D);
+  if (compress && diskCache.enabled()) {
+    // Keep what the driver compressed, so later loads skip both decoding & compressing
+    auto compressed = std::make_shared<TextureData>();
+    compressed->path = data.path;
+    compressed->hasAlpha = data.hasAlpha;
+    compressed->format = data.hasAlpha ? TextureData::Format::Dxt5 : TextureData::Format::Dxt1;
+
+    for (auto i = 0u; i < data.levels.size(); i++) {
+      const auto levelIndex = static_cast<GLint>(i);
+      GLint isCompressed = GL_FALSE;
+      GLint size = 0;
+      glGetTexLevelParameteriv(GL_TEXTURE_2D, levelIndex, GL_TEXTURE_COMPRESSED, &isCompressed);
+      glGetTexLevelParameteriv(GL_TEXTURE_2D, levelIndex, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+
+      if (isCompressed == GL_FALSE || size <= 0) {
+        compressed.reset();
+        break;
+      }
+
+      auto &level = compressed->levels.emplace_back();
+      level.width = data.levels[i].width;
+      level.height = data.levels[i].height;
+      level.data.resize(static_cast<std::size_t>(size));
+      glGetCompressedTexImage(GL_TEXTURE_2D, levelIndex, level.data.data());
+    }
+
+    if (compressed) {
+      QThreadPool::globalInstance()->start([cache = diskCache, compressed]() {
+        if (!cache.write(*compressed))
+          std::cerr << "Failed to write texture cache for: " << compressed->path << '\n';
+      });
+    }
+  }
 
   glBindTexture(GL_TEXTURE_2D, 0u);
 
   textures.emplace_back(t);
-  const auto newIndex = textures.size() - 1;
-  indexMap.emplace(result->canonicalFilePath().toStdString(), newIndex);
+  return textures.size() - 1u;
+}
+
+texture_id TextureCache::load(const std::string &filename) {
+  // If we've already loaded the texture, use that ID
+  auto existing = indexMap.find(filename);
+  if (existing != indexMap.end())
+    return existing->second;
+
+  const auto data = decode(resourceDirectory, filename);
+  if (!data)
+    return fallbackTexture;
+
+  return load(filename, data.value());
+}
+
+texture_id TextureCache::load(const std::string &filename, const TextureData &data) {
+  auto existing = indexMap.find(filename);
+  if (existing != indexMap.end())
+    return existing->second;
+
+  // The same image may have been loaded by another name
+  existing = indexMap.find(data.path);
+  if (existing != indexMap.end()) {
+    indexMap.emplace(filename, existing->second);
+    return existing->second;
+  }
+
+  const auto newIndex = upload(data);
+  indexMap.emplace(filename, newIndex);
+  indexMap.emplace(data.path, newIndex);
   return newIndex;
 }
 
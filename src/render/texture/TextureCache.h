@@ -33,6 +33,8 @@
 
 #pragma once
 
+#include "TextureData.h"
+#include "TextureDiskCache.h"
 #include "texture.h"
 #include <QDir>
 #include <QImage>
@@ -52,11 +54,39 @@ namespace netsimulyzer {
 using texture_id = std::size_t;
 
 class TextureCache : protected QOpenGLFunctions_3_3_Core {
+  /**
+   * Loaded textures, by both the file name they were requested by,
+   * and the canonical path of the image
+   */
   std::unordered_map<std::string, std::size_t> indexMap;
   std::vector<Texture> textures;
   texture_id fallbackTexture;
   QDir resourceDirectory;
 
+  /**
+   * Textures already decoded, from earlier runs
+   */
+  TextureDiskCache diskCache;
+
+  /**
+   * If the driver can compress textures to S3TC.
+   * Set once by `init()`, before any textures are decoded
+   */
+  bool compressTextures{false};
+
+  /**
+   * Upload `data` as a new texture, with all its mips.
+   * Uncompressed textures are compressed by the driver if `compressTextures` is set,
+   * and the result is written to `diskCache`
+   *
+   * @param data
+   * The texture to upload
+   *
+   * @return
+   * The ID of the new texture
+   */
+  texture_id upload(const TextureData &data);
+
 public:
   struct CubeMap {
     QImage right;
@@ -67,12 +97,55 @@ public:
     QImage front;
   };
 
+  TextureCache();
   ~TextureCache() override;
 
   bool init();
 
   void setResourceDirectory(const QDir &value);
+  [[nodiscard]] const QDir &getResourceDirectory() const;
+
+  /**
+   * Find the image `filename` under `directory`, and decode it with its mips,
+   * from the disk cache if possible. Thread safe, once `init()` was called
+   *
+   * @param directory
+   * The directory to search for the image, and its subdirectories
+   *
+   * @param filename
+   * The file name of the image
+   *
+   * @return
+   * The decoded texture, or an empty optional if the image
+   * was not found, or could not be decoded
+   */
+  [[nodiscard]] std::optional<TextureData> decode(const QDir &directory, const std::string &filename) const;
+
+  /**
+   * Decode & upload the texture `filename`, if it was not already loaded
+   *
+   * @param filename
+   * The file name of the image, under the resource directory
+   *
+   * @return
+   * The ID of the texture, or the fallback texture if it could not be loaded
+   */
   texture_id load(const std::string &filename);
+
+  /**
+   * Upload the texture `filename` from `data`,
+   * decoded earlier by `decode()`, if it was not already loaded
+   *
+   * @param filename
+   * The file name the texture was decoded from
+   *
+   * @param data
+   * The decoded texture
+   *
+   * @return
+   * The ID of the texture
+   */
+  texture_id load(const std::string &filename, const TextureData &data);
   unsigned int load(const CubeMap &cubeMap);
   texture_id loadInternal(const std::string &path, GLint filter = GL_LINEAR, GLint repeat = GL_REPEAT);
   [[nodiscard]] const Texture &get(texture_id index);
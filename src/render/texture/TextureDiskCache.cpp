@@ -0,0 +1,277 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "TextureDiskCache.h"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mapped-file.h>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * Change whenever the layout of the file,
+ * or the meaning of a field changes
+ */
+const std::uint32_t cacheVersion = 1u;
+const std::array<char, 8> cacheMagic{'N', 'S', 'T', 'C', 'A', 'C', 'H', 'E'};
+
+/**
+ * Larger than any texture we would load,
+ * just to keep the size checks from overflowing
+ */
+const int maxDimension = 32768;
+
+struct LevelRecord {
+  std::int32_t width;
+  std::int32_t height;
+  std::uint64_t size;
+};
+static_assert(std::is_trivially_copyable_v<LevelRecord>);
+
+/**
+ * Layout:
+ * Header, LevelRecord[levelCount], char[pathLength], unsigned char[dataBytes]
+ *
+ * The data of each level follows that of the previous level
+ */
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint8_t format;
+  std::uint8_t hasAlpha;
+  std::array<std::uint8_t, 2> padding;
+  std::uint64_t levelCount;
+  std::uint64_t sourceSize;
+  std::int64_t sourceModified;
+  std::uint64_t pathLength;
+  std::uint64_t dataBytes;
+};
+static_assert(std::is_trivially_copyable_v<Header>);
+
+/**
+ * FNV-1a, since the result must be the same between runs
+ */
+std::uint64_t hashPath(std::string_view path) {
+  std::uint64_t hash = 0xCBF29CE484222325ULL;
+  for (const auto c : path) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001B3ULL;
+  }
+
+  return hash;
+}
+
+/**
+ * Get the number of bytes a level of `format` should have
+ */
+std::uint64_t levelSize(netsimulyzer::TextureData::Format format, std::uint64_t width, std::uint64_t height) {
+  using Format = netsimulyzer::TextureData::Format;
+
+  switch (format) {
+  case Format::Dxt1:
+    return ((width + 3u) / 4u) * ((height + 3u) / 4u) * 8u;
+  case Format::Dxt5:
+    return ((width + 3u) / 4u) * ((height + 3u) / 4u) * 16u;
+  case Format::BGRA8:
+    [[fallthrough]];
+  default:
+    return width * height * 4u;
+  }
+}
+
+template <typename T>
+void writeRaw(std::ofstream &out, const T *values, std::size_t count) {
+  out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+namespace netsimulyzer {
+
+TextureDiskCache::TextureDiskCache(std::filesystem::path directory) : directory(std::move(directory)) {
+}
+
+bool TextureDiskCache::enabled() const {
+  return !directory.empty();
+}
+
+std::filesystem::path TextureDiskCache::entryPath(const std::string &imagePath) const {
+  std::array<char, 17> name{};
+  std::snprintf(name.data(), name.size(), "%016llx", static_cast<unsigned long long>(hashPath(imagePath)));
+
+  return directory / (std::string{name.data()} + ".nst");
+}
+
+std::optional<TextureData> TextureDiskCache::read(const std::string &imagePath) const {
+  if (directory.empty())
+    return {};
+
+  const auto path = entryPath(imagePath).string();
+  parser::MappedFile file{path.c_str()};
+  if (!file.isOpen() || file.size() < sizeof(Header))
+    return {};
+
+  Header header;
+  std::memcpy(&header, file.data(), sizeof(Header));
+
+  if (header.magic != cacheMagic || header.version != cacheVersion ||
+      header.format > static_cast<std::uint8_t>(TextureData::Format::Dxt5) || header.levelCount == 0u ||
+      header.levelCount > 32u)
+    return {};
+
+  const auto levelBytes = header.levelCount * sizeof(LevelRecord);
+  if (levelBytes > file.size() - sizeof(Header) || header.pathLength > file.size() - sizeof(Header) - levelBytes ||
+      header.dataBytes != file.size() - sizeof(Header) - levelBytes - header.pathLength)
+    return {};
+
+  const auto levels = file.data() + sizeof(Header);
+  const auto sourcePath = levels + levelBytes;
+  const auto data = sourcePath + header.pathLength;
+
+  // The image itself guards against two paths sharing an entry
+  if (std::string_view{sourcePath, header.pathLength} != imagePath)
+    return {};
+
+  std::error_code error;
+  const auto size = std::filesystem::file_size(imagePath, error);
+  if (error || size != header.sourceSize)
+    return {};
+
+  const auto modified = std::filesystem::last_write_time(imagePath, error);
+  if (error || header.sourceModified != static_cast<std::int64_t>(modified.time_since_epoch().count()))
+    return {};
+
+  TextureData texture;
+  texture.path = imagePath;
+  texture.format = static_cast<TextureData::Format>(header.format);
+  texture.hasAlpha = header.hasAlpha != 0u;
+  texture.levels.reserve(header.levelCount);
+
+  std::uint64_t offset = 0u;
+  for (std::uint64_t i = 0u; i < header.levelCount; i++) {
+    LevelRecord record;
+    std::memcpy(&record, levels + i * sizeof(LevelRecord), sizeof(LevelRecord));
+
+    if (record.width <= 0 || record.height <= 0 || record.width > maxDimension || record.height > maxDimension ||
+        record.size != levelSize(texture.format, record.width, record.height) ||
+        record.size > header.dataBytes - offset)
+      return {};
+
+    auto &level = texture.levels.emplace_back();
+    level.width = record.width;
+    level.height = record.height;
+    level.data.assign(data + offset, data + offset + record.size);
+    offset += record.size;
+  }
+
+  if (offset != header.dataBytes)
+    return {};
+
+  return texture;
+}
+
+bool TextureDiskCache::write(const TextureData &data) const {
+  if (directory.empty() || data.levels.empty())
+    return false;
+
+  std::error_code error;
+  const auto sourceSize = std::filesystem::file_size(data.path, error);
+  if (error)
+    return false;
+
+  const auto modified = std::filesystem::last_write_time(data.path, error);
+  if (error)
+    return false;
+
+  std::vector<LevelRecord> levels;
+  levels.reserve(data.levels.size());
+  std::uint64_t dataBytes = 0u;
+  for (const auto &level : data.levels) {
+    levels.emplace_back(LevelRecord{level.width, level.height, level.data.size()});
+    dataBytes += level.data.size();
+  }
+
+  Header header{};
+  header.magic = cacheMagic;
+  header.version = cacheVersion;
+  header.format = static_cast<std::uint8_t>(data.format);
+  header.hasAlpha = data.hasAlpha ? 1u : 0u;
+  header.levelCount = levels.size();
+  header.sourceSize = sourceSize;
+  header.sourceModified = static_cast<std::int64_t>(modified.time_since_epoch().count());
+  header.pathLength = data.path.size();
+  header.dataBytes = dataBytes;
+
+  std::filesystem::create_directories(directory, error);
+  if (error)
+    return false;
+
+  const auto path = entryPath(data.path);
+  auto temporaryPath = path;
+  temporaryPath += ".tmp";
+  {
+    std::ofstream out{temporaryPath, std::ios::binary | std::ios::trunc};
+    if (!out)
+      return false;
+
+    writeRaw(out, &header, 1u);
+    writeRaw(out, levels.data(), levels.size());
+    writeRaw(out, data.path.data(), data.path.size());
+    for (const auto &level : data.levels)
+      writeRaw(out, level.data.data(), level.data.size());
+
+    if (!out.flush()) {
+      out.close();
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace netsimulyzer
@@ -0,0 +1,98 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include "TextureData.h"
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace netsimulyzer {
+
+/**
+ * On disk cache of textures after they were decoded & their mips generated,
+ * so later loads may skip decoding them.
+ *
+ * Each texture is kept in its own file, named for the image's path,
+ * and only used if the image is unchanged since it was written
+ */
+class TextureDiskCache {
+  /**
+   * Where entries are kept. Empty if the cache is disabled
+   */
+  std::filesystem::path directory;
+
+  [[nodiscard]] std::filesystem::path entryPath(const std::string &imagePath) const;
+
+public:
+  /**
+   * @param directory
+   * Where to keep entries. Created on the first write.
+   * An empty path disables the cache
+   */
+  explicit TextureDiskCache(std::filesystem::path directory);
+
+  /**
+   * @return
+   * True if entries are read & written, False otherwise
+   */
+  [[nodiscard]] bool enabled() const;
+
+  /**
+   * Read the cached texture for `imagePath`. Thread safe
+   *
+   * @param imagePath
+   * The canonical path to the image
+   *
+   * @return
+   * The cached texture, in the format it was stored in, or an empty optional
+   * if there is no entry, or it is from another version, or out of date
+   */
+  [[nodiscard]] std::optional<TextureData> read(const std::string &imagePath) const;
+
+  /**
+   * Write the entry for `data`, replacing any existing one.
+   * Written to a temporary file first, so a failed write
+   * never leaves a partial entry behind.
+   * Thread safe, so long as no two threads write the same texture
+   *
+   * @param data
+   * The texture to store. Its `path` is the image it was read from
+   *
+   * @return
+   * True if the entry was written, False otherwise
+   */
+  bool write(const TextureData &data) const;
+};
+
+} // namespace netsimulyzer
@@ -47,6 +47,7 @@ public:
     NumberSamples,
     PlaybackTimeStepPreference,
     PlaybackTimeStepUnit,
+    PlaybackRealTime,
     RenderBuildingMode,
     RenderBuildingOutlines,
     RenderCameraType,
@@ -60,7 +61,9 @@ public:
     RenderFloor,
     RenderBackgroundColor,
     RenderBackgroundColorCustom,
+    RenderBoundsPicking,
     ChartDropdownSortOrder,
+    ChartReplotBudget,
     WindowChartWidgets,
     WindowTheme
   };
@@ -214,6 +217,7 @@ private:
       {Key::MainWindowGeometry, {"mainWindow/geometry", {}}},
       {Key::PlaybackTimeStepPreference, {"playback/timeStepPreference", 10'000'000LL}}, // 10ms in nanoseconds
       {Key::PlaybackTimeStepUnit, {"playback/timeStepUnit", "milliseconds"}},
+      {Key::PlaybackRealTime, {"playback/realTime", false}},
       {Key::NumberSamples, {"renderer/numberSamples", 2}},
       {Key::RenderBuildingMode, {"renderer/buildingRenderMode", "transparent"}},
       {Key::RenderBuildingOutlines, {"renderer/showBuildingOutlines", true}},
@@ -228,7 +232,9 @@ private:
       {Key::RenderLabels, {"renderer/showLabels", "enabledOnly"}},
       {Key::RenderMotionTrails, {"renderer/showMotionTrails", "enabledOnly"}},
       {Key::RenderMotionTrailLength, {"renderer/motionTrailLength", 100}},
+      {Key::RenderBoundsPicking, {"renderer/boundsPicking", false}},
       {Key::ChartDropdownSortOrder, {"chart/dropdownSortOrder", "type"}},
+      {Key::ChartReplotBudget, {"chart/replotBudget", 4}}, // milliseconds
       {Key::WindowChartWidgets, {"window/chartWidgets", {}}},
       {Key::WindowTheme, {"window/theme", "dark"}}};
 
@@ -0,0 +1,138 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <glm/vec3.hpp>
+#include <model.h>
+#include <optional>
+#include <unordered_map>
+
+namespace netsimulyzer::keyframe {
+
+/**
+ * The state of a single Node at a keyframe
+ */
+struct NodeState {
+  /**
+   * Position in ns-3 coordinates.
+   * The Node applies its own offset when restored
+   */
+  parser::Ns3Coordinate position;
+
+  /**
+   * Rotation in the same form as `Model::getRotate()`
+   */
+  glm::vec3 orientation{0.0f};
+
+  std::optional<glm::vec3> baseColor;
+  std::optional<glm::vec3> highlightColor;
+
+  /**
+   * Index of the model path in the owning widget's
+   * interned model list, so each keyframe does not
+   * store a copy of every path
+   */
+  std::size_t model{0u};
+
+  /**
+   * The transmission in progress at the keyframe.
+   * Unset if the Node is not transmitting
+   */
+  std::optional<parser::TransmitEvent> transmit;
+};
+
+/**
+ * The state of a single Decoration at a keyframe
+ */
+struct DecorationState {
+  /**
+   * Position in render coordinates
+   */
+  glm::vec3 position{0.0f};
+
+  /**
+   * Rotation in the same form as `Model::getRotate()`
+   */
+  glm::vec3 orientation{0.0f};
+};
+
+/**
+ * Snapshot of the mutable scene state
+ * after the first `eventIndex` scene events are applied
+ */
+struct SceneKeyframe {
+  /**
+   * True if this holds the state of everything in the scene.
+   * Otherwise, it only holds what changed since the previous keyframe
+   */
+  bool complete{true};
+
+  /**
+   * Time of the last event applied before this keyframe
+   */
+  parser::nanoseconds time;
+
+  /**
+   * Number of events applied to reach this keyframe.
+   * Also the index of the next event to apply after restoring it
+   */
+  std::size_t eventIndex;
+
+  std::unordered_map<unsigned int, NodeState> nodes;
+  std::unordered_map<unsigned int, DecorationState> decorations;
+  std::unordered_map<parser::LogicalLink::LinkId, parser::LogicalLink> logicalLinks;
+
+  /**
+   * Replace the state in this keyframe with any in `changes`
+   *
+   * @param changes
+   * A later keyframe
+   */
+  void apply(const SceneKeyframe &changes) {
+    time = changes.time;
+    eventIndex = changes.eventIndex;
+
+    for (const auto &[id, state] : changes.nodes)
+      nodes.insert_or_assign(id, state);
+
+    for (const auto &[id, state] : changes.decorations)
+      decorations.insert_or_assign(id, state);
+
+    for (const auto &[id, link] : changes.logicalLinks)
+      logicalLinks.insert_or_assign(id, link);
+  }
+};
+
+} // namespace netsimulyzer::keyframe
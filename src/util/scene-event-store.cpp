@@ -0,0 +1,161 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "scene-event-store.h"
+#include <algorithm>
+#include <utility>
+
+namespace netsimulyzer {
+
+uint32_t SceneEventStore::internModel(const std::string &model) {
+  // Models change rarely, and few distinct models are used,
+  // so a linear search is fine here
+  const auto iter = std::find(models.begin(), models.end(), model);
+  if (iter != models.end())
+    return static_cast<uint32_t>(iter - models.begin());
+
+  models.emplace_back(model);
+  return static_cast<uint32_t>(models.size() - 1u);
+}
+
+uint32_t SceneEventStore::linkChange(Tag tag, uint64_t id, uint32_t index) {
+  auto &last = lastChanges[static_cast<std::size_t>(tag)];
+  const auto [iter, inserted] = last.try_emplace(id, index);
+  if (inserted)
+    return noChange;
+
+  return std::exchange(iter->second, index);
+}
+
+void SceneEventStore::append(std::vector<parser::SceneEvent> &&events) {
+  const auto newSize = tags.size() + events.size();
+  tags.reserve(newSize);
+  times.reserve(newSize);
+  slots.reserve(newSize);
+  previousChanges.reserve(newSize);
+
+  for (auto &event : events) {
+    const auto index = static_cast<uint32_t>(tags.size());
+    tags.emplace_back(static_cast<Tag>(event.index()));
+
+    std::visit(
+        [this, index](auto &&e) {
+          using T = std::decay_t<decltype(e)>;
+          times.emplace_back(e.time);
+
+          // Slot in the array for `T`, and the last event which changed the same thing
+          uint32_t slot;
+          uint32_t previous{noChange};
+
+          if constexpr (std::is_same_v<T, parser::MoveEvent>) {
+            slot = static_cast<uint32_t>(moves.size());
+            moves.emplace_back(MoveRecord{e.nodeId, e.targetPosition});
+            previous = linkChange(Tag::Move, e.nodeId, index);
+          } else if constexpr (std::is_same_v<T, parser::NodeModelChangeEvent>) {
+            slot = static_cast<uint32_t>(modelChanges.size());
+            modelChanges.emplace_back(NodeModelChangeRecord{e.nodeId, internModel(e.model)});
+            previous = linkChange(Tag::NodeModelChange, e.nodeId, index);
+          } else if constexpr (std::is_same_v<T, parser::TransmitEvent>) {
+            slot = static_cast<uint32_t>(transmits.size());
+            transmits.emplace_back(e);
+          } else if constexpr (std::is_same_v<T, parser::TransmitEndEvent>) {
+            slot = static_cast<uint32_t>(transmitEnds.size());
+            transmitEnds.emplace_back(e);
+          } else if constexpr (std::is_same_v<T, parser::NodeOrientationChangeEvent>) {
+            slot = static_cast<uint32_t>(orientationChanges.size());
+            orientationChanges.emplace_back(NodeOrientationChangeRecord{e.nodeId, e.targetOrientation});
+            previous = linkChange(Tag::NodeOrientationChange, e.nodeId, index);
+          } else if constexpr (std::is_same_v<T, parser::NodeColorChangeEvent>) {
+            slot = static_cast<uint32_t>(colorChanges.size());
+            colorChanges.emplace_back(e);
+
+            // The base & highlight colors are separate properties
+            const auto colorId = (static_cast<uint64_t>(e.nodeId) << 1u) |
+                                 (e.type == parser::NodeColorChangeEvent::ColorType::Highlight ? 1u : 0u);
+            previous = linkChange(Tag::NodeColorChange, colorId, index);
+          } else if constexpr (std::is_same_v<T, parser::DecorationMoveEvent>) {
+            slot = static_cast<uint32_t>(decorationMoves.size());
+            decorationMoves.emplace_back(DecorationMoveRecord{e.decorationId, e.targetPosition});
+            previous = linkChange(Tag::DecorationMove, e.decorationId, index);
+          } else if constexpr (std::is_same_v<T, parser::DecorationOrientationChangeEvent>) {
+            slot = static_cast<uint32_t>(decorationOrientationChanges.size());
+            decorationOrientationChanges.emplace_back(
+                DecorationOrientationChangeRecord{e.decorationId, e.targetOrientation});
+            previous = linkChange(Tag::DecorationOrientationChange, e.decorationId, index);
+          } else if constexpr (std::is_same_v<T, parser::LogicalLinkCreate>) {
+            slot = static_cast<uint32_t>(linkCreates.size());
+            linkCreates.emplace_back(e);
+
+            // Creating a link replaces any existing one,
+            // so creates & updates change the same thing
+            previous = linkChange(Tag::LogicalLinkUpdate, e.model.id, index);
+          } else if constexpr (std::is_same_v<T, parser::LogicalLinkUpdate>) {
+            slot = static_cast<uint32_t>(linkUpdates.size());
+            linkUpdates.emplace_back(e);
+            previous = linkChange(Tag::LogicalLinkUpdate, e.id, index);
+          }
+
+          slots.emplace_back(slot);
+          previousChanges.emplace_back(previous);
+        },
+        event);
+  }
+
+  // The source events are no longer needed,
+  // release them now rather than when the caller's vector goes out of scope
+  events.clear();
+  events.shrink_to_fit();
+}
+
+void SceneEventStore::clear() {
+  tags.clear();
+  times.clear();
+  slots.clear();
+  previousChanges.clear();
+  moves.clear();
+  modelChanges.clear();
+  transmits.clear();
+  transmitEnds.clear();
+  orientationChanges.clear();
+  colorChanges.clear();
+  decorationMoves.clear();
+  decorationOrientationChanges.clear();
+  linkCreates.clear();
+  linkUpdates.clear();
+  models.clear();
+
+  for (auto &last : lastChanges)
+    last.clear();
+}
+
+} // namespace netsimulyzer
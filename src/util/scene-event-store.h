@@ -0,0 +1,343 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <model.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Storage for the scene events, split by type.
+ *
+ * Rather than one `parser::SceneEvent` per slot (which are all as large as the
+ * largest event), the type & time of every event are kept in their own arrays,
+ * and the rest of each event is packed in an array for its type.
+ * Model paths are interned, so each distinct path is only stored once.
+ *
+ * The store is immutable once filled. Each event is linked to the earlier event
+ * which changed the same property of the same entity, so the state before any
+ * event may be found without recording it during playback
+ */
+class SceneEventStore {
+public:
+  /**
+   * The type of each stored event.
+   * Matches the order of the `parser::SceneEvent` alternatives
+   */
+  enum class Tag : uint8_t {
+    Move,
+    NodeModelChange,
+    Transmit,
+    TransmitEnd,
+    NodeOrientationChange,
+    NodeColorChange,
+    DecorationMove,
+    DecorationOrientationChange,
+    LogicalLinkCreate,
+    LogicalLinkUpdate
+  };
+
+  static constexpr std::size_t tagCount = std::variant_size_v<parser::SceneEvent>;
+
+  /**
+   * A `parser::NodeModelChangeEvent`, as given by `visit()`.
+   * The model path refers to the store's interned copy,
+   * so visiting the event does not copy the path
+   */
+  struct NodeModelChange {
+    parser::nanoseconds time;
+    uint32_t nodeId;
+    std::string_view model;
+  };
+
+private:
+  /**
+   * Marks an event with no earlier change in `previousChanges`
+   */
+  static constexpr uint32_t noChange = std::numeric_limits<uint32_t>::max();
+
+  struct MoveRecord {
+    uint32_t nodeId;
+    parser::Ns3Coordinate targetPosition;
+  };
+
+  struct NodeModelChangeRecord {
+    uint32_t nodeId;
+
+    /**
+     * Index into `models`
+     */
+    uint32_t model;
+  };
+
+  struct NodeOrientationChangeRecord {
+    uint32_t nodeId;
+    std::array<double, 3> targetOrientation;
+  };
+
+  struct DecorationMoveRecord {
+    uint32_t decorationId;
+    parser::Ns3Coordinate targetPosition;
+  };
+
+  struct DecorationOrientationChangeRecord {
+    uint32_t decorationId;
+    std::array<double, 3> targetOrientation;
+  };
+
+  std::vector<Tag> tags;
+  std::vector<parser::nanoseconds> times;
+
+  /**
+   * The index of each event in the array for its type
+   */
+  std::vector<uint32_t> slots;
+
+  /**
+   * The index of the last event before each one which changed the same
+   * property of the same entity, or `noChange` if there was none
+   */
+  std::vector<uint32_t> previousChanges;
+
+  // The common events are stored without their time,
+  // the less common ones are kept whole
+  std::vector<MoveRecord> moves;
+  std::vector<NodeModelChangeRecord> modelChanges;
+  std::vector<parser::TransmitEvent> transmits;
+  std::vector<parser::TransmitEndEvent> transmitEnds;
+  std::vector<NodeOrientationChangeRecord> orientationChanges;
+  std::vector<parser::NodeColorChangeEvent> colorChanges;
+  std::vector<DecorationMoveRecord> decorationMoves;
+  std::vector<DecorationOrientationChangeRecord> decorationOrientationChanges;
+  std::vector<parser::LogicalLinkCreate> linkCreates;
+  std::vector<parser::LogicalLinkUpdate> linkUpdates;
+
+  /**
+   * Interned model paths from `parser::NodeModelChangeEvent`s
+   */
+  std::vector<std::string> models;
+
+  /**
+   * The index of the last event to change each property, by entity.
+   * Indexed by the tag of the event which changes the property.
+   * Kept between `append()` calls, so later events link to earlier ones
+   */
+  std::array<std::unordered_map<uint64_t, uint32_t>, tagCount> lastChanges;
+
+  /**
+   * Find the index of `model` in `models`, adding it if it is not present
+   *
+   * @param model
+   * The model path to intern
+   *
+   * @return
+   * The index of `model` in `models`
+   */
+  uint32_t internModel(const std::string &model);
+
+  /**
+   * Record the event at `index` as the last to change
+   * the property `tag` of entity `id`
+   *
+   * @param tag
+   * The property changed. Events which change the same property share a tag
+   *
+   * @param id
+   * The entity changed, unique within `tag`
+   *
+   * @param index
+   * The index of the event
+   *
+   * @return
+   * The previous event to change the same property, or `noChange`
+   */
+  uint32_t linkChange(Tag tag, uint64_t id, uint32_t index);
+
+public:
+  /**
+   * Add events to the end of the store
+   *
+   * @param events
+   * The events to add, sorted by time, and after any events already stored
+   */
+  void append(std::vector<parser::SceneEvent> &&events);
+
+  /**
+   * Remove all events
+   */
+  void clear();
+
+  [[nodiscard]] std::size_t size() const {
+    return tags.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return tags.empty();
+  }
+
+  /**
+   * Get every model path used by a `parser::NodeModelChangeEvent` in the store
+   *
+   * @return
+   * The distinct model paths, in the order they first appear
+   */
+  [[nodiscard]] const std::vector<std::string> &getModels() const {
+    return models;
+  }
+
+  /**
+   * Get the time of the event at `index`
+   *
+   * @param index
+   * The index of the event in time order. Must be less than `size()`
+   *
+   * @return
+   * The time the event should be run
+   */
+  [[nodiscard]] parser::nanoseconds time(std::size_t index) const {
+    return times[index];
+  }
+
+  /**
+   * Find the last event before the one at `index` that changed the same
+   * property (e.g. the position, model, or a color) of the same Node, Decoration,
+   * or Logical Link.
+   * The value it set is the value of that property before the event at `index`.
+   *
+   * Transmit events do not link to any earlier events
+   *
+   * @param index
+   * The index of the event in time order. Must be less than `size()`
+   *
+   * @return
+   * The index of the earlier event, or an unset optional
+   * if the event at `index` is the first to change the property
+   */
+  [[nodiscard]] std::optional<std::size_t> previousChange(std::size_t index) const {
+    const auto previous = previousChanges[index];
+    if (previous == noChange)
+      return {};
+
+    return previous;
+  }
+
+  /**
+   * Call `visitor` with the event at `index`,
+   * in the same form as the `parser::SceneEvent` it was stored from.
+   * Model changes are given as a `NodeModelChange` instead
+   *
+   * @param index
+   * The index of the event in time order. Must be less than `size()`
+   *
+   * @param visitor
+   * Callable accepting a const reference to every scene event type
+   *
+   * @return
+   * The result of `visitor`
+   */
+  template <class Visitor>
+  decltype(auto) visit(std::size_t index, Visitor &&visitor) const {
+    const auto time = times[index];
+    const auto slot = slots[index];
+
+    switch (tags[index]) {
+    case Tag::Move: {
+      const auto &record = moves[slot];
+      return visitor(parser::MoveEvent{time, record.nodeId, record.targetPosition});
+    }
+    case Tag::NodeModelChange: {
+      const auto &record = modelChanges[slot];
+      return visitor(NodeModelChange{time, record.nodeId, models[record.model]});
+    }
+    case Tag::Transmit:
+      return visitor(transmits[slot]);
+    case Tag::TransmitEnd:
+      return visitor(transmitEnds[slot]);
+    case Tag::NodeOrientationChange: {
+      const auto &record = orientationChanges[slot];
+      return visitor(parser::NodeOrientationChangeEvent{time, record.nodeId, record.targetOrientation});
+    }
+    case Tag::NodeColorChange:
+      return visitor(colorChanges[slot]);
+    case Tag::DecorationMove: {
+      const auto &record = decorationMoves[slot];
+      return visitor(parser::DecorationMoveEvent{time, record.decorationId, record.targetPosition});
+    }
+    case Tag::DecorationOrientationChange: {
+      const auto &record = decorationOrientationChanges[slot];
+      return visitor(parser::DecorationOrientationChangeEvent{time, record.decorationId, record.targetOrientation});
+    }
+    case Tag::LogicalLinkCreate:
+      return visitor(linkCreates[slot]);
+    case Tag::LogicalLinkUpdate:
+    default:
+      return visitor(linkUpdates[slot]);
+    }
+  }
+
+  /**
+   * Get the event at `index` as a `T`
+   *
+   * @tparam T
+   * The type of the event. Must match the type of the stored event
+   *
+   * @param index
+   * The index of the event in time order. Must be less than `size()`
+   *
+   * @return
+   * The event at `index`, or a default `T` if the event is of another type
+   */
+  template <class T>
+  [[nodiscard]] T get(std::size_t index) const {
+    return visit(index, [](auto &&e) -> T {
+      if constexpr (std::is_same_v<std::decay_t<decltype(e)>, T>)
+        return e;
+      else
+        return {};
+    });
+  }
+};
+
+} // namespace netsimulyzer
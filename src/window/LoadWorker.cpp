@@ -1,5 +1,27 @@
 #include "LoadWorker.h"
 #include <QElapsedTimer>
+#include <QStandardPaths>
+#include <filesystem>
+#include <thread>
+
+namespace {
+
+/**
+ * Get the directory to keep scenario caches in
+ *
+ * @return
+ * The directory, or an empty path if there
+ * is no cache location for this platform
+ */
+std::filesystem::path cacheDirectory() {
+  const auto location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (location.isEmpty())
+    return {};
+
+  return std::filesystem::path{location.toStdU16String()} / "scenarios";
+}
+
+} // namespace
 
 namespace netsimulyzer {
 
@@ -7,6 +29,8 @@ void LoadWorker::load(const QString &fileName) {
   QElapsedTimer timer;
 
   parser.reset();
+  parser.setEventThreads(std::thread::hardware_concurrency());
+  parser.setCacheDirectory(cacheDirectory());
 
   timer.start();
   auto parseError = parser.parse(fileName.toStdString().c_str());
@@ -20,8 +44,8 @@ void LoadWorker::load(const QString &fileName) {
   emit fileLoaded(fileName, elapsed);
 }
 
-parser::FileParser &LoadWorker::getParser() {
-  return parser;
+parser::ParseResult LoadWorker::takeResult() {
+  return parser.takeResult();
 }
 
 } // namespace netsimulyzer
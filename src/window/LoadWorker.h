@@ -10,7 +10,14 @@ class LoadWorker : public QObject {
   parser::FileParser parser;
 
 public:
-  [[nodiscard]] parser::FileParser &getParser();
+  /**
+   * Move the results of the last successful load out of the worker.
+   * Only call after `fileLoaded` has been emitted
+   *
+   * @return
+   * Everything read from the loaded file
+   */
+  [[nodiscard]] parser::ParseResult takeResult();
 public slots:
   void load(const QString &fileName);
 signals:
@@ -46,6 +46,7 @@
 #include <parser/file-parser.h>
 #include <parser/model.h>
 #include <project.h>
+#include <utility>
 
 namespace {
 /**
@@ -104,6 +105,8 @@ MainWindow::MainWindow() : QMainWindow() {
   cameraGroup.addAction(&arcBallCameraAction);
   ui.menuCamera->addAction(&firstPersonCameraAction);
   ui.menuCamera->addAction(&arcBallCameraAction);
+  ui.menuCamera->addSeparator();
+  ui.menuCamera->addAction(ui.actionCullingStats);
 
   QObject::connect(&cameraGroup, &QActionGroup::triggered, [this](const QAction *action) {
     SettingsManager::CameraType type;
@@ -124,6 +127,7 @@ MainWindow::MainWindow() : QMainWindow() {
   QObject::connect(&scene, &SceneWidget::timeChanged, this, &MainWindow::timeChanged);
   QObject::connect(&scene, &SceneWidget::timeChanged, &charts, &ChartManager::timeChanged);
   QObject::connect(&scene, &SceneWidget::timeChanged, &logWidget, &ScenarioLogWidget::timeChanged);
+  QObject::connect(&logWidget, &ScenarioLogWidget::seekRequested, &scene, &SceneWidget::setTime);
   QObject::connect(&scene, &SceneWidget::timeChanged,
                    [this](parser::nanoseconds time, parser::nanoseconds /* increment */) {
                      playbackWidget.setTime(time);
@@ -144,6 +148,8 @@ MainWindow::MainWindow() : QMainWindow() {
   QObject::connect(&playbackWidget, &PlaybackWidget::pause, &scene, &SceneWidget::pause);
   // Playback widget value is above user preference in priority
   QObject::connect(&playbackWidget, &PlaybackWidget::timeStepChanged, &scene, &SceneWidget::setTimeStep);
+  QObject::connect(&playbackWidget, &PlaybackWidget::realTimeChanged, &scene, &SceneWidget::setRealTimePlayback);
+  QObject::connect(&scene, &SceneWidget::playbackRateChanged, &playbackWidget, &PlaybackWidget::setPlaybackRate);
 
   QObject::connect(&playbackWidget, &PlaybackWidget::timeSet, &scene, &SceneWidget::setTime);
 
@@ -235,6 +241,10 @@ MainWindow::MainWindow() : QMainWindow() {
     charts.setSortOrder(SettingsManager::ChartDropdownSortOrderFromInt(value));
   });
 
+  QObject::connect(&settingsDialog, &SettingsDialog::chartReplotBudgetChanged, [this](int value) {
+    charts.setReplotBudget(value);
+  });
+
   QObject::connect(&settingsDialog, &SettingsDialog::renderSkyboxChanged, [this](bool enable) {
     scene.setSkyboxRenderState(enable);
   });
@@ -267,6 +277,7 @@ MainWindow::MainWindow() : QMainWindow() {
     scene.setRenderLabels(SettingsManager::LabelRenderModeFromInt(value));
   });
   QObject::connect(&settingsDialog, &SettingsDialog::labelScaleChanged, &scene, &SceneWidget::setLabelScale);
+  QObject::connect(&settingsDialog, &SettingsDialog::boundsPickingChanged, &scene, &SceneWidget::setBoundsPicking);
 
   QObject::connect(&settingsDialog, &SettingsDialog::playKeyChanged, [this](int key) {
     ui.actionPlayPause->setShortcut(QKeySequence{key});
@@ -275,6 +286,7 @@ MainWindow::MainWindow() : QMainWindow() {
   QObject::connect(&settingsDialog, &SettingsDialog::resourcePathChanged, &scene, &SceneWidget::setResourcePath);
 
   QObject::connect(ui.actionResetCameraPosition, &QAction::triggered, &scene, &SceneWidget::resetCamera);
+  QObject::connect(ui.actionCullingStats, &QAction::toggled, &scene, &SceneWidget::setShowCullingStats);
 
   QObject::connect(ui.actionAbout, &QAction::triggered, [this]() {
     scene.pause();
@@ -320,8 +332,10 @@ void MainWindow::load() {
 }
 
 void MainWindow::finishLoading(const QString &fileName, unsigned long long milliseconds) {
-  auto parser = loadWorker.getParser();
-  const auto &config = parser.getConfiguration();
+  // Move, rather than copy, the results out of the worker
+  // so the events are only held once
+  auto result = loadWorker.takeResult();
+  const auto &config = result.configuration;
   scene.setConfiguration(config);
 
   playbackWidget.setMaxTime(config.endTime);
@@ -357,33 +371,27 @@ void MainWindow::finishLoading(const QString &fileName, unsigned long long milli
   playbackWidget.setTimeStep(timeStep, granularity);
 
   // Nodes, Buildings, Decorations
-  const auto &nodes = parser.getNodes();
-  scene.add(parser.getAreas(), parser.getBuildings(), parser.getDecorations(), parser.getLinks(),
-            parser.getLogicalLinks(), parser.getNodes());
+  const auto &nodes = result.nodes;
+  scene.add(result.areas, result.buildings, result.decorations, result.wiredLinks, result.logicalLinks, result.nodes);
 
   for (const auto &node : nodes) {
     nodeWidget.addNode(node);
   }
 
   // Charts
-  charts.addSeries(parser.getXYSeries(), parser.getSeriesCollections(), parser.getCategoryValueSeries());
+  charts.addSeries(result.xySeries, result.seriesCollections, result.categoryValueSeries);
 
   // Log Streams
   logWidget.reset();
-  const auto &logStreams = parser.getLogStreams();
-  for (const auto &logStream : logStreams) {
+  for (const auto &logStream : result.logStreams) {
     logWidget.addStream(logStream);
   }
 
   // Events
-  const auto &sceneEvents = parser.getSceneEvents();
-  scene.enqueueEvents(sceneEvents);
-
-  const auto &chartEvents = parser.getChartsEvents();
-  charts.enqueueEvents(chartEvents);
-
-  const auto &logEvents = parser.getLogEvents();
-  logWidget.enqueueEvents(logEvents);
+  // Each controller takes ownership of its events
+  scene.enqueueEvents(std::move(result.sceneEvents));
+  charts.enqueueEvents(std::move(result.chartEvents), config.endTime);
+  logWidget.enqueueEvents(std::move(result.logEvents));
 
   std::clog << "Scenario loaded in " << milliseconds << "ms\n";
   ui.statusbar->showMessage("Successfully loaded scenario: " + fileName + " in " + QString::number(milliseconds) + "ms",
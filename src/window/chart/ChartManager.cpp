@@ -43,6 +43,8 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
 #include <unordered_set>
 #include <utility>
@@ -187,7 +189,13 @@ ChartManager::~ChartManager() {
 void ChartManager::reset() {
   dropdownElements.clear();
   events.clear();
-  undoEvents.clear();
+  eventIndex = 0u;
+  pointsBefore.clear();
+  clearedData.clear();
+  clearedSizes.clear();
+  replacementData.clear();
+  undonePoints.clear();
+  keyframes.clear();
 
   // Clear the child widgets first
   // since they may be holding on to series
@@ -196,6 +204,7 @@ void ChartManager::reset() {
   }
 
   series.clear();
+  collectionsBySeries.clear();
 }
 
 void ChartManager::setChildrenSeries(const std::vector<DropdownValue> &values) {
@@ -204,21 +213,14 @@ void ChartManager::setChildrenSeries(const std::vector<DropdownValue> &values) {
   }
 }
 
-std::vector<unsigned int> ChartManager::inCollections(unsigned int id) {
-  std::vector<unsigned int> collections;
+const std::vector<unsigned int> &ChartManager::inCollections(unsigned int id) const {
+  static const std::vector<unsigned int> none;
 
-  for (const auto &[key, value] : series) {
-    // We're only concerned about collections
-    // so we can skip everything else
-    if (!std::holds_alternative<SeriesCollectionTie>(value))
-      continue;
-
-    const auto &tieModel = std::get<SeriesCollectionTie>(value).model;
-    if (std::find(tieModel.series.begin(), tieModel.series.end(), id) != tieModel.series.end())
-      collections.emplace_back(tieModel.id);
-  }
+  const auto iter = collectionsBySeries.find(id);
+  if (iter == collectionsBySeries.end())
+    return none;
 
-  return collections;
+  return iter->second;
 }
 
 void ChartManager::updateRange(QCPRange &range, double point) {
@@ -226,23 +228,64 @@ void ChartManager::updateRange(QCPRange &range, double point) {
   range.upper = std::max(range.upper, point);
 }
 
+QVector<QCPCurveData> &ChartManager::undoneFrom(const QCPCurveDataContainer &data) {
+  auto &undone = undonePoints[&data];
+
+  // Playback adds the same points again, so those now in `data` are no longer needed
+  const auto size = static_cast<double>(data.size());
+  while (!undone.isEmpty() && undone.constLast().t < size)
+    undone.removeLast();
+
+  // The points must carry on from the end of `data`
+  if (!undone.isEmpty() && undone.constLast().t != size)
+    undone.clear();
+
+  return undone;
+}
+
+void ChartManager::truncate(QCPCurveDataContainer &data, int size) {
+  if (data.size() <= size)
+    return;
+
+  auto &undone = undoneFrom(data);
+  for (auto i = data.size() - 1; i >= size; i--)
+    undone.append(*(data.constBegin() + i));
+
+  if (size == 0)
+    data.clear();
+  else
+    data.removeAfter(static_cast<double>(size - 1));
+}
+
+void ChartManager::untruncate(QCPCurveDataContainer &data, int size) {
+  if (data.size() >= size)
+    return;
+
+  auto &undone = undoneFrom(data);
+  appendBuffer.clear();
+  while (data.size() + appendBuffer.size() < size && !undone.isEmpty())
+    appendBuffer.append(undone.takeLast());
+
+  data.add(appendBuffer, true);
+}
+
 void ChartManager::notifyDataChanged(const XYSeriesTie &tie) {
   for (const auto widget : chartWidgets) {
     if (widget->getCurrentSeries() == tie.model.id)
-      widget->dataChanged(tie);
+      widget->dataChanged();
   }
 }
 
 void ChartManager::notifyDataChanged(const ChartManager::SeriesCollectionTie &tie) {
   for (const auto widget : chartWidgets) {
     if (widget->getCurrentSeries() == tie.model.id)
-      widget->dataChanged(tie);
+      widget->dataChanged();
   }
 }
 void ChartManager::notifyDataChanged(const ChartManager::CategoryValueTie &tie) {
   for (const auto widget : chartWidgets) {
     if (widget->getCurrentSeries() == tie.model.id)
-      widget->dataChanged(tie);
+      widget->dataChanged();
   }
 }
 
@@ -269,9 +312,9 @@ void ChartManager::timeAdvanced(parser::nanoseconds time) {
         updateRange(s.YRange, e.point.y);
       }
 
-      updateCollectionRanges(e.seriesId, e.point.x, e.point.y);
+      queueCollectionUpdate(s.collectionUpdate, e.point.x, e.point.y);
+      pointsBefore[eventIndex] = s.data->size();
 
-      unsigned int pointCount{0u};
       const auto &connection = s.model.connection;
       if (s.data->size() > 0 && (connection == XYConnection::StepFloor || connection == XYConnection::StepCeiling)) {
         const auto &previous = *(s.data->end() - 1);
@@ -280,22 +323,18 @@ void ChartManager::timeAdvanced(parser::nanoseconds time) {
           s.data->add(QCPCurveData{static_cast<double>(s.data->size()), e.point.x, previous.value});
         else // StepCeiling
           s.data->add(QCPCurveData{static_cast<double>(s.data->size()), previous.key, e.point.y});
-
-        pointCount++;
       }
 
       // Re-pull the size,
       // just in case we added a
       // fake point above
       s.data->add(QCPCurveData{static_cast<double>(s.data->size()), e.point.x, e.point.y});
-      pointCount++;
 
       changedSeries.insert(e.seriesId);
-      const auto collections = inCollections(e.seriesId);
+      const auto &collections = inCollections(e.seriesId);
       changedSeries.insert(collections.begin(), collections.end());
 
-      undoEvents.emplace_back(undo::XYSeriesAddValue{e, pointCount});
-      events.pop_front();
+      eventIndex++;
       return true;
     }
 
@@ -303,59 +342,90 @@ void ChartManager::timeAdvanced(parser::nanoseconds time) {
       using XYConnection = parser::XYSeries::Connection;
       auto &s = std::get<XYSeriesTie>(series[e.seriesId]);
 
-      std::pair<double, double> range;
-      range.first = static_cast<double>(s.data->size());
+      const auto size = s.data->size();
+      pointsBefore[eventIndex] = size;
 
+      // Ranges of the whole batch, applied once
+      QCPRange xBounds{e.points.front().x, e.points.front().x};
+      QCPRange yBounds{e.points.front().y, e.points.front().y};
+      for (const auto &point : e.points) {
+        xBounds.lower = std::min(xBounds.lower, point.x);
+        xBounds.upper = std::max(xBounds.upper, point.x);
+        yBounds.lower = std::min(yBounds.lower, point.y);
+        yBounds.upper = std::max(yBounds.upper, point.y);
+      }
+
+      if (s.model.xAxis.boundMode == BoundMode::HighestValue) {
+        updateRange(s.XRange, xBounds.lower);
+        updateRange(s.XRange, xBounds.upper);
+      }
+      if (s.model.yAxis.boundMode == BoundMode::HighestValue) {
+        updateRange(s.YRange, yBounds.lower);
+        updateRange(s.YRange, yBounds.upper);
+      }
+      queueCollectionUpdate(s.collectionUpdate, xBounds.lower, yBounds.lower);
+      queueCollectionUpdate(s.collectionUpdate, xBounds.upper, yBounds.upper);
+
+      // Build the points, with any step points between them, in order
+      // so they may be appended to the series at once
       const auto &connection = s.model.connection;
       const auto isFloorOrCeiling = connection == XYConnection::StepFloor || connection == XYConnection::StepCeiling;
-      for (const auto &point : e.points) {
-        if (s.model.xAxis.boundMode == BoundMode::HighestValue) {
-          updateRange(s.XRange, point.x);
-        }
-        if (s.model.yAxis.boundMode == BoundMode::HighestValue) {
-          updateRange(s.YRange, point.y);
-        }
+      appendBuffer.clear();
 
-        if (s.data->size() > 0 && isFloorOrCeiling) {
-          const auto &previous = *(s.data->end() - 1);
+      auto t = static_cast<double>(size);
+      std::optional<QCPCurveData> previous;
+      if (size > 0)
+        previous = *(s.data->end() - 1);
 
+      for (const auto &point : e.points) {
+        if (previous && isFloorOrCeiling) {
           if (connection == XYConnection::StepFloor)
-            s.data->add(QCPCurveData{static_cast<double>(s.data->size()), point.x, previous.value});
+            appendBuffer.append(QCPCurveData{t++, point.x, previous->value});
           else // StepCeiling
-            s.data->add(QCPCurveData{static_cast<double>(s.data->size()), previous.key, point.y});
+            appendBuffer.append(QCPCurveData{t++, previous->key, point.y});
         }
 
-        updateCollectionRanges(e.seriesId, point.x, point.y);
-        s.data->add({static_cast<double>(s.data->size()), point.x, point.y});
+        previous.emplace(t, point.x, point.y);
+        appendBuffer.append(previous.value());
+        t++;
       }
-      range.second = static_cast<double>(s.data->size());
+
+      s.data->add(appendBuffer, true);
 
       changedSeries.insert(e.seriesId);
-      const auto collections = inCollections(e.seriesId);
+      const auto &collections = inCollections(e.seriesId);
       changedSeries.insert(collections.begin(), collections.end());
 
-      undoEvents.emplace_back(undo::XYSeriesAddValues{e, range});
-      events.pop_front();
+      eventIndex++;
       return true;
     }
 
     if constexpr (std::is_same_v<T, parser::XYSeriesClear>) {
       // Not const since we replace the data pointer
       auto &s = std::get<XYSeriesTie>(series[e.seriesId]);
-      auto oldData = s.data;
-      s.data = QSharedPointer<QCPCurveDataContainer>{new QCPCurveDataContainer{}};
+      const auto clearIndex = pointsBefore[eventIndex];
+      clearedData[clearIndex] = s.data;
+      clearedSizes[clearIndex] = s.data->size();
+
+      // Reuse the data from the last time this event was applied, if any,
+      // since keyframes past here may refer to it
+      auto &replacement = replacementData[clearIndex];
+      if (replacement)
+        truncate(*replacement, 0);
+      else
+        replacement.reset(new QCPCurveDataContainer{});
+
+      s.data = replacement;
 
       changedSeries.insert(e.seriesId);
-      const auto collections = inCollections(e.seriesId);
+      const auto &collections = inCollections(e.seriesId);
       changedSeries.insert(collections.begin(), collections.end());
 
-      undoEvents.emplace_back(undo::XYSeriesClear{e, oldData});
-      events.pop_front();
+      eventIndex++;
       return true;
     }
 
     if constexpr (std::is_same_v<T, parser::CategorySeriesAddValue>) {
-      // Not const since we change the lastUpdatedTime
       auto &s = std::get<CategoryValueTie>(series[e.seriesId]);
       if (s.model.xAxis.boundMode == BoundMode::HighestValue) {
         updateRange(s.XRange, e.value);
@@ -363,14 +433,12 @@ void ChartManager::timeAdvanced(parser::nanoseconds time) {
 
       // Y axis on category charts is a fixed size
 
-      s.lastUpdatedTime = time;
-      const auto pointIndex = static_cast<double>(s.data->size());
-      s.data->add({pointIndex, e.value, static_cast<double>(e.category)});
-      updateCollectionRanges(e.seriesId, e.value, e.category);
+      pointsBefore[eventIndex] = s.data->size();
+      s.data->add({static_cast<double>(s.data->size()), e.value, static_cast<double>(e.category)});
+      queueCollectionUpdate(s.collectionUpdate, e.value, e.category);
 
       changedSeries.insert(e.seriesId);
-      undoEvents.emplace_back(undo::CategorySeriesAddValue{e, pointIndex});
-      events.pop_front();
+      eventIndex++;
       return true;
     }
 
@@ -378,50 +446,23 @@ void ChartManager::timeAdvanced(parser::nanoseconds time) {
     return false;
   };
 
-  while (!events.empty() && std::visit(handleEvent, events.front())) {
+  while (eventIndex < events.size() && std::visit(handleEvent, events[eventIndex])) {
     // Intentionally Blank
   }
 
-  // Add "Fake Events" to keep the category value series moving
-  // TODO: Maybe move to parse time
-  for (auto &[key, s] : series) {
-    // Only CategoryValueSeries may have auto-appended values
-    if (!std::holds_alternative<CategoryValueTie>(s))
-      continue;
-
-    auto &value = std::get<CategoryValueTie>(s);
-    if (!value.model.autoUpdate)
-      continue;
-
-    const auto &points = value.data;
-    if (points->isEmpty())
-      continue;
-
-    if (time - value.lastUpdatedTime < value.model.autoUpdateInterval)
-      continue;
-
-    const auto lastValue = *(points->end() - 1);
-    parser::CategorySeriesAddValue fakeEvent;
-    fakeEvent.time = time;
-    fakeEvent.value = lastValue.key + value.model.autoUpdateIncrement;
-    fakeEvent.category = static_cast<unsigned int>(lastValue.value);
-    fakeEvent.seriesId = key;
-
-    if (value.model.xAxis.boundMode == BoundMode::HighestValue) {
-      updateRange(value.XRange, fakeEvent.value);
-    }
-
-    // Y axis on category charts is a fixed size
-
-    changedSeries.insert(value.model.id);
-
-    const auto pointIndex = static_cast<double>(points->size());
-    points->add({pointIndex, fakeEvent.value, static_cast<double>(fakeEvent.category)});
-
-    updateCollectionRanges(fakeEvent.seriesId, fakeEvent.value, fakeEvent.category);
-    undoEvents.emplace_back(undo::CategorySeriesAddValue{fakeEvent, pointIndex});
+  // Apply the points added this frame to the collections
+  // & summaries, once per series, before any are drawn
+  for (const auto changedSeriesId : changedSeries) {
+    std::visit(
+        [changedSeriesId, this](auto &&tie) {
+          using T = std::decay_t<decltype(tie)>;
+          if constexpr (!std::is_same_v<T, SeriesCollectionTie>)
+            updateCollectionRanges(changedSeriesId, tie.collectionUpdate);
 
-    value.lastUpdatedTime = time;
+          if constexpr (std::is_same_v<T, XYSeriesTie>)
+            tie.lod.sync(tie.data);
+        },
+        series[changedSeriesId]);
   }
 
   for (const auto changedSeriesId : changedSeries) {
@@ -431,12 +472,15 @@ void ChartManager::timeAdvanced(parser::nanoseconds time) {
         },
         series[changedSeriesId]);
   }
+
+  if (!keyframes.empty() && keyframes.back().eventIndex + keyframeInterval <= eventIndex)
+    recordKeyframe(time);
 }
 
 void ChartManager::timeRewound(parser::nanoseconds time) {
   std::unordered_set<uint32_t> changedSeries;
 
-  auto handleUndoEvent = [time, &changedSeries, this](auto &&e) -> bool {
+  auto undoEvent = [time, &changedSeries, this](auto &&e) -> bool {
     // Strip off qualifiers, etc
     // so T holds just the type
     // so we can more easily match it
@@ -445,63 +489,50 @@ void ChartManager::timeRewound(parser::nanoseconds time) {
     // All events have a time
     // Make sure we don't handle one
     // Before it was originally applied
-    if (time > e.event.time)
+    if (time > e.time)
       return false;
 
-    if constexpr (std::is_same_v<T, undo::XYSeriesAddValue>) {
-      auto &s = std::get<XYSeriesTie>(series[e.event.seriesId]);
-
-      for (auto i = 0u; i < e.pointCount; i++) {
-        s.data->remove((s.data->end() - 1)->t);
-      }
-
-      changedSeries.insert(e.event.seriesId);
-      const auto collections = inCollections(e.event.seriesId);
-      changedSeries.insert(collections.begin(), collections.end());
+    const auto before = pointsBefore[eventIndex - 1u];
 
-      events.emplace_front(e.event);
-      return true;
-    }
-
-    if constexpr (std::is_same_v<T, undo::XYSeriesAddValues>) {
-      auto &s = std::get<XYSeriesTie>(series[e.event.seriesId]);
-      s.data->remove(e.tIndexRange.first, e.tIndexRange.second);
+    if constexpr (std::is_same_v<T, parser::XYSeriesAddValue> || std::is_same_v<T, parser::XYSeriesAddValues>) {
+      auto &s = std::get<XYSeriesTie>(series[e.seriesId]);
+      truncate(*s.data, before);
 
-      changedSeries.insert(e.event.seriesId);
-      const auto collections = inCollections(e.event.seriesId);
+      changedSeries.insert(e.seriesId);
+      const auto &collections = inCollections(e.seriesId);
       changedSeries.insert(collections.begin(), collections.end());
-
-      events.emplace_front(e.event);
       return true;
     }
 
-    if constexpr (std::is_same_v<T, undo::XYSeriesClear>) {
-      auto &s = std::get<XYSeriesTie>(series[e.event.seriesId]);
-      s.data = e.oldData;
+    if constexpr (std::is_same_v<T, parser::XYSeriesClear>) {
+      auto &s = std::get<XYSeriesTie>(series[e.seriesId]);
+      s.data = clearedData[before];
+      untruncate(*s.data, clearedSizes[before]);
 
-      changedSeries.insert(e.event.seriesId);
-      const auto collections = inCollections(e.event.seriesId);
+      changedSeries.insert(e.seriesId);
+      const auto &collections = inCollections(e.seriesId);
       changedSeries.insert(collections.begin(), collections.end());
-
-      events.emplace_front(e.event);
       return true;
     }
 
-    if constexpr (std::is_same_v<T, undo::CategorySeriesAddValue>) {
-      auto &s = std::get<CategoryValueTie>(series[e.event.seriesId]);
-
-      s.data->remove(e.pointIndex);
+    if constexpr (std::is_same_v<T, parser::CategorySeriesAddValue>) {
+      auto &s = std::get<CategoryValueTie>(series[e.seriesId]);
+      truncate(*s.data, before);
 
-      changedSeries.insert(e.event.seriesId);
-      events.emplace_front(e.event);
+      changedSeries.insert(e.seriesId);
       return true;
     }
 
     return false;
   };
 
-  while (!undoEvents.empty() && std::visit(handleUndoEvent, undoEvents.back())) {
-    undoEvents.pop_back();
+  while (eventIndex > 0u && std::visit(undoEvent, events[eventIndex - 1u])) {
+    eventIndex--;
+  }
+
+  for (const auto changedSeriesId : changedSeries) {
+    if (auto tie = std::get_if<XYSeriesTie>(&series[changedSeriesId]))
+      tie->lod.sync(tie->data);
   }
 
   for (const auto changedSeriesId : changedSeries) {
@@ -513,6 +544,92 @@ void ChartManager::timeRewound(parser::nanoseconds time) {
   }
 }
 
+void ChartManager::recordKeyframe(parser::nanoseconds time) {
+  Keyframe keyframe;
+  keyframe.time = time;
+  keyframe.eventIndex = eventIndex;
+  keyframe.series.reserve(series.size());
+
+  for (const auto &[id, tie] : series) {
+    SeriesKeyframeState state;
+    std::visit(
+        [&state](auto &&value) {
+          using T = std::decay_t<decltype(value)>;
+
+          state.XRange = value.XRange;
+          state.YRange = value.YRange;
+
+          if constexpr (!std::is_same_v<T, SeriesCollectionTie>) {
+            state.data = value.data;
+            state.size = value.data->size();
+          }
+        },
+        tie);
+
+    keyframe.series.try_emplace(id, state);
+  }
+
+  keyframes.emplace_back(std::move(keyframe));
+}
+
+std::vector<ChartManager::Keyframe>::iterator ChartManager::findKeyframe(parser::nanoseconds time) {
+  auto iter =
+      std::upper_bound(keyframes.begin(), keyframes.end(), time, [](parser::nanoseconds value, const Keyframe &keyframe) {
+        return value < keyframe.time;
+      });
+
+  if (iter == keyframes.begin())
+    return keyframes.end();
+
+  return iter - 1;
+}
+
+void ChartManager::restoreKeyframe(std::vector<Keyframe>::iterator keyframe, parser::nanoseconds time) {
+  for (const auto &[id, state] : keyframe->series) {
+    auto iter = series.find(id);
+    if (iter == series.end())
+      continue;
+
+    std::visit(
+        [&state, this](auto &&tie) {
+          using T = std::decay_t<decltype(tie)>;
+
+          tie.XRange = state.XRange;
+          tie.YRange = state.YRange;
+
+          if constexpr (!std::is_same_v<T, SeriesCollectionTie>) {
+            // Category series are never cleared,
+            // so only XY series may have a different container
+            if constexpr (std::is_same_v<T, XYSeriesTie>)
+              tie.data = state.data;
+
+            // Points are indexed by `t` in the order they were added,
+            // so everything after the keyframe is at the end
+            if (tie.data->size() > state.size)
+              truncate(*tie.data, state.size);
+            else
+              untruncate(*tie.data, state.size);
+          }
+
+          if constexpr (std::is_same_v<T, XYSeriesTie>)
+            tie.lod.sync(tie.data);
+        },
+        iter->second);
+  }
+
+  eventIndex = keyframe->eventIndex;
+
+  for (auto &[id, tie] : series) {
+    std::visit(
+        [this](auto &&value) {
+          notifyDataChanged(value);
+        },
+        tie);
+  }
+
+  timeAdvanced(time);
+}
+
 void ChartManager::spawnWidget(QMainWindow *parent) {
   auto newWidget = new ChartWidget{parent, *this, dropdownElements};
   parent->addDockWidget(Qt::RightDockWidgetArea, newWidget);
@@ -534,28 +651,42 @@ void ChartManager::widgetClosed(ChartWidget *widget) {
   chartWidgets.erase(std::remove(chartWidgets.begin(), chartWidgets.end(), widget), chartWidgets.end());
 }
 
-void ChartManager::updateCollectionRanges(unsigned int seriesId, double x, double y) {
+void ChartManager::queueCollectionUpdate(CollectionUpdate &update, double x, double y) {
+  if (update.XRange)
+    updateRange(update.XRange.value(), x);
+  else
+    update.XRange.emplace(x, x);
+
+  if (update.YRange)
+    updateRange(update.YRange.value(), y);
+  else
+    update.YRange.emplace(y, y);
+}
+
+void ChartManager::updateCollectionRanges(unsigned int seriesId, CollectionUpdate &update) {
   using BoundMode = parser::ValueAxis::BoundMode;
 
-  for (auto &[key, value] : series) {
-    // We're only concerned about collections
-    // so we can skip everything else
-    if (!std::holds_alternative<SeriesCollectionTie>(value))
-      continue;
+  // Nothing added since the last update
+  if (!update.XRange || !update.YRange)
+    return;
 
+  for (const auto collectionId : inCollections(seriesId)) {
     // Not `const` as we may need to change ranges
-    auto &tie = std::get<SeriesCollectionTie>(value);
+    auto &tie = std::get<SeriesCollectionTie>(series[collectionId]);
     const auto &model = tie.model;
 
-    // If the series isn't in the collection, then we can skip it
-    if (std::find(model.series.begin(), model.series.end(), seriesId) == model.series.end())
-      continue;
-    if (model.xAxis.boundMode == BoundMode::HighestValue)
-      updateRange(tie.XRange, x);
+    if (model.xAxis.boundMode == BoundMode::HighestValue) {
+      updateRange(tie.XRange, update.XRange->lower);
+      updateRange(tie.XRange, update.XRange->upper);
+    }
 
-    if (model.yAxis.boundMode == BoundMode::HighestValue)
-      updateRange(tie.YRange, y);
+    if (model.yAxis.boundMode == BoundMode::HighestValue) {
+      updateRange(tie.YRange, update.YRange->lower);
+      updateRange(tie.YRange, update.YRange->upper);
+    }
   }
+
+  update = {};
 }
 
 ChartManager::TieVariant &ChartManager::getSeries(uint32_t seriesId) {
@@ -583,14 +714,161 @@ ChartManager::XYSeriesTie &ChartManager::getXySeries(unsigned int seriesId) {
 }
 
 void ChartManager::timeChanged(parser::nanoseconds time, parser::nanoseconds increment) {
-  if (increment > 0LL)
-    timeAdvanced(time);
+  if (increment > 0LL) {
+    // Keyframes past the current event are only left from moving back,
+    // jump to one of those rather than applying every event up to it again
+    auto keyframe = keyframes.end();
+    if (!keyframes.empty() && keyframes.back().eventIndex >= eventIndex + keyframeInterval)
+      keyframe = findKeyframe(time);
+
+    if (keyframe != keyframes.end() && keyframe->eventIndex >= eventIndex + keyframeInterval)
+      restoreKeyframe(keyframe, time);
+    else
+      timeAdvanced(time);
+    return;
+  }
+
+  // Undoing a long way back is more expensive than truncating
+  // to a keyframe and playing forward from there
+  const auto keyframe = findKeyframe(time);
+  if (keyframe != keyframes.end() && keyframe->eventIndex + keyframeInterval * 2u <= eventIndex)
+    restoreKeyframe(keyframe, time);
   else
     timeRewound(time);
 }
 
-void ChartManager::enqueueEvents(const std::vector<parser::ChartEvent> &e) {
-  events.insert(events.end(), e.begin(), e.end());
+void ChartManager::generateAutoUpdateEvents(parser::nanoseconds endTime) {
+  // The next value for each auto-updating series,
+  // from the last value added to it
+  struct AutoUpdate {
+    parser::nanoseconds interval;
+    double increment;
+    bool started{false};
+    std::size_t generated{0u};
+    bool capped{false};
+    parser::CategorySeriesAddValue next;
+  };
+
+  std::unordered_map<uint32_t, AutoUpdate> autoUpdates;
+  for (const auto &[id, s] : series) {
+    const auto tie = std::get_if<CategoryValueTie>(&s);
+    // A series which does not move forward would never stop generating values
+    if (!tie || !tie->model.autoUpdate || tie->model.autoUpdateInterval <= 0LL)
+      continue;
+
+    auto interval = tie->model.autoUpdateInterval;
+    if (interval < minimumAutoUpdateInterval) {
+      std::clog << "Warning: auto-update interval for series: " << id << " is shorter than "
+                << minimumAutoUpdateInterval << "ns, using " << minimumAutoUpdateInterval << "ns\n";
+      interval = minimumAutoUpdateInterval;
+    }
+
+    AutoUpdate autoUpdate{interval, tie->model.autoUpdateIncrement};
+    autoUpdate.next.seriesId = id;
+    autoUpdates.try_emplace(id, autoUpdate);
+  }
+
+  if (autoUpdates.empty())
+    return;
+
+  std::vector<parser::ChartEvent> generated;
+
+  // Generate values every `interval` after the last one, up to & including `last`,
+  // unless the series already has `maximumAutoUpdateValues` values
+  auto generateThrough = [this, &generated](AutoUpdate &autoUpdate, parser::nanoseconds last) {
+    auto &next = autoUpdate.next;
+    for (next.time += autoUpdate.interval; next.time <= last; next.time += autoUpdate.interval) {
+      if (autoUpdate.generated == maximumAutoUpdateValues) {
+        autoUpdate.capped = true;
+        return;
+      }
+
+      next.value += autoUpdate.increment;
+      generated.emplace_back(next);
+      autoUpdate.generated++;
+    }
+  };
+
+  for (const auto &event : events) {
+    const auto e = std::get_if<parser::CategorySeriesAddValue>(&event);
+    if (!e)
+      continue;
+
+    const auto iter = autoUpdates.find(e->seriesId);
+    if (iter == autoUpdates.end())
+      continue;
+
+    // A value added on the same time as a generated one replaces it
+    auto &autoUpdate = iter->second;
+    if (autoUpdate.started)
+      generateThrough(autoUpdate, e->time - 1LL);
+
+    autoUpdate.started = true;
+    autoUpdate.next = *e;
+  }
+
+  for (auto &[id, autoUpdate] : autoUpdates) {
+    if (autoUpdate.started)
+      generateThrough(autoUpdate, endTime);
+
+    if (autoUpdate.capped)
+      std::clog << "Warning: auto-update for series: " << id << " stopped after " << maximumAutoUpdateValues
+                << " values\n";
+  }
+
+  if (generated.empty())
+    return;
+
+  const auto eventTime = [](const parser::ChartEvent &event) {
+    return std::visit(
+        [](auto &&e) {
+          return e.time;
+        },
+        event);
+  };
+
+  const auto byTime = [&eventTime](const parser::ChartEvent &left, const parser::ChartEvent &right) {
+    return eventTime(left) < eventTime(right);
+  };
+
+  // Each series' values are in order, but not with each other
+  std::stable_sort(generated.begin(), generated.end(), byTime);
+
+  // Events from the file are applied before generated ones at the same time
+  std::vector<parser::ChartEvent> merged;
+  merged.reserve(events.size() + generated.size());
+  std::merge(std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()),
+             std::make_move_iterator(generated.begin()), std::make_move_iterator(generated.end()),
+             std::back_inserter(merged), byTime);
+
+  events = std::move(merged);
+}
+
+void ChartManager::enqueueEvents(std::vector<parser::ChartEvent> &&e, parser::nanoseconds endTime) {
+  if (events.empty())
+    events = std::move(e);
+  else
+    events.insert(events.end(), std::make_move_iterator(e.begin()), std::make_move_iterator(e.end()));
+
+  generateAutoUpdateEvents(endTime);
+
+  // Reserve a slot for the data replaced by each clear event up front,
+  // so none are allocated during playback
+  pointsBefore.assign(events.size(), 0);
+  std::size_t clearCount{0u};
+  for (std::size_t i = 0u; i < events.size(); i++) {
+    if (std::holds_alternative<parser::XYSeriesClear>(events[i]))
+      pointsBefore[i] = static_cast<int>(clearCount++);
+  }
+  clearedData.assign(clearCount, {});
+  clearedSizes.assign(clearCount, 0);
+  replacementData.assign(clearCount, {});
+  undonePoints.clear();
+
+  // Initial keyframe, so every time has one at or before it
+  keyframes.clear();
+  eventIndex = 0u;
+  recordKeyframe(std::numeric_limits<parser::nanoseconds>::min());
 }
 void ChartManager::addSeries(const std::vector<parser::XYSeries> &xySeries,
                              const std::vector<parser::SeriesCollection> &collections,
@@ -598,6 +876,10 @@ void ChartManager::addSeries(const std::vector<parser::XYSeries> &xySeries,
 
   for (const auto &collection : collections) {
     series.emplace(collection.id, makeTie(collection));
+    for (const auto seriesId : collection.series) {
+      collectionsBySeries[seriesId].emplace_back(collection.id);
+    }
+
     dropdownElements.emplace_back(
         DropdownValue{QString::fromStdString(collection.name), SeriesType::Collection, collection.id});
   }
@@ -628,4 +910,10 @@ void ChartManager::setSortOrder(SettingsManager::ChartDropdownSortOrder value) {
   }
 }
 
+void ChartManager::setReplotBudget(int value) {
+  for (const auto widget : chartWidgets) {
+    widget->setReplotBudget(value);
+  }
+}
+
 } // namespace netsimulyzer
@@ -32,7 +32,7 @@
  */
 
 #pragma once
-#include "src/util/undo-events.h"
+#include "MinMaxPyramid.h"
 #include <QComboBox>
 #include <QFrame>
 #include <QGraphicsItem>
@@ -41,14 +41,15 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <QVector>
 #include <cstdint>
-#include <deque>
 #include <lib/QCustomPlot/qcustomplot.h>
 #include <model.h>
 #include <optional>
 #include <src/settings/SettingsManager.h>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace netsimulyzer {
 
@@ -60,6 +61,16 @@ class ChartManager : public QObject {
 public:
   enum class SeriesType : int { XY, CategoryValue, Collection };
 
+  /**
+   * The range of the points added to a series
+   * since they were last applied to the collections it is in.
+   * Both are unset if no points were added
+   */
+  struct CollectionUpdate {
+    std::optional<QCPRange> XRange;
+    std::optional<QCPRange> YRange;
+  };
+
   struct SeriesCollectionTie {
     parser::SeriesCollection model;
     QCPRange XRange;
@@ -73,7 +84,20 @@ public:
     QSharedPointer<QCPCurveDataContainer> data{new QCPCurveDataContainer{}};
     QCPRange XRange;
     QCPRange YRange;
-    QCPCurve *curve; // Only used when on the plot
+    QCPCurve *curve{nullptr}; // Only used when on the plot
+    CollectionUpdate collectionUpdate;
+
+    /**
+     * Summary of `data`, for drawing it when it is too large
+     * to draw every point. Kept in step with `data` by the `ChartManager`
+     */
+    MinMaxPyramid lod;
+
+    /**
+     * The points from `lod` drawn for the visible range,
+     * when not drawing `data` directly
+     */
+    QSharedPointer<QCPCurveDataContainer> displayData{new QCPCurveDataContainer{}};
   };
 
   struct CategoryValueTie {
@@ -84,7 +108,7 @@ public:
     QSharedPointer<QCPCurveDataContainer> data{new QCPCurveDataContainer{}};
     QCPRange XRange;
     QCPRange YRange; // Fixed range containing the category IDs
-    parser::nanoseconds lastUpdatedTime;
+    CollectionUpdate collectionUpdate;
   };
 
   struct DropdownValue {
@@ -95,14 +119,124 @@ public:
 
   using TieVariant = std::variant<SeriesCollectionTie, XYSeriesTie, CategoryValueTie>;
 
+  /**
+   * The state of a single series at a keyframe
+   */
+  struct SeriesKeyframeState {
+    /**
+     * The data container in use at the keyframe.
+     * Held so data replaced by a clear event may be restored.
+     * Unused for collections
+     */
+    QSharedPointer<QCPCurveDataContainer> data;
+
+    /**
+     * The number of points in `data` at the keyframe
+     */
+    int size{0};
+    QCPRange XRange;
+    QCPRange YRange;
+  };
+
+  /**
+   * Snapshot of every series after the first
+   * `eventIndex` chart events were applied
+   */
+  struct Keyframe {
+    parser::nanoseconds time;
+    std::size_t eventIndex;
+    std::unordered_map<uint32_t, SeriesKeyframeState> series;
+  };
+
   const static unsigned int PlaceholderId{0u};
 
 private:
   SettingsManager settings;
-  std::deque<parser::ChartEvent> events;
-  std::deque<undo::ChartUndoEvent> undoEvents;
+  std::vector<parser::ChartEvent> events;
+
+  /**
+   * Index of the next event in `events` to apply
+   */
+  std::size_t eventIndex{0u};
+
+  /**
+   * The number of points in the affected series before each event in `events`
+   * was applied, so it may be undone by truncating the series.
+   * For `XYSeriesClear` events, this is instead the index in `clearedData` & `clearedSizes`
+   * of the data the event replaced.
+   *
+   * Sized with `events`, so applying events does not allocate
+   */
+  std::vector<int> pointsBefore;
+
+  /**
+   * The data replaced by each `XYSeriesClear` event in `events`
+   */
+  std::vector<QSharedPointer<QCPCurveDataContainer>> clearedData;
+
+  /**
+   * The number of points in the data replaced by each `XYSeriesClear` event,
+   * since restoring a keyframe may have truncated it since
+   */
+  std::vector<int> clearedSizes;
+
+  /**
+   * The data each `XYSeriesClear` event in `events` gave its series.
+   * Reused when the event is applied again,
+   * so keyframes past the event still refer to the series' data
+   */
+  std::vector<QSharedPointer<QCPCurveDataContainer>> replacementData;
+
+  /**
+   * The points removed from each data container by moving back in time, newest first.
+   * Kept so seeking forward to a keyframe may add them back,
+   * rather than applying every event up to it again.
+   * Points added again by playback are dropped when the container is next used
+   */
+  std::unordered_map<const QCPCurveDataContainer *, QVector<QCPCurveData>> undonePoints;
+
+  /**
+   * Points built from a `XYSeriesAddValues` event before they are added
+   * to the series. Kept between events,
+   * so its storage is reused rather than allocated for each
+   */
+  QVector<QCPCurveData> appendBuffer;
+
+  /**
+   * Keyframes recorded during playback, sorted by time.
+   * Since the series data is only built as events are applied,
+   * these are taken as playback passes them, rather than at load.
+   * Those past `eventIndex` are kept after moving back,
+   * so seeking forward may restore them
+   */
+  std::vector<Keyframe> keyframes;
+
+  /**
+   * Number of events between each keyframe
+   */
+  const std::size_t keyframeInterval{10'000u};
+
+  /**
+   * Shortest interval auto-updating series generate values at.
+   * Shorter intervals from the scenario are raised to this
+   */
+  const parser::nanoseconds minimumAutoUpdateInterval{1'000'000LL};
+
+  /**
+   * Most values generated for a single auto-updating series.
+   * Generation stops for a series once it reaches this
+   */
+  const std::size_t maximumAutoUpdateValues{100'000u};
 
   std::unordered_map<uint32_t, TieVariant> series;
+
+  /**
+   * The IDs of the collections each series is in, by series ID.
+   * Series in no collections are not included.
+   * Built in `addSeries()`
+   */
+  std::unordered_map<uint32_t, std::vector<unsigned int>> collectionsBySeries;
+
   SettingsManager::ChartDropdownSortOrder sortOrder{
       settings.get<SettingsManager::ChartDropdownSortOrder>(SettingsManager::Key::ChartDropdownSortOrder).value()};
   std::vector<DropdownValue> dropdownElements;
@@ -111,7 +245,34 @@ private:
   XYSeriesTie makeTie(const parser::XYSeries &model);
   SeriesCollectionTie makeTie(const parser::SeriesCollection &model);
   CategoryValueTie makeTie(const parser::CategoryValueSeries &model);
-  void updateCollectionRanges(unsigned int seriesId, double x, double y);
+
+  /**
+   * Include a point in `update`,
+   * to later be applied by `updateCollectionRanges()`
+   *
+   * @param update
+   * The update of the series the point was added to
+   *
+   * @param x
+   * The X value of the point
+   *
+   * @param y
+   * The Y value of the point
+   */
+  void queueCollectionUpdate(CollectionUpdate &update, double x, double y);
+
+  /**
+   * Expand the ranges of the collections the series
+   * identified by `seriesId` is in to include `update`,
+   * then empty `update`
+   *
+   * @param seriesId
+   * The ID of the series the update is for
+   *
+   * @param update
+   * The points added to the series
+   */
+  void updateCollectionRanges(unsigned int seriesId, CollectionUpdate &update);
   void setChildrenSeries(const std::vector<DropdownValue> &values);
 
   /**
@@ -124,10 +285,47 @@ private:
    * @return
    * The IDs of all the collections `id` is in
    */
-  std::vector<unsigned int> inCollections(unsigned int id);
+  [[nodiscard]] const std::vector<unsigned int> &inCollections(unsigned int id) const;
 
   void updateRange(QCPRange &range, double point);
 
+  /**
+   * Get the points undone from `data` which may still be added back to it.
+   * Points it has since been given again are dropped
+   *
+   * @param data
+   * The container the points were removed from
+   *
+   * @return
+   * The points after the end of `data`, newest first
+   */
+  QVector<QCPCurveData> &undoneFrom(const QCPCurveDataContainer &data);
+
+  /**
+   * Remove points from the end of `data`,
+   * leaving only the first `size`.
+   * The removed points are kept in `undonePoints`
+   *
+   * @param data
+   * The points to truncate, indexed by `t` in the order they were added
+   *
+   * @param size
+   * The number of points to keep
+   */
+  void truncate(QCPCurveDataContainer &data, int size);
+
+  /**
+   * Add points removed by `truncate()` back to `data`,
+   * until it has `size` points or there are none left
+   *
+   * @param data
+   * The points to extend, indexed by `t` in the order they were added
+   *
+   * @param size
+   * The number of points `data` should have
+   */
+  void untruncate(QCPCurveDataContainer &data, int size);
+
   void notifyDataChanged(const XYSeriesTie &tie);
   void notifyDataChanged(const SeriesCollectionTie &tie);
   void notifyDataChanged(const CategoryValueTie &tie);
@@ -135,6 +333,49 @@ private:
   void timeAdvanced(parser::nanoseconds time);
   void timeRewound(parser::nanoseconds time);
 
+  /**
+   * Snapshot the current state of every series
+   *
+   * @param time
+   * The time all events up to `eventIndex` were applied at
+   */
+  void recordKeyframe(parser::nanoseconds time);
+
+  /**
+   * Finds the latest keyframe at or before `time`
+   *
+   * @param time
+   * The time to search for
+   *
+   * @return
+   * An iterator to the keyframe, or `keyframes.end()` if there is none
+   */
+  [[nodiscard]] std::vector<Keyframe>::iterator findKeyframe(parser::nanoseconds time);
+
+  /**
+   * Return every series to `keyframe`, which may be before or after
+   * the current event, then apply the events up to `time`
+   *
+   * @param keyframe
+   * The keyframe to restore. Must be at or before `time`
+   *
+   * @param time
+   * The time to play forward to after restoring
+   */
+  void restoreKeyframe(std::vector<Keyframe>::iterator keyframe, parser::nanoseconds time);
+
+  /**
+   * Add the values auto-updating category series append to `events`.
+   * Each series repeats its last value, plus its increment,
+   * every interval after the last value added to it.
+   * Intervals are at least `minimumAutoUpdateInterval`, and no series
+   * is given more than `maximumAutoUpdateValues` values
+   *
+   * @param endTime
+   * The last time to generate values for
+   */
+  void generateAutoUpdateEvents(parser::nanoseconds endTime);
+
 public:
   explicit ChartManager(QMainWindow *parent);
   ~ChartManager() override;
@@ -165,8 +406,28 @@ public:
   XYSeriesTie &getXySeries(unsigned int seriesId);
 
   void timeChanged(parser::nanoseconds time, parser::nanoseconds increment);
-  void enqueueEvents(const std::vector<parser::ChartEvent> &e);
+  /**
+   * Take ownership of events for the charts.
+   * Values for auto-updating category series are generated
+   * here, as ordinary events
+   *
+   * @param e
+   * The events to add, sorted by time
+   *
+   * @param endTime
+   * The end of the simulation.
+   * Auto-update values are generated up to this time
+   */
+  void enqueueEvents(std::vector<parser::ChartEvent> &&e, parser::nanoseconds endTime);
   void setSortOrder(SettingsManager::ChartDropdownSortOrder value);
+
+  /**
+   * Set the time each child widget may spend replotting
+   *
+   * @param value
+   * The budget, in milliseconds
+   */
+  void setReplotBudget(int value);
 };
 
 } // namespace netsimulyzer
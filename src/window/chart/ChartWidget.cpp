@@ -35,8 +35,12 @@
 #include <QConstOverload>
 #include <QDebug>
 #include <QGraphicsLayout>
+#include <QScreen>
+#include <QSignalBlocker>
 #include <QStandardItemModel>
 #include <QString>
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <variant>
 
@@ -101,8 +105,11 @@ void ChartWidget::showSeries(ChartManager::XYSeriesTie &tie) {
     break;
   }
 
-  // Range
-  ui.chartView->xAxis->setRange(tie.XRange);
+  // Range. The curve is updated below, so the range change need not update it as well
+  {
+    const QSignalBlocker blocker{ui.chartView->xAxis};
+    ui.chartView->xAxis->setRange(tie.XRange);
+  }
   ui.chartView->yAxis->setRange(tie.YRange);
 
   // Label
@@ -118,7 +125,7 @@ void ChartWidget::showSeries(ChartManager::XYSeriesTie &tie) {
 
   const auto name = QString::fromStdString(tie.model.name);
 
-  tie.curve->setData(tie.data);
+  updateCurveData(tie);
   tie.curve->setName(QString::fromStdString(tie.model.legend));
   ui.chartView->title->setText(name);
   setWindowTitle(name);
@@ -148,7 +155,6 @@ void ChartWidget::showSeries(const ChartManager::SeriesCollectionTie &tie) {
     // Color
     series.curve->setPen(series.pen);
 
-    series.curve->setData(series.data);
     series.curve->setName(QString::fromStdString(series.model.legend));
 
     // Point Labels
@@ -179,10 +185,19 @@ void ChartWidget::showSeries(const ChartManager::SeriesCollectionTie &tie) {
     break;
   }
 
-  // Range
-  ui.chartView->xAxis->setRange(tie.XRange);
+  // Range. The curves are updated below, so the range change need not update them as well
+  {
+    const QSignalBlocker blocker{ui.chartView->xAxis};
+    ui.chartView->xAxis->setRange(tie.XRange);
+  }
   ui.chartView->yAxis->setRange(tie.YRange);
 
+  // Data, once the range is known
+  for (auto seriesId : tie.model.series) {
+    if (auto series = std::get_if<ChartManager::XYSeriesTie>(&manager.getSeries(seriesId)))
+      updateCurveData(*series);
+  }
+
   // Label
   ui.chartView->xAxis->setLabel(QString::fromStdString(tie.model.xAxis.name));
   ui.chartView->yAxis->setLabel(QString::fromStdString(tie.model.yAxis.name));
@@ -239,7 +254,47 @@ void ChartWidget::showSeries(const ChartManager::CategoryValueTie &tie) {
   ui.chartView->replot();
 }
 
+void ChartWidget::updateCurveData(const ChartManager::XYSeriesTie &tie) const {
+  const auto xAxis = ui.chartView->xAxis;
+
+  // Pixels are not a fixed width on logarithmic axes,
+  // so always draw every point there
+  if (tie.data->size() <= lodThreshold || xAxis->scaleType() == QCPAxis::stLogarithmic) {
+    if (tie.curve->data() != tie.data)
+      tie.curve->setData(tie.data);
+    return;
+  }
+
+  const auto range = xAxis->range();
+  const auto width = std::max(xAxis->axisRect()->width(), 1);
+  tie.lod.decimate(range, range.size() / width, *tie.displayData);
+
+  if (tie.curve->data() != tie.displayData)
+    tie.curve->setData(tie.displayData);
+}
+
+void ChartWidget::xRangeChanged() const {
+  if (currentSeries == ChartManager::PlaceholderId)
+    return;
+
+  const auto &s = manager.getSeries(currentSeries);
+  if (const auto tie = std::get_if<ChartManager::XYSeriesTie>(&s)) {
+    if (tie->curve)
+      updateCurveData(*tie);
+  } else if (const auto collection = std::get_if<ChartManager::SeriesCollectionTie>(&s)) {
+    for (const auto seriesId : collection->model.series) {
+      const auto series = std::get_if<ChartManager::XYSeriesTie>(&manager.getSeries(seriesId));
+      if (series && series->curve)
+        updateCurveData(*series);
+    }
+  }
+}
+
 void ChartWidget::clearChart() {
+  // Nothing left to draw changes for
+  replotPending = false;
+  replotTimer.stop();
+
   ui.chartView->clearItems();
   ui.chartView->clearPlottables(); // Clears *curve
   pointLabels.clear();             // cleared by `clearItems`
@@ -264,6 +319,15 @@ void ChartWidget::clearChart() {
   ui.chartView->setPlotPlotVisibility(ControlsChartView::PlotVisibility::Hidden);
 }
 
+void ChartWidget::showEvent(QShowEvent *event) {
+  QDockWidget::showEvent(event);
+
+  if (replotPending) {
+    replotTimer.stop();
+    flushReplot();
+  }
+}
+
 void ChartWidget::closeEvent(QCloseEvent *event) {
   clearChart();
   manager.widgetClosed(this);
@@ -282,6 +346,11 @@ ChartWidget::ChartWidget(QWidget *parent, ChartManager &manager, std::vector<Cha
 
   QObject::connect(ui.comboBoxSeries, qOverload<int>(&QComboBox::currentIndexChanged), this,
                    &ChartWidget::seriesSelected);
+  QObject::connect(ui.chartView->xAxis, qOverload<const QCPRange &>(&QCPAxis::rangeChanged), this,
+                   &ChartWidget::xRangeChanged);
+
+  replotTimer.setSingleShot(true);
+  QObject::connect(&replotTimer, &QTimer::timeout, this, &ChartWidget::flushReplot);
 
   setFloating(false);
   setVisible(true);
@@ -402,9 +471,16 @@ void ChartWidget::setSortOrder(SettingsManager::ChartDropdownSortOrder value) {
   populateDropdown();
 }
 
-void ChartWidget::dataChanged(const ChartManager::XYSeriesTie &tie) const {
+void ChartWidget::setReplotBudget(int value) {
+  replotBudget = std::max(value, 1);
+}
+
+void ChartWidget::applyChanges(const ChartManager::XYSeriesTie &tie) const {
   using BoundMode = parser::ValueAxis::BoundMode;
 
+  // The curve is updated below, so the range change need not update it as well
+  const QSignalBlocker blocker{ui.chartView->xAxis};
+
   if (tie.model.xAxis.boundMode == BoundMode::HighestValue && tie.XRange != ui.chartView->xAxis->range()) {
     ui.chartView->xAxis->setRange(tie.XRange);
   }
@@ -418,29 +494,27 @@ void ChartWidget::dataChanged(const ChartManager::XYSeriesTie &tie) const {
     generateLabels(tie.data.get());
   }
 
-  // Handle clear events
-  if (tie.curve->data() != tie.data)
-    tie.curve->setData(tie.data);
+  // Also handles clear events
+  updateCurveData(tie);
 
   ui.chartView->xAxis->ticker()->setTickCount(5);
   ui.chartView->yAxis->ticker()->setTickCount(5);
-
-  ui.chartView->replot();
 }
 
-void ChartWidget::dataChanged(const ChartManager::CategoryValueTie &tie) const {
+void ChartWidget::applyChanges(const ChartManager::CategoryValueTie &tie) const {
   using BoundMode = parser::ValueAxis::BoundMode;
 
   if (tie.model.xAxis.boundMode == BoundMode::HighestValue && tie.XRange != ui.chartView->xAxis->range()) {
     ui.chartView->xAxis->setRange(tie.XRange);
   }
-
-  ui.chartView->replot();
 }
 
-void ChartWidget::dataChanged(const ChartManager::SeriesCollectionTie &tie) const {
+void ChartWidget::applyChanges(const ChartManager::SeriesCollectionTie &tie) const {
   using BoundMode = parser::ValueAxis::BoundMode;
 
+  // The curves are updated below, so the range change need not update them as well
+  const QSignalBlocker blocker{ui.chartView->xAxis};
+
   if (tie.model.xAxis.boundMode == BoundMode::HighestValue && tie.XRange != ui.chartView->xAxis->range()) {
     ui.chartView->xAxis->setRange(tie.XRange);
   }
@@ -453,14 +527,57 @@ void ChartWidget::dataChanged(const ChartManager::SeriesCollectionTie &tie) cons
     // Only XY Series allowed in collections
     auto &childSeries = manager.getXySeries(seriesId);
 
-    // Handle clear events
-    if (childSeries.curve->data() != childSeries.data)
-      childSeries.curve->setData(childSeries.data);
+    // Also handles clear events
+    updateCurveData(childSeries);
 
     clearLabels();
     if (childSeries.model.labelMode == parser::XYSeries::LabelMode::Shown)
       generateLabels(childSeries.data.get());
   }
+}
+
+void ChartWidget::dataChanged() const {
+  replotPending = true;
+
+  if (!replotTimer.isActive())
+    replotTimer.start(replotInterval());
+}
+
+int ChartWidget::replotInterval() const {
+  // Fall back on 60Hz if the screen is unknown
+  auto refreshRate = 60.0;
+  if (const auto currentScreen = screen(); currentScreen && currentScreen->refreshRate() > 0.0)
+    refreshRate = currentScreen->refreshRate();
+
+  const auto frameTime = 1000.0 / refreshRate;
+
+  // Give up frames to plots that take longer
+  // than the budget to draw, so they do not hold up the scene
+  const auto frames = std::max(1.0, std::ceil(ui.chartView->replotTime(true) / replotBudget));
+
+  return static_cast<int>(std::ceil(frameTime * frames));
+}
+
+void ChartWidget::flushReplot() {
+  if (!replotPending)
+    return;
+
+  // Leave the changes pending until the plot may be seen again.
+  // Docked widgets get a `showEvent()` when their tab is selected,
+  // but nothing tells us when the main window is restored, so check back
+  if (!isVisible() || window()->isMinimized() || ui.chartView->visibleRegion().isEmpty()) {
+    replotTimer.start(hiddenRecheckInterval);
+    return;
+  }
+
+  replotPending = false;
+  if (currentSeries != ChartManager::PlaceholderId) {
+    std::visit(
+        [this](const auto &tie) {
+          applyChanges(tie);
+        },
+        manager.getSeries(currentSeries));
+  }
 
   ui.chartView->replot();
 }
@@ -36,8 +36,11 @@
 #include "ChartManager.h"
 #include "ui_ChartWidget.h"
 #include <QDockWidget>
+#include <QShowEvent>
 #include <QString>
+#include <QTimer>
 #include <QWidget>
+#include <algorithm>
 #include <src/settings/SettingsManager.h>
 #include <vector>
 
@@ -55,6 +58,35 @@ class ChartWidget : public QDockWidget {
       settings.get<SettingsManager::ChartDropdownSortOrder>(SettingsManager::Key::ChartDropdownSortOrder).value();
 
   mutable std::vector<QCPItemText *> pointLabels;
+
+  /**
+   * Series with more points than this are drawn
+   * from their `MinMaxPyramid`, rather than every point
+   */
+  const int lodThreshold{10'000};
+
+  /**
+   * Time, in milliseconds, a replot may take.
+   * Plots which take longer are drawn less often
+   */
+  int replotBudget{std::max(settings.get<int>(SettingsManager::Key::ChartReplotBudget).value(), 1)};
+
+  /**
+   * Time, in milliseconds, between checks for
+   * the plot becoming visible while changes are pending
+   */
+  const int hiddenRecheckInterval{250};
+
+  /**
+   * Set when the series has changed since the plot was last drawn
+   */
+  mutable bool replotPending{false};
+
+  /**
+   * Draws pending changes, at most once per frame
+   */
+  mutable QTimer replotTimer;
+
   void seriesSelected(int index);
   void showSeries(ChartManager::XYSeriesTie &tie);
   void showSeries(const ChartManager::SeriesCollectionTie &tie);
@@ -65,10 +97,46 @@ class ChartWidget : public QDockWidget {
    */
   void clearChart();
 
+  /**
+   * Give the curve of `tie` the points to draw for the visible range.
+   * Large series are reduced to about two points per pixel
+   *
+   * @param tie
+   * The series to update. Must be on the plot
+   */
+  void updateCurveData(const ChartManager::XYSeriesTie &tie) const;
+
+  /**
+   * Update the points drawn for the visible
+   * series after the X axis is moved or zoomed
+   */
+  void xRangeChanged() const;
+
+  void applyChanges(const ChartManager::XYSeriesTie &tie) const;
+  void applyChanges(const ChartManager::CategoryValueTie &tie) const;
+  void applyChanges(const ChartManager::SeriesCollectionTie &tie) const;
+
+  /**
+   * Time to wait before drawing pending changes.
+   * One frame of the current screen, extended by
+   * however many frames past `replotBudget` the last replots took
+   *
+   * @return
+   * The interval, in milliseconds
+   */
+  [[nodiscard]] int replotInterval() const;
+
+  /**
+   * Apply pending changes to the current series & replot.
+   * Does nothing while the plot cannot be seen
+   */
+  void flushReplot();
+
   void generateLabels(const QCPCurveDataContainer *data) const;
   void clearLabels() const;
 
 protected:
+  void showEvent(QShowEvent *event) override;
   void closeEvent(QCloseEvent *event) override;
 
 public:
@@ -79,9 +147,21 @@ public:
   void reset();
   void setSortOrder(SettingsManager::ChartDropdownSortOrder value);
 
-  void dataChanged(const ChartManager::XYSeriesTie &tie) const;
-  void dataChanged(const ChartManager::CategoryValueTie &tie) const;
-  void dataChanged(const ChartManager::SeriesCollectionTie &tie) const;
+  /**
+   * Set the time each replot may take
+   * before the plot is drawn less often
+   *
+   * @param value
+   * The budget, in milliseconds
+   */
+  void setReplotBudget(int value);
+
+  /**
+   * Signals the current series has changed.
+   * The changes are drawn with the next frame,
+   * so many changes in a frame only replot once
+   */
+  void dataChanged() const;
 
   /**
    * Unselects the current series
@@ -0,0 +1,216 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "MinMaxPyramid.h"
+#include <algorithm>
+
+namespace netsimulyzer {
+
+void MinMaxPyramid::append(int index) {
+  const auto &point = *source->at(index);
+
+  if (levels.empty())
+    levels.emplace_back();
+
+  auto span = leafSize;
+  for (auto &level : levels) {
+    const auto bucketIndex = static_cast<std::size_t>(index / span);
+    if (bucketIndex == level.size()) {
+      level.push_back({point.key, point.key, point.value, point.value, index, index});
+    } else {
+      auto &bucket = level[bucketIndex];
+      bucket.minX = std::min(bucket.minX, point.key);
+      bucket.maxX = std::max(bucket.maxX, point.key);
+
+      if (point.value < bucket.minY) {
+        bucket.minY = point.value;
+        bucket.minIndex = index;
+      }
+      if (point.value > bucket.maxY) {
+        bucket.maxY = point.value;
+        bucket.maxIndex = index;
+      }
+    }
+    span *= fanOut;
+  }
+
+  // Add a level once the top has more than one `fanOut` of buckets,
+  // so there are always only a few buckets to start from
+  if (levels.back().size() > static_cast<std::size_t>(fanOut)) {
+    const auto below = levels.size() - 1u;
+    const auto bucketCount = (levels[below].size() + fanOut - 1u) / fanOut;
+    levels.emplace_back(bucketCount);
+    for (auto i = 0u; i < bucketCount; i++)
+      rebuild(below + 1u, i);
+  }
+}
+
+void MinMaxPyramid::truncate(int newSize) {
+  size = newSize;
+  if (size == 0) {
+    levels.clear();
+    return;
+  }
+
+  auto span = leafSize;
+  for (auto i = 0u; i < levels.size(); i++) {
+    auto &level = levels[i];
+    level.resize((size + span - 1) / span);
+
+    // The last bucket may have lost points
+    rebuild(i, level.size() - 1u);
+    span *= fanOut;
+  }
+
+  while (levels.size() > 1u && levels[levels.size() - 2u].size() <= static_cast<std::size_t>(fanOut))
+    levels.pop_back();
+}
+
+void MinMaxPyramid::rebuild(std::size_t level, std::size_t index) {
+  auto &bucket = levels[level][index];
+
+  if (level == 0u) {
+    const auto first = static_cast<int>(index) * leafSize;
+    const auto last = std::min(first + leafSize, size);
+
+    const auto &point = *source->at(first);
+    bucket = {point.key, point.key, point.value, point.value, first, first};
+    for (auto i = first + 1; i < last; i++) {
+      const auto &p = *source->at(i);
+      bucket.minX = std::min(bucket.minX, p.key);
+      bucket.maxX = std::max(bucket.maxX, p.key);
+
+      if (p.value < bucket.minY) {
+        bucket.minY = p.value;
+        bucket.minIndex = i;
+      }
+      if (p.value > bucket.maxY) {
+        bucket.maxY = p.value;
+        bucket.maxIndex = i;
+      }
+    }
+    return;
+  }
+
+  const auto &below = levels[level - 1u];
+  const auto first = index * fanOut;
+  const auto last = std::min(first + fanOut, below.size());
+
+  bucket = below[first];
+  for (auto i = first + 1u; i < last; i++) {
+    const auto &child = below[i];
+    bucket.minX = std::min(bucket.minX, child.minX);
+    bucket.maxX = std::max(bucket.maxX, child.maxX);
+
+    if (child.minY < bucket.minY) {
+      bucket.minY = child.minY;
+      bucket.minIndex = child.minIndex;
+    }
+    if (child.maxY > bucket.maxY) {
+      bucket.maxY = child.maxY;
+      bucket.maxIndex = child.maxIndex;
+    }
+  }
+}
+
+void MinMaxPyramid::sync(const QSharedPointer<QCPCurveDataContainer> &data) {
+  if (source != data) {
+    clear();
+    source = data;
+  } else if (data->size() < size)
+    truncate(data->size());
+
+  while (size < data->size())
+    append(size++);
+}
+
+void MinMaxPyramid::visit(std::size_t level, std::size_t index, const QCPRange &xRange, double resolution,
+                          QCPCurveDataContainer &out) const {
+  const auto &bucket = levels[level][index];
+
+  const auto visible = bucket.maxX >= xRange.lower && bucket.minX <= xRange.upper;
+  if (!visible || bucket.maxX - bucket.minX <= resolution) {
+    addBucket(bucket, out);
+    return;
+  }
+
+  // Wider than a pixel, and no more detail to give,
+  // so draw every point
+  if (level == 0u) {
+    const auto first = static_cast<int>(index) * leafSize;
+    const auto last = std::min(first + leafSize, size);
+    for (auto i = first; i < last; i++) {
+      const auto &point = *source->at(i);
+      out.add({static_cast<double>(out.size()), point.key, point.value});
+    }
+    return;
+  }
+
+  const auto &below = levels[level - 1u];
+  const auto last = std::min((index + 1u) * fanOut, below.size());
+  for (auto i = index * fanOut; i < last; i++)
+    visit(level - 1u, i, xRange, resolution, out);
+}
+
+void MinMaxPyramid::addBucket(const Bucket &bucket, QCPCurveDataContainer &out) const {
+  // Keep the points in the order they were added,
+  // so lines are drawn the same way
+  const auto first = std::min(bucket.minIndex, bucket.maxIndex);
+  const auto second = std::max(bucket.minIndex, bucket.maxIndex);
+
+  const auto &firstPoint = *source->at(first);
+  out.add({static_cast<double>(out.size()), firstPoint.key, firstPoint.value});
+
+  if (first != second) {
+    const auto &secondPoint = *source->at(second);
+    out.add({static_cast<double>(out.size()), secondPoint.key, secondPoint.value});
+  }
+}
+
+void MinMaxPyramid::decimate(const QCPRange &xRange, double resolution, QCPCurveDataContainer &out) const {
+  out.clear();
+  if (levels.empty())
+    return;
+
+  const auto top = levels.size() - 1u;
+  for (auto i = 0u; i < levels[top].size(); i++)
+    visit(top, i, xRange, resolution, out);
+}
+
+void MinMaxPyramid::clear() {
+  source.clear();
+  size = 0;
+  levels.clear();
+}
+
+} // namespace netsimulyzer
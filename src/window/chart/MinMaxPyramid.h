@@ -0,0 +1,150 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include <QSharedPointer>
+#include <lib/QCustomPlot/qcustomplot.h>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Multi-resolution minimum/maximum summary of the points in a curve,
+ * used to draw large series with about two points per pixel.
+ *
+ * Each level splits the points, in the order they were added,
+ * into buckets holding the range of X values & the points with the
+ * lowest & highest Y values. Buckets in the lowest level hold
+ * `leafSize` points, each level above combines two buckets from the one below
+ */
+class MinMaxPyramid {
+  struct Bucket {
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+
+    /**
+     * Index of the point with the lowest Y value
+     */
+    int minIndex;
+
+    /**
+     * Index of the point with the highest Y value
+     */
+    int maxIndex;
+  };
+
+  /**
+   * Number of points in each bucket in the lowest level
+   */
+  static constexpr int leafSize{64};
+
+  /**
+   * Number of buckets combined into one in the level above
+   */
+  static constexpr int fanOut{2};
+
+  /**
+   * The container the pyramid was built from.
+   * Held so a replaced container is never mistaken for it
+   */
+  QSharedPointer<QCPCurveDataContainer> source;
+
+  /**
+   * The number of points from `source` in the pyramid
+   */
+  int size{0};
+
+  /**
+   * The buckets of each level, from the lowest
+   */
+  std::vector<std::vector<Bucket>> levels;
+
+  /**
+   * Include the point at `index` in `source`
+   * in every level
+   */
+  void append(int index);
+
+  /**
+   * Remove the points after the first `newSize`
+   */
+  void truncate(int newSize);
+
+  /**
+   * Rebuild the bucket at `index` in `level`
+   * from the level below, or the points for the lowest level
+   */
+  void rebuild(std::size_t level, std::size_t index);
+
+  void visit(std::size_t level, std::size_t index, const QCPRange &xRange, double resolution,
+             QCPCurveDataContainer &out) const;
+  void addBucket(const Bucket &bucket, QCPCurveDataContainer &out) const;
+
+public:
+  /**
+   * Bring the pyramid up to date with `data`.
+   * Points added since the last call are appended, and points removed
+   * are trimmed. If `data` is a different container than the last call,
+   * the pyramid is rebuilt
+   *
+   * @param data
+   * The points, indexed by `t` in the order they were added
+   */
+  void sync(const QSharedPointer<QCPCurveDataContainer> &data);
+
+  /**
+   * Select the points to draw for the visible `xRange`.
+   * Groups of points narrower than `resolution` are reduced to
+   * their lowest & highest points. Points outside `xRange` are
+   * kept coarsely, so lines leaving the view still point the right way
+   *
+   * @param xRange
+   * The visible range of the X axis
+   *
+   * @param resolution
+   * The width of a pixel, in X axis units
+   *
+   * @param out
+   * Cleared, then filled with the points to draw
+   */
+  void decimate(const QCPRange &xRange, double resolution, QCPCurveDataContainer &out) const;
+
+  /**
+   * Remove all points, and release the held container
+   */
+  void clear();
+};
+
+} // namespace netsimulyzer
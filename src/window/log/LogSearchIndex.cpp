@@ -0,0 +1,248 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "LogSearchIndex.h"
+#include <algorithm>
+#include <iterator>
+#include <variant>
+
+namespace {
+
+bool isWordCharacter(char c) {
+  const auto value = static_cast<unsigned char>(c);
+  return (value >= '0' && value <= '9') || (value >= 'a' && value <= 'z') || (value >= 'A' && value <= 'Z') ||
+         value == '_' || value >= 0x80u;
+}
+
+char toLower(char c) {
+  if (c >= 'A' && c <= 'Z')
+    return static_cast<char>(c - 'A' + 'a');
+  return c;
+}
+
+/**
+ * Check if `text` contains `lowerNeedle`, ignoring the case of `text`
+ */
+bool containsIgnoreCase(std::string_view text, std::string_view lowerNeedle) {
+  const auto iter = std::search(text.begin(), text.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                                [](char left, char right) {
+                                  return toLower(left) == right;
+                                });
+  return iter != text.end() || lowerNeedle.empty();
+}
+
+} // namespace
+
+namespace netsimulyzer {
+
+std::vector<std::string> LogSearchIndex::tokenize(std::string_view text) {
+  std::vector<std::string> words;
+
+  std::size_t i = 0u;
+  while (i < text.size()) {
+    while (i < text.size() && !isWordCharacter(text[i]))
+      i++;
+
+    const auto start = i;
+    while (i < text.size() && isWordCharacter(text[i]))
+      i++;
+
+    if (i > start) {
+      auto &word = words.emplace_back(text.substr(start, i - start));
+      std::transform(word.begin(), word.end(), word.begin(), toLower);
+    }
+  }
+
+  return words;
+}
+
+LogSearchIndex LogSearchIndex::build(const std::vector<parser::LogEvent> &events, const std::atomic<bool> &cancelled) {
+  LogSearchIndex index;
+
+  // The line each stream is writing, which has not ended yet
+  struct OpenLine {
+    uint32_t lineIndex;
+
+    /**
+     * The text so far, once a second event has written to the line
+     */
+    std::string text;
+  };
+  std::unordered_map<unsigned int, OpenLine> openLines;
+
+  // Lines are indexed when they end,
+  // so their words may be listed after later lines
+  bool postingsSorted{true};
+
+  auto indexWords = [&index](uint32_t lineIndex, std::string_view text) {
+    for (auto &word : tokenize(text)) {
+      auto &posting = index.postings[std::move(word)];
+
+      // Only list a line once, even if it repeats a word
+      if (posting.empty() || posting.back() != lineIndex)
+        posting.emplace_back(lineIndex);
+    }
+  };
+
+  auto endLine = [&index, &indexWords, &postingsSorted, &events](OpenLine &open) {
+    auto &line = index.lines[open.lineIndex];
+    if (open.lineIndex + 1u != index.lines.size())
+      postingsSorted = false;
+
+    if (open.text.empty()) {
+      const auto &value = std::get<parser::StreamAppendEvent>(events[line.eventIndex]).value;
+      indexWords(open.lineIndex, std::string_view{value}.substr(line.offset, line.length));
+      return;
+    }
+
+    line.joined = true;
+    line.offset = static_cast<uint32_t>(index.joinedText.size());
+    line.length = static_cast<uint32_t>(open.text.size());
+    index.joinedText.append(open.text);
+    indexWords(open.lineIndex, open.text);
+  };
+
+  for (std::size_t eventIndex = 0u; eventIndex < events.size(); eventIndex++) {
+    if (eventIndex % 4096u == 0u && cancelled.load(std::memory_order_relaxed))
+      break;
+
+    const auto &event = std::get<parser::StreamAppendEvent>(events[eventIndex]);
+    const auto &value = event.value;
+
+    std::size_t offset = 0u;
+    while (offset < value.size()) {
+      auto lineEnd = value.find('\n', offset);
+      const auto ended = lineEnd != std::string::npos;
+      if (!ended)
+        lineEnd = value.size();
+
+      const auto segment = std::string_view{value}.substr(offset, lineEnd - offset);
+      auto open = openLines.find(event.streamId);
+      if (open == openLines.end()) {
+        // Lines with no text have nothing to find
+        if (!segment.empty()) {
+          const auto lineIndex = static_cast<uint32_t>(index.lines.size());
+          index.lines.emplace_back(Line{static_cast<uint32_t>(eventIndex), static_cast<uint32_t>(offset),
+                                        static_cast<uint32_t>(segment.size()), false});
+          open = openLines.try_emplace(event.streamId, OpenLine{lineIndex, {}}).first;
+        }
+      } else if (!segment.empty()) {
+        // Continues a line from an earlier event
+        auto &text = open->second.text;
+        if (text.empty()) {
+          const auto &line = index.lines[open->second.lineIndex];
+          const auto &first = std::get<parser::StreamAppendEvent>(events[line.eventIndex]).value;
+          text.assign(first, line.offset, line.length);
+        }
+
+        text.append(segment);
+      }
+
+      if (ended && open != openLines.end()) {
+        endLine(open->second);
+        openLines.erase(open);
+      }
+
+      offset = lineEnd + 1u;
+    }
+  }
+
+  // The last line of each stream need not end with a newline
+  for (auto &[streamId, open] : openLines)
+    endLine(open);
+
+  if (!openLines.empty() || !postingsSorted) {
+    for (auto &[word, posting] : index.postings)
+      std::sort(posting.begin(), posting.end());
+  }
+
+  return index;
+}
+
+std::vector<LogSearchIndex::Hit> LogSearchIndex::find(const std::vector<parser::LogEvent> &events,
+                                                      std::string_view query, std::size_t maxHits) const {
+  std::vector<Hit> hits;
+
+  // Search with the rarest word first,
+  // so the fewest lines are compared
+  std::vector<const std::vector<uint32_t> *> wordLines;
+  for (const auto &word : tokenize(query)) {
+    const auto iter = postings.find(word);
+    if (iter == postings.end())
+      return hits;
+
+    wordLines.emplace_back(&iter->second);
+  }
+
+  if (wordLines.empty())
+    return hits;
+
+  std::sort(wordLines.begin(), wordLines.end(), [](const auto left, const auto right) {
+    return left->size() < right->size();
+  });
+
+  std::vector<uint32_t> candidates{*wordLines.front()};
+  std::vector<uint32_t> next;
+  for (auto i = 1u; i < wordLines.size() && !candidates.empty(); i++) {
+    next.clear();
+    std::set_intersection(candidates.begin(), candidates.end(), wordLines[i]->begin(), wordLines[i]->end(),
+                          std::back_inserter(next));
+    candidates.swap(next);
+  }
+
+  // Lines with every word may still have them in another order,
+  // or as part of longer words, so check for the whole query
+  std::string lowerQuery{query};
+  std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), toLower);
+
+  for (const auto lineIndex : candidates) {
+    if (hits.size() >= maxHits)
+      break;
+
+    const auto &line = lines[lineIndex];
+    const auto &event = std::get<parser::StreamAppendEvent>(events[line.eventIndex]);
+    const auto text = line.joined ? std::string_view{joinedText}.substr(line.offset, line.length)
+                                  : std::string_view{event.value}.substr(line.offset, line.length);
+
+    if (containsIgnoreCase(text, lowerQuery))
+      hits.emplace_back(Hit{line.eventIndex, event.time, event.streamId, text});
+  }
+
+  return hits;
+}
+
+std::size_t LogSearchIndex::lineCount() const {
+  return lines.size();
+}
+
+} // namespace netsimulyzer
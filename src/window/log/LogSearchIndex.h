@@ -0,0 +1,158 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <model.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Inverted index of the words in the lines of log events,
+ * for finding lines without scanning every event.
+ * Lines are assembled per stream, as the log shows them,
+ * so a line may be written by several events.
+ *
+ * Words are runs of letters, digits, '_' & non-ASCII characters,
+ * compared without case
+ */
+class LogSearchIndex {
+public:
+  /**
+   * A line matching a query
+   */
+  struct Hit {
+    /**
+     * Index of the event which started the line
+     */
+    std::size_t eventIndex;
+
+    parser::nanoseconds time;
+    unsigned int streamId;
+
+    /**
+     * The text of the line, without the newline
+     */
+    std::string_view text;
+  };
+
+private:
+  /**
+   * A line of a stream
+   */
+  struct Line {
+    /**
+     * The event which started the line
+     */
+    uint32_t eventIndex;
+
+    /**
+     * Where the text of the line starts. In the value of the event
+     * if the whole line is from that event, otherwise in `joinedText`
+     */
+    uint32_t offset;
+    uint32_t length;
+    bool joined;
+  };
+
+  std::vector<Line> lines;
+
+  /**
+   * The text of the lines written by more than one event
+   */
+  std::string joinedText;
+
+  /**
+   * The indices in `lines` containing each word, in ascending order
+   */
+  std::unordered_map<std::string, std::vector<uint32_t>> postings;
+
+  /**
+   * Split `text` into lowercase words
+   *
+   * @param text
+   * The text to split
+   *
+   * @return
+   * Each word in `text`, in order
+   */
+  static std::vector<std::string> tokenize(std::string_view text);
+
+public:
+  /**
+   * Index every line in `events`
+   *
+   * @param events
+   * The events to index. Must be the same events passed to `find()`
+   *
+   * @param cancelled
+   * Checked while building. Once set, the index is left partially built
+   *
+   * @return
+   * The index
+   */
+  static LogSearchIndex build(const std::vector<parser::LogEvent> &events, const std::atomic<bool> &cancelled);
+
+  /**
+   * Find the lines containing `query`, ignoring case
+   *
+   * @param events
+   * The events the index was built from
+   *
+   * @param query
+   * The text to search for. Must contain at least one word
+   *
+   * @param maxHits
+   * The most lines to return
+   *
+   * @return
+   * The first `maxHits` matching lines, in the order they were logged.
+   * The text of each refers to `events` or this index
+   */
+  [[nodiscard]] std::vector<Hit> find(const std::vector<parser::LogEvent> &events, std::string_view query,
+                                      std::size_t maxHits) const;
+
+  /**
+   * @return
+   * The number of lines indexed
+   */
+  [[nodiscard]] std::size_t lineCount() const;
+};
+
+} // namespace netsimulyzer
@@ -0,0 +1,192 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "LogStore.h"
+#include <utility>
+
+namespace netsimulyzer {
+
+LogStore::Line &LogStore::at(std::size_t index) {
+  return chunks[index / chunkSize][index % chunkSize];
+}
+
+void LogStore::pushLine(parser::nanoseconds time, unsigned int streamId) {
+  if (size % chunkSize == 0u) {
+    auto &chunk = chunks.emplace_back();
+    chunk.reserve(chunkSize);
+  }
+
+  chunks.back().emplace_back(Line{time, streamId, {}});
+  size++;
+}
+
+bool LogStore::hasAfterEnd() const {
+  return size > end.lines || line(size - 1u).text.size() > end.column;
+}
+
+bool LogStore::replay(parser::nanoseconds time, unsigned int streamId, QStringView text) {
+  const auto &last = line(end.lines - 1u);
+
+  // An empty line is started by whoever writes to it first
+  if (end.column == 0 && (last.time != time || last.streamId != streamId))
+    return false;
+
+  if (!QStringView{last.text}.mid(end.column).startsWith(text))
+    return false;
+
+  end.column += static_cast<int>(text.size());
+  return true;
+}
+
+void LogStore::breakLine(parser::nanoseconds time, unsigned int streamId) {
+  // The line after the end may be started again,
+  // if the last line ends where the end does
+  if (end.lines < size && line(end.lines - 1u).text.size() == end.column) {
+    end.lines++;
+    end.column = 0;
+    return;
+  }
+
+  discardAfterEnd();
+  pushLine(time, streamId);
+  end.lines++;
+  end.column = 0;
+}
+
+void LogStore::discardAfterEnd() {
+  if (size == end.lines && at(size - 1u).text.size() == end.column)
+    return;
+
+  while (size > end.lines) {
+    auto &chunk = chunks.back();
+    chunk.pop_back();
+    size--;
+
+    if (chunk.empty())
+      chunks.pop_back();
+  }
+
+  at(size - 1u).text.truncate(end.column);
+}
+
+LogStore::LogStore() {
+  clear();
+}
+
+void LogStore::append(parser::nanoseconds time, unsigned int streamId, const QString &text) {
+  qsizetype start = 0;
+  while (start <= text.size()) {
+    auto lineEnd = text.indexOf('\n', start);
+    if (lineEnd == -1)
+      lineEnd = text.size();
+
+    if (start > 0)
+      breakLine(time, streamId);
+
+    if (lineEnd > start) {
+      const auto segment = QStringView{text}.mid(start, lineEnd - start);
+      if (hasAfterEnd()) {
+        if (replay(time, streamId, segment)) {
+          start = lineEnd + 1;
+          continue;
+        }
+
+        discardAfterEnd();
+      }
+
+      auto &last = at(size - 1u);
+
+      // The line belongs to whoever writes to it first
+      if (last.text.isEmpty()) {
+        last.time = time;
+        last.streamId = streamId;
+      }
+
+      last.text.append(segment);
+      end.column = static_cast<int>(last.text.size());
+    }
+
+    start = lineEnd + 1;
+  }
+}
+
+void LogStore::newLine(parser::nanoseconds time, unsigned int streamId) {
+  if (atLineStart())
+    return;
+
+  breakLine(time, streamId);
+}
+
+bool LogStore::atLineStart() const {
+  return end.column == 0;
+}
+
+LogStore::Cursor LogStore::getEnd() const {
+  return end;
+}
+
+void LogStore::setEnd(Cursor cursor) {
+  end = cursor;
+}
+
+std::size_t LogStore::lineCount() const {
+  return end.lines;
+}
+
+const LogStore::Line &LogStore::line(std::size_t index) const {
+  return chunks[index / chunkSize][index % chunkSize];
+}
+
+int LogStore::lineLength(std::size_t index) const {
+  if (index + 1u == end.lines)
+    return end.column;
+
+  return static_cast<int>(line(index).text.size());
+}
+
+QString LogStore::lineText(std::size_t index) const {
+  const auto &text = line(index).text;
+  if (index + 1u == end.lines)
+    return text.left(end.column);
+
+  return text;
+}
+
+void LogStore::clear() {
+  chunks.clear();
+  size = 0u;
+  end = {};
+  pushLine(0LL, 0u);
+}
+
+} // namespace netsimulyzer
@@ -0,0 +1,244 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+#include <QString>
+#include <cstddef>
+#include <model.h>
+#include <vector>
+
+namespace netsimulyzer {
+
+/**
+ * Append-only store of log text, split into lines.
+ *
+ * Lines are kept in fixed size chunks, so appending never moves
+ * the lines already stored. Only the lines before the end cursor
+ * are part of the log, so moving back in time only moves the cursor.
+ * Appending the same text again moves the cursor over the lines past it,
+ * so an earlier end may be returned to.
+ * Those lines are discarded by the first append which differs from them
+ */
+class LogStore {
+public:
+  struct Line {
+    /**
+     * The time of the event which started the line
+     */
+    parser::nanoseconds time{0LL};
+
+    /**
+     * The ID of the stream which started the line
+     */
+    unsigned int streamId{0u};
+
+    QString text;
+  };
+
+  /**
+   * The end of the log
+   */
+  struct Cursor {
+    /**
+     * The number of lines in the log.
+     * Never 0, since there is always a line to append to
+     */
+    std::size_t lines{1u};
+
+    /**
+     * The number of characters of the last line in the log
+     */
+    int column{0};
+  };
+
+private:
+  /**
+   * Number of lines in each chunk
+   */
+  static constexpr std::size_t chunkSize{4096u};
+
+  /**
+   * Every line stored, including those past `end`.
+   * Each chunk is reserved to `chunkSize` when created,
+   * so lines are never moved
+   */
+  std::vector<std::vector<Line>> chunks;
+
+  /**
+   * Number of lines in `chunks`
+   */
+  std::size_t size{0u};
+
+  Cursor end;
+
+  [[nodiscard]] Line &at(std::size_t index);
+
+  void pushLine(parser::nanoseconds time, unsigned int streamId);
+
+  /**
+   * @return
+   * True if there is text stored past `end`
+   */
+  [[nodiscard]] bool hasAfterEnd() const;
+
+  /**
+   * Move `end` over `text`, if it is the text stored right after `end`
+   *
+   * @param time
+   * The time of the event the text is from
+   *
+   * @param streamId
+   * The ID of the stream the text is from
+   *
+   * @param text
+   * The text to move over. Must not contain a newline
+   *
+   * @return
+   * True if `end` was moved,
+   * false if `text` differs from what is stored
+   */
+  bool replay(parser::nanoseconds time, unsigned int streamId, QStringView text);
+
+  /**
+   * Move `end` to the start of a new line,
+   * reusing the stored line after it if there is one
+   *
+   * @param time
+   * The time of the event requiring the new line
+   *
+   * @param streamId
+   * The ID of the stream requiring the new line
+   */
+  void breakLine(parser::nanoseconds time, unsigned int streamId);
+
+  /**
+   * Discard everything past `end`
+   */
+  void discardAfterEnd();
+
+public:
+  LogStore();
+
+  /**
+   * Append `text` to the end of the log.
+   * Newlines in `text` start new lines
+   *
+   * @param time
+   * The time of the event the text is from
+   *
+   * @param streamId
+   * The ID of the stream the text is from
+   *
+   * @param text
+   * The text to append
+   */
+  void append(parser::nanoseconds time, unsigned int streamId, const QString &text);
+
+  /**
+   * Start a new line, if the last line is not empty
+   *
+   * @param time
+   * The time of the event requiring the new line
+   *
+   * @param streamId
+   * The ID of the stream requiring the new line
+   */
+  void newLine(parser::nanoseconds time, unsigned int streamId);
+
+  /**
+   * @return
+   * True if the last line in the log is empty
+   */
+  [[nodiscard]] bool atLineStart() const;
+
+  /**
+   * @return
+   * The current end of the log, to later return to with `setEnd()`
+   */
+  [[nodiscard]] Cursor getEnd() const;
+
+  /**
+   * Move the end of the log to `cursor`.
+   * Nothing is removed until the next append which differs from what is stored,
+   * so the end may also be moved forward to a cursor from before then
+   *
+   * @param cursor
+   * A previous end of the log, from `getEnd()`
+   */
+  void setEnd(Cursor cursor);
+
+  /**
+   * @return
+   * The number of lines in the log
+   */
+  [[nodiscard]] std::size_t lineCount() const;
+
+  /**
+   * Get a line in the log
+   *
+   * @param index
+   * The index of the line. Must be less than `lineCount()`
+   *
+   * @return
+   * The line. The text of the last line may be longer than
+   * `lineLength()` if the end was moved back within it
+   */
+  [[nodiscard]] const Line &line(std::size_t index) const;
+
+  /**
+   * @param index
+   * The index of the line. Must be less than `lineCount()`
+   *
+   * @return
+   * The number of characters of the line in the log
+   */
+  [[nodiscard]] int lineLength(std::size_t index) const;
+
+  /**
+   * Get the visible text of a line
+   *
+   * @param index
+   * The index of the line. Must be less than `lineCount()`
+   *
+   * @return
+   * The text of the line in the log
+   */
+  [[nodiscard]] QString lineText(std::size_t index) const;
+
+  /**
+   * Remove every line
+   */
+  void clear();
+};
+
+} // namespace netsimulyzer
@@ -0,0 +1,267 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "LogView.h"
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QMenu>
+#include <QPainter>
+#include <QScrollBar>
+#include <QString>
+#include <QStringList>
+#include <algorithm>
+
+int LogView::lineHeight() const {
+  return std::max(fontMetrics().lineSpacing(), 1);
+}
+
+int LogView::visibleLineCount() const {
+  return std::max(viewport()->height() / lineHeight(), 1);
+}
+
+std::optional<std::size_t> LogView::lineAt(const QPoint &point) const {
+  if (!store)
+    return {};
+
+  const auto first = static_cast<long long>(verticalScrollBar()->value());
+  const auto line = first + std::max(point.y(), 0) / lineHeight();
+
+  return std::min(static_cast<std::size_t>(line), store->lineCount() - 1u);
+}
+
+void LogView::updateScrollBars() {
+  const auto lines = store ? static_cast<int>(store->lineCount()) : 0;
+  const auto visibleLines = visibleLineCount();
+
+  verticalScrollBar()->setPageStep(visibleLines);
+  verticalScrollBar()->setSingleStep(1);
+  verticalScrollBar()->setRange(0, std::max(lines - visibleLines, 0));
+
+  horizontalScrollBar()->setPageStep(viewport()->width());
+  horizontalScrollBar()->setSingleStep(fontMetrics().averageCharWidth());
+  horizontalScrollBar()->setRange(0, std::max(longestLine - viewport()->width(), 0));
+}
+
+void LogView::copySelection() const {
+  if (!store || !selectionAnchor)
+    return;
+
+  const auto first = std::min(*selectionAnchor, selectionEnd);
+  const auto last = std::min(std::max(*selectionAnchor, selectionEnd), store->lineCount() - 1u);
+
+  QStringList lines;
+  for (auto i = first; i <= last; i++)
+    lines.append(store->lineText(i));
+
+  QGuiApplication::clipboard()->setText(lines.join('\n'));
+}
+
+void LogView::paintEvent(QPaintEvent *) {
+  QPainter painter{viewport()};
+  if (!store)
+    return;
+
+  const auto height = lineHeight();
+  const auto ascent = fontMetrics().ascent();
+  const auto xOffset = horizontalScrollBar()->value();
+  const auto first = static_cast<std::size_t>(verticalScrollBar()->value());
+  const auto last = std::min(first + static_cast<std::size_t>(visibleLineCount()) + 1u, store->lineCount());
+
+  std::optional<std::size_t> selectionFirst;
+  std::size_t selectionLast{0u};
+  if (selectionAnchor) {
+    selectionFirst = std::min(*selectionAnchor, selectionEnd);
+    selectionLast = std::max(*selectionAnchor, selectionEnd);
+  }
+
+  const auto &textColor = palette().color(QPalette::Text);
+  const auto &highlight = palette().color(QPalette::Highlight);
+  const auto &highlightedText = palette().color(QPalette::HighlightedText);
+
+  auto longestVisible = 0;
+  auto y = 0;
+  for (auto i = first; i < last; i++, y += height) {
+    const auto &line = store->line(i);
+    const auto text = store->lineText(i);
+    const auto selected = selectionFirst && i >= *selectionFirst && i <= selectionLast;
+
+    if (selected) {
+      painter.fillRect(0, y, viewport()->width(), height, highlight);
+      painter.setPen(highlightedText);
+    } else {
+      const auto color = colors.find(line.streamId);
+      painter.setPen(color == colors.end() ? textColor : color->second);
+    }
+
+    painter.drawText(-xOffset, y + ascent, text);
+    longestVisible = std::max(longestVisible, fontMetrics().horizontalAdvance(text));
+  }
+
+  // Grow the horizontal scroll bar as longer lines come into view
+  if (longestVisible > longestLine) {
+    longestLine = longestVisible;
+    horizontalScrollBar()->setRange(0, std::max(longestLine - viewport()->width(), 0));
+  }
+}
+
+void LogView::resizeEvent(QResizeEvent *event) {
+  QAbstractScrollArea::resizeEvent(event);
+  updateScrollBars();
+}
+
+void LogView::mousePressEvent(QMouseEvent *event) {
+  if (event->button() != Qt::LeftButton) {
+    QAbstractScrollArea::mousePressEvent(event);
+    return;
+  }
+
+  const auto line = lineAt(event->position().toPoint());
+  if (!line)
+    return;
+
+  if (!(event->modifiers() & Qt::ShiftModifier) || !selectionAnchor)
+    selectionAnchor = line;
+  selectionEnd = *line;
+
+  viewport()->update();
+}
+
+void LogView::mouseMoveEvent(QMouseEvent *event) {
+  if (!(event->buttons() & Qt::LeftButton) || !selectionAnchor) {
+    QAbstractScrollArea::mouseMoveEvent(event);
+    return;
+  }
+
+  const auto line = lineAt(event->position().toPoint());
+  if (!line)
+    return;
+
+  selectionEnd = *line;
+  viewport()->update();
+}
+
+void LogView::keyPressEvent(QKeyEvent *event) {
+  if (event->matches(QKeySequence::Copy)) {
+    copySelection();
+    return;
+  }
+
+  if (event->matches(QKeySequence::SelectAll) && store) {
+    selectionAnchor = 0u;
+    selectionEnd = store->lineCount() - 1u;
+    viewport()->update();
+    return;
+  }
+
+  switch (event->key()) {
+  case Qt::Key_Home:
+    verticalScrollBar()->setValue(verticalScrollBar()->minimum());
+    break;
+  case Qt::Key_End:
+    scrollToEnd();
+    break;
+  default:
+    // Handles arrow keys & page up/down
+    QAbstractScrollArea::keyPressEvent(event);
+    break;
+  }
+}
+
+void LogView::contextMenuEvent(QContextMenuEvent *event) {
+  QMenu menu{this};
+
+  auto copy = menu.addAction("Copy");
+  copy->setEnabled(selectionAnchor.has_value());
+  QObject::connect(copy, &QAction::triggered, [this]() {
+    copySelection();
+  });
+
+  auto selectAll = menu.addAction("Select All");
+  QObject::connect(selectAll, &QAction::triggered, [this]() {
+    if (!store)
+      return;
+
+    selectionAnchor = 0u;
+    selectionEnd = store->lineCount() - 1u;
+    viewport()->update();
+  });
+
+  menu.exec(event->globalPos());
+}
+
+LogView::LogView(QWidget *parent) : QAbstractScrollArea(parent) {
+  setFocusPolicy(Qt::StrongFocus);
+  setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+  setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+}
+
+void LogView::setStore(const netsimulyzer::LogStore *value) {
+  store = value;
+  longestLine = 0;
+  selectionAnchor.reset();
+  horizontalScrollBar()->setValue(0);
+  storeChanged();
+}
+
+void LogView::setStreamColor(unsigned int streamId, const QColor &color) {
+  colors.insert_or_assign(streamId, color);
+  viewport()->update();
+}
+
+void LogView::clearStreamColors() {
+  colors.clear();
+  viewport()->update();
+}
+
+void LogView::storeChanged() {
+  // Lines may have been removed from under the selection
+  if (selectionAnchor && store && std::max(*selectionAnchor, selectionEnd) >= store->lineCount())
+    selectionAnchor.reset();
+
+  updateScrollBars();
+  viewport()->update();
+}
+
+void LogView::scrollToEnd() {
+  verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void LogView::showLine(std::size_t line) {
+  if (!store || line >= store->lineCount())
+    return;
+
+  selectionAnchor = line;
+  selectionEnd = line;
+  verticalScrollBar()->setValue(static_cast<int>(line));
+  viewport()->update();
+}
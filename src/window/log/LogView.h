@@ -0,0 +1,172 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#pragma once
+
+#include "LogStore.h"
+#include <QAbstractScrollArea>
+#include <QColor>
+#include <QContextMenuEvent>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWidget>
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+
+// Not in the `netsimulyzer` namespace,
+// so it may be used with the Qt Creator designer
+
+/**
+ * Read-only view of a `LogStore`.
+ *
+ * Only the lines on screen are laid out & drawn,
+ * so the size of the log does not affect drawing it.
+ * Whole lines may be selected & copied
+ */
+class LogView : public QAbstractScrollArea {
+  Q_OBJECT
+
+  const netsimulyzer::LogStore *store{nullptr};
+
+  /**
+   * The colors of lines by stream ID.
+   * Lines from streams without one use the palette text color
+   */
+  std::unordered_map<unsigned int, QColor> colors;
+
+  /**
+   * The width of the longest line drawn so far,
+   * since lines are not measured until they are on screen
+   */
+  int longestLine{0};
+
+  /**
+   * The line a selection was started from
+   */
+  std::optional<std::size_t> selectionAnchor;
+
+  /**
+   * The line a selection was extended to.
+   * May be before `selectionAnchor`
+   */
+  std::size_t selectionEnd{0u};
+
+  [[nodiscard]] int lineHeight() const;
+
+  /**
+   * @return
+   * The number of lines which fit in the viewport
+   */
+  [[nodiscard]] int visibleLineCount() const;
+
+  /**
+   * Find the line under a point in the viewport
+   *
+   * @param point
+   * The point, relative to the viewport
+   *
+   * @return
+   * The index of the line, clamped to the lines in the store
+   */
+  [[nodiscard]] std::optional<std::size_t> lineAt(const QPoint &point) const;
+
+  void updateScrollBars();
+
+  /**
+   * Put the text of the selected lines on the clipboard
+   */
+  void copySelection() const;
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+  void mouseMoveEvent(QMouseEvent *event) override;
+  void keyPressEvent(QKeyEvent *event) override;
+  void contextMenuEvent(QContextMenuEvent *event) override;
+
+public:
+  /**
+   * Default Qt Widget constructor
+   *
+   * @param parent
+   * The widget that contains this one
+   */
+  explicit LogView(QWidget *parent = nullptr);
+
+  /**
+   * Show a different log
+   *
+   * @param value
+   * The log to show. Must outlive the view, or be replaced before it is destroyed
+   */
+  void setStore(const netsimulyzer::LogStore *value);
+
+  /**
+   * Set the color lines from a stream are drawn with
+   *
+   * @param streamId
+   * The ID of the stream
+   *
+   * @param color
+   * The color to draw its lines with
+   */
+  void setStreamColor(unsigned int streamId, const QColor &color);
+
+  /**
+   * Draw every line with the palette text color
+   */
+  void clearStreamColors();
+
+  /**
+   * Signals the lines in the store have changed
+   */
+  void storeChanged();
+
+  /**
+   * Scroll to the last line in the log
+   */
+  void scrollToEnd();
+
+  /**
+   * Scroll so `line` is at the top of the view, if possible
+   * and select it
+   *
+   * @param line
+   * The index of the line to show
+   */
+  void showLine(std::size_t line);
+};
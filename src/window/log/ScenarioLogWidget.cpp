@@ -35,19 +35,23 @@
 #include "../../conversion.h"
 #include "ui_ScenarioLogWidget.h"
 #include <QColor>
+#include <QList>
+#include <QMetaObject>
 #include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QTreeWidgetItem>
+#include <QVariant>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
 #include <variant>
 
 namespace netsimulyzer {
 
-ScenarioLogWidget::LogStreamPair::LogStreamPair(parser::LogStream model) : model(std::move(model)) {
-  data->setDocumentLayout(new QPlainTextDocumentLayout(data.get()));
-  if (this->model.color) {
-    const auto &color = *this->model.color;
-    textFormat.setForeground(QColor{color.red, color.green, color.blue, 255});
-  }
-
-  name = QString::fromStdString(this->model.name);
+ScenarioLogWidget::LogStreamPair::LogStreamPair(parser::LogStream model)
+    : model(std::move(model)), name(QString::fromStdString(this->model.name)) {
 }
 
 void ScenarioLogWidget::handleEvent(const parser::StreamAppendEvent &e) {
@@ -55,86 +59,66 @@ void ScenarioLogWidget::handleEvent(const parser::StreamAppendEvent &e) {
   if (iter == streams.end())
     return;
 
-  undo::StreamAppendEvent undo;
-  undo.event = e;
-  undo.lastUnifiedWriter = lastUnifiedWriter;
-
   auto &pair = iter->second;
-  auto value = QString::fromStdString(e.value);
-  pair.print(value);
-
-  undo.unifiedLogEraseCount = printToUnifiedLog(pair, value);
-
-  undoEvents.emplace_back(undo);
+  appendStates[eventIndex] = AppendState{pair.position(), unifiedStore.getEnd(), lastUnifiedWriter};
 
-  // Scroll the document to the bottom (where the cursor is now)
-  // after every append, keeping the newest info visible
-  // TODO: Should be a setting "autoscroll logs" maybe?
-  ui.plainTextLog->ensureCursorVisible();
+  auto value = QString::fromStdString(e.value);
+  pair.print(e.time, value);
+  printToUnifiedLog(pair, e.time, value);
 }
 
-void ScenarioLogWidget::handleEvent(const undo::StreamAppendEvent &e) {
-  const auto &iter = streams.find(e.event.streamId);
+void ScenarioLogWidget::undoEvent(const parser::StreamAppendEvent &e) {
+  eventIndex--;
+
+  // Events for unknown streams are skipped when they're handled,
+  // so there is nothing to undo
+  const auto &iter = streams.find(e.streamId);
   if (iter == streams.end())
     return;
 
-  auto &pair = iter->second;
-  // TODO: Maybe check this cast?
-  pair.erase(static_cast<int>(e.event.value.size()));
-
-  unifiedStreamCursor.movePosition(QTextCursor::MoveOperation::Left, QTextCursor::MoveMode::KeepAnchor,
-                                   e.unifiedLogEraseCount);
-  unifiedStreamCursor.removeSelectedText();
-  lastUnifiedWriter = e.lastUnifiedWriter;
-
-  events.emplace_front(e.event);
+  const auto &state = appendStates[eventIndex];
+  iter->second.truncate(state.streamPosition);
+  unifiedStore.setEnd(state.unifiedPosition);
+  lastUnifiedWriter = state.lastUnifiedWriter;
 }
 
-int ScenarioLogWidget::printToUnifiedLog(LogStreamPair &pair, const QString &value) {
-  // File us down to single line prints
-  if (value.count('\n') > 1) {
-    auto lines = value.split('\n');
-    int accumulator = 0;
-    for (const auto &line : lines)
-      accumulator += printToUnifiedLog(pair, line + '\n');
+void ScenarioLogWidget::printToUnifiedLog(const LogStreamPair &pair, parser::nanoseconds time, const QString &value) {
+  const auto id = pair.getModel().id;
 
-    return accumulator;
-  }
+  // Print line by line, so each is prefixed with the stream name
+  const auto lines = QStringView{value}.split('\n');
+  for (qsizetype i = 0; i < lines.size(); i++) {
+    if (i > 0) {
+      unifiedStore.newLine(time, id);
 
-  int characterTotal = 0;
+      // Nothing after the last newline
+      if (i == lines.size() - 1 && lines[i].isEmpty())
+        break;
+    }
 
-  const auto id = pair.getModel().id;
-  const auto &format = pair.getFormat();
+    if (id != lastUnifiedWriter && !unifiedStore.atLineStart())
+      unifiedStore.newLine(time, id);
 
-  if (id != lastUnifiedWriter && !unifiedStreamCursor.atBlockStart()) {
-    unifiedStreamCursor.insertText("\n", format);
-    characterTotal++;
-  }
+    if (unifiedStore.atLineStart())
+      unifiedStore.append(time, id, '[' + pair.getName() + "]: ");
 
-  if (unifiedStreamCursor.atBlockStart()) {
-    const QString prompt = '[' + pair.getName() + "]: ";
-    unifiedStreamCursor.insertText(prompt, format);
-    characterTotal += prompt.size();
+    unifiedStore.append(time, id, lines[i].toString());
+    lastUnifiedWriter = id;
   }
+}
 
-  unifiedStreamCursor.insertText(value);
-  characterTotal += value.size();
-
-  lastUnifiedWriter = id;
+void ScenarioLogWidget::logChanged() {
+  ui.logView->storeChanged();
 
-  return characterTotal;
+  // Keep the newest info visible
+  // TODO: Should be a setting "autoscroll logs" maybe?
+  ui.logView->scrollToEnd();
 }
 
 void ScenarioLogWidget::streamSelected(unsigned int id) {
   if (id == unifiedStreamId) {
-    ui.plainTextLog->setDocument(&unifiedStreamDocument);
-
-    // When changing the document, the cursor seems to get stuck
-    // at the top, so move it back to the end
-    ui.plainTextLog->moveCursor(QTextCursor::End);
-
-    // Scroll the document to the bottom (where the cursor is now)
-    ui.plainTextLog->ensureCursorVisible();
+    ui.logView->setStore(&unifiedStore);
+    ui.logView->scrollToEnd();
     return;
   }
 
@@ -142,14 +126,8 @@ void ScenarioLogWidget::streamSelected(unsigned int id) {
   if (iter == streams.end())
     return;
 
-  ui.plainTextLog->setDocument(&iter->second.getData());
-
-  // When changing the document, the cursor seems to get stuck
-  // at the top, so move it back to the end
-  ui.plainTextLog->moveCursor(QTextCursor::End);
-
-  // Scroll the document to the bottom (where the cursor is now)
-  ui.plainTextLog->ensureCursorVisible();
+  ui.logView->setStore(&iter->second.getData());
+  ui.logView->scrollToEnd();
 }
 
 void ScenarioLogWidget::timeAdvanced(parser::nanoseconds time) {
@@ -158,69 +136,276 @@ void ScenarioLogWidget::timeAdvanced(parser::nanoseconds time) {
       return false;
 
     handleEvent(e);
-    events.pop_front();
+    eventIndex++;
     return true;
   };
 
-  while (!events.empty() && std::visit(handle, events.front())) {
+  while (eventIndex < events.size() && std::visit(handle, events[eventIndex])) {
     // Intentionally Blank
   }
+
+  if (!keyframes.empty() && keyframes.back().eventIndex + keyframeInterval <= eventIndex)
+    recordKeyframe(time);
 }
 
 void ScenarioLogWidget::timeRewound(parser::nanoseconds time) {
-  auto handleUndoEvent = [time, this](auto &&e) -> bool {
+  auto undo = [time, this](auto &&e) -> bool {
     // All events have a time
     // Make sure we don't handle one
     // Before it was originally applied
-    if (time > e.event.time)
+    if (time > e.time)
       return false;
 
-    handleEvent(e);
+    undoEvent(e);
     return true;
   };
 
-  while (!undoEvents.empty() && std::visit(handleUndoEvent, undoEvents.back())) {
-    undoEvents.pop_back();
+  while (eventIndex > 0u && std::visit(undo, events[eventIndex - 1u])) {
+    // Intentionally Blank
+  }
+}
+
+void ScenarioLogWidget::recordKeyframe(parser::nanoseconds time) {
+  Keyframe keyframe;
+  keyframe.time = time;
+  keyframe.eventIndex = eventIndex;
+  keyframe.lastUnifiedWriter = lastUnifiedWriter;
+  keyframe.unifiedPosition = unifiedStore.getEnd();
+
+  keyframe.streamPositions.reserve(streams.size());
+  for (const auto &[id, pair] : streams) {
+    keyframe.streamPositions.try_emplace(id, pair.position());
+  }
+
+  keyframes.emplace_back(std::move(keyframe));
+}
+
+std::vector<ScenarioLogWidget::Keyframe>::iterator ScenarioLogWidget::findKeyframe(parser::nanoseconds time) {
+  auto iter =
+      std::upper_bound(keyframes.begin(), keyframes.end(), time, [](parser::nanoseconds value, const Keyframe &keyframe) {
+        return value < keyframe.time;
+      });
+
+  if (iter == keyframes.begin())
+    return keyframes.end();
+
+  return iter - 1;
+}
+
+void ScenarioLogWidget::restoreKeyframe(std::vector<Keyframe>::iterator keyframe, parser::nanoseconds time) {
+  for (const auto &[id, position] : keyframe->streamPositions) {
+    auto iter = streams.find(id);
+    if (iter == streams.end())
+      continue;
+
+    iter->second.truncate(position);
+  }
+
+  unifiedStore.setEnd(keyframe->unifiedPosition);
+  lastUnifiedWriter = keyframe->lastUnifiedWriter;
+  eventIndex = keyframe->eventIndex;
+
+  timeAdvanced(time);
+}
+
+void ScenarioLogWidget::startIndexing() {
+  stopIndexing();
+  cancelIndexing = false;
+  searchIndexReady = false;
+  ui.lineEditSearch->setEnabled(false);
+  ui.lineEditSearch->setPlaceholderText("Indexing logs...");
+
+  // `events` is not changed until indexing is stopped
+  pendingIndex = std::async(std::launch::async, [this, generation = indexGeneration]() {
+    auto index = LogSearchIndex::build(events, cancelIndexing);
+
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation]() {
+          // Indexing may have been stopped, or restarted, since this was queued
+          if (generation == indexGeneration)
+            indexBuilt();
+        },
+        Qt::QueuedConnection);
+    return index;
+  });
+}
+
+void ScenarioLogWidget::stopIndexing() {
+  // Ignore the index being built, should it finish
+  indexGeneration++;
+
+  if (!pendingIndex.valid())
+    return;
+
+  cancelIndexing = true;
+  pendingIndex.wait();
+  pendingIndex = {};
+}
+
+void ScenarioLogWidget::indexBuilt() {
+  if (!pendingIndex.valid())
+    return;
+
+  // Only waits for the task to return the index
+  searchIndex = pendingIndex.get();
+  searchIndexReady = true;
+
+  ui.lineEditSearch->setEnabled(true);
+  ui.lineEditSearch->setPlaceholderText("Search logs");
+  search();
+}
+
+void ScenarioLogWidget::search() {
+  ui.treeSearchResults->clear();
+
+  const auto query = ui.lineEditSearch->text().trimmed().toStdString();
+  if (!searchIndexReady || query.empty()) {
+    ui.treeSearchResults->hide();
+    return;
+  }
+
+  const auto hits = searchIndex.find(events, query, maxSearchHits);
+
+  QList<QTreeWidgetItem *> items;
+  items.reserve(static_cast<qsizetype>(hits.size()));
+  for (const auto &hit : hits) {
+    QString streamName;
+    if (const auto iter = streams.find(hit.streamId); iter != streams.end())
+      streamName = iter->second.getName();
+    else
+      streamName = QString::number(hit.streamId);
+
+    const auto text = QString::fromUtf8(hit.text.data(), static_cast<qsizetype>(hit.text.size()));
+    auto item = new QTreeWidgetItem{QStringList{QString::number(toMilliseconds(hit.time)), streamName, text}};
+    item->setData(0, Qt::UserRole, QVariant::fromValue(hit.time));
+    items.append(item);
   }
+
+  if (items.isEmpty())
+    items.append(new QTreeWidgetItem{QStringList{{}, {}, "No matching lines"}});
+  else if (hits.size() == maxSearchHits)
+    items.append(
+        new QTreeWidgetItem{QStringList{{}, {}, QString{"Only the first %1 lines are shown"}.arg(maxSearchHits)}});
+
+  ui.treeSearchResults->addTopLevelItems(items);
+  ui.treeSearchResults->show();
 }
 
 ScenarioLogWidget::ScenarioLogWidget(QWidget *parent) : QWidget(parent) {
   ui.setupUi(this);
-  unifiedStreamDocument.setDocumentLayout(new QPlainTextDocumentLayout(&unifiedStreamDocument));
+  ui.treeSearchResults->hide();
 
   reset();
 
   QObject::connect(ui.comboBoxLogName, qOverload<int>(&QComboBox::currentIndexChanged), [this](int index) {
     streamSelected(ui.comboBoxLogName->itemData(index).toUInt());
   });
+
+  QObject::connect(ui.lineEditSearch, &QLineEdit::returnPressed, this, &ScenarioLogWidget::search);
+
+  // Hide the results once the search is cleared
+  QObject::connect(ui.lineEditSearch, &QLineEdit::textChanged, [this](const QString &text) {
+    if (text.trimmed().isEmpty())
+      search();
+  });
+
+  QObject::connect(ui.treeSearchResults, &QTreeWidget::itemActivated, [this](const QTreeWidgetItem *item) {
+    const auto time = item->data(0, Qt::UserRole);
+
+    // The "No matching lines" items have no time
+    if (time.isValid())
+      emit seekRequested(time.value<parser::nanoseconds>());
+  });
+}
+
+ScenarioLogWidget::~ScenarioLogWidget() {
+  stopIndexing();
 }
 
 void ScenarioLogWidget::addStream(const parser::LogStream &stream) {
   streams.try_emplace(stream.id, stream);
 
+  if (stream.color) {
+    const auto &color = *stream.color;
+    ui.logView->setStreamColor(stream.id, QColor{color.red, color.green, color.blue, 255});
+  }
+
   if (stream.visible)
     ui.comboBoxLogName->addItem(QString::fromStdString(stream.name), stream.id);
 }
 
-void ScenarioLogWidget::enqueueEvents(const std::vector<parser::LogEvent> &e) {
-  events.insert(events.end(), e.begin(), e.end());
+void ScenarioLogWidget::enqueueEvents(std::vector<parser::LogEvent> &&e) {
+  // The search index may be reading `events`
+  stopIndexing();
+
+  if (events.empty())
+    events = std::move(e);
+  else
+    events.insert(events.end(), std::make_move_iterator(e.begin()), std::make_move_iterator(e.end()));
+
+  appendStates.assign(events.size(), {});
+  startIndexing();
+
+  // Initial keyframe, so every time has one at or before it
+  keyframes.clear();
+  eventIndex = 0u;
+  recordKeyframe(std::numeric_limits<parser::nanoseconds>::min());
 }
 
 void ScenarioLogWidget::timeChanged(parser::nanoseconds time, parser::nanoseconds increment) {
-  if (increment > 0LL)
-    timeAdvanced(time);
+  const auto previousIndex = eventIndex;
+  if (increment > 0LL) {
+    // Keyframes past the current event are only left from moving back,
+    // jump to one of those rather than applying every event up to it again
+    auto keyframe = keyframes.end();
+    if (!keyframes.empty() && keyframes.back().eventIndex >= eventIndex + keyframeInterval)
+      keyframe = findKeyframe(time);
+
+    if (keyframe != keyframes.end() && keyframe->eventIndex >= eventIndex + keyframeInterval)
+      restoreKeyframe(keyframe, time);
+    else
+      timeAdvanced(time);
+
+    if (eventIndex != previousIndex)
+      logChanged();
+    return;
+  }
+
+  // Undoing a long way back is more expensive than truncating
+  // to a keyframe and playing forward from there
+  const auto keyframe = findKeyframe(time);
+  if (keyframe != keyframes.end() && keyframe->eventIndex + keyframeInterval * 2u <= eventIndex)
+    restoreKeyframe(keyframe, time);
   else
     timeRewound(time);
+
+  if (eventIndex != previousIndex)
+    logChanged();
 }
 
 void ScenarioLogWidget::reset() {
-  unifiedStreamDocument.clear();
-  ui.plainTextLog->setDocument(&unifiedStreamDocument);
+  // The index refers to the events being cleared
+  stopIndexing();
+  searchIndex = {};
+  searchIndexReady = false;
+  ui.lineEditSearch->setEnabled(false);
+  ui.lineEditSearch->clear();
+  ui.treeSearchResults->clear();
+  ui.treeSearchResults->hide();
+
+  // Show the unified log first, since it is not removed with the streams
+  unifiedStore.clear();
+  ui.logView->setStore(&unifiedStore);
+  ui.logView->clearStreamColors();
+  lastUnifiedWriter = 0u;
   ui.comboBoxLogName->clear();
   streams.clear();
   ui.comboBoxLogName->addItem("Unified Log", unifiedStreamId);
   events.clear();
-  undoEvents.clear();
+  appendStates.clear();
+  eventIndex = 0u;
+  keyframes.clear();
 }
 
 } // namespace netsimulyzer
@@ -32,16 +32,14 @@
  */
 
 #pragma once
-#include "../../util/undo-events.h"
+#include "LogSearchIndex.h"
+#include "LogStore.h"
 #include "ui_ScenarioLogWidget.h"
 #include <QColor>
 #include <QString>
-#include <QTextCharFormat>
-#include <QTextCursor>
-#include <QTextDocument>
 #include <QWidget>
-#include <deque>
-#include <memory>
+#include <atomic>
+#include <future>
 #include <model.h>
 #include <optional>
 #include <unordered_map>
@@ -54,75 +52,224 @@ class ScenarioLogWidget : public QWidget {
   Q_OBJECT
   Ui::ScenarioLogWidget ui{};
   const unsigned int unifiedStreamId = 0u;
-  QTextDocument unifiedStreamDocument{this};
-  QTextCursor unifiedStreamCursor{&unifiedStreamDocument};
+  LogStore unifiedStore;
 
   class LogStreamPair {
     parser::LogStream model;
-    std::unique_ptr<QTextDocument> data = std::make_unique<QTextDocument>();
-    std::unique_ptr<QTextCursor> cursor = std::make_unique<QTextCursor>(data.get());
-    QTextCharFormat textFormat;
+    LogStore data;
     QString name;
 
   public:
     explicit LogStreamPair(parser::LogStream model);
 
-    // No Copies
-    LogStreamPair(const LogStreamPair &other) = delete;
-    LogStreamPair &operator=(const LogStreamPair &other) = delete;
-
-    // Allow Moves
-    LogStreamPair(LogStreamPair &&other) noexcept = default;
-    LogStreamPair &operator=(LogStreamPair &&other) noexcept = default;
-
-    ~LogStreamPair() = default;
+    void print(parser::nanoseconds time, const QString &value) {
+      data.append(time, model.id, value);
+    }
 
-    void print(const QString &value) const {
-      cursor->insertText(value, textFormat);
+    /**
+     * Move the end of the log back to `position`
+     *
+     * @param position
+     * The end of the log to return to
+     */
+    void truncate(LogStore::Cursor position) {
+      data.setEnd(position);
     }
 
-    void erase(int characters) {
-      cursor->movePosition(QTextCursor::MoveOperation::Left, QTextCursor::MoveMode::KeepAnchor, characters);
-      cursor->removeSelectedText();
+    [[nodiscard]] LogStore::Cursor position() const {
+      return data.getEnd();
     }
 
-    [[nodiscard]] QTextDocument &getData() {
-      return *data;
+    [[nodiscard]] const LogStore &getData() const {
+      return data;
     };
 
-    [[nodiscard]] const parser::LogStream &getModel() {
+    [[nodiscard]] const parser::LogStream &getModel() const {
       return model;
     };
 
     [[nodiscard]] const QString &getName() const {
       return name;
     }
+  };
 
-    [[nodiscard]] const QTextCharFormat &getFormat() const {
-      return textFormat;
-    }
+  /**
+   * Snapshot of the end of every log
+   * after the first `eventIndex` events were applied
+   */
+  struct Keyframe {
+    parser::nanoseconds time;
+    std::size_t eventIndex;
+    unsigned int lastUnifiedWriter;
+    LogStore::Cursor unifiedPosition;
+    std::unordered_map<unsigned int, LogStore::Cursor> streamPositions;
+  };
+
+  /**
+   * The end of the logs before an event was applied
+   */
+  struct AppendState {
+    LogStore::Cursor streamPosition;
+    LogStore::Cursor unifiedPosition;
+    unsigned int lastUnifiedWriter;
   };
 
   unsigned int lastUnifiedWriter = 0u;
   std::unordered_map<unsigned int, LogStreamPair> streams;
-  std::deque<parser::LogEvent> events;
-  std::deque<undo::LogUndoEvent> undoEvents;
+  std::vector<parser::LogEvent> events;
+
+  /**
+   * Index of the next event in `events` to apply
+   */
+  std::size_t eventIndex{0u};
+
+  /**
+   * The state before each event in `events` was applied,
+   * so it may be undone by truncating the logs.
+   *
+   * Sized with `events`, so applying events does not allocate
+   */
+  std::vector<AppendState> appendStates;
+
+  /**
+   * Keyframes recorded during playback, sorted by time.
+   * Those past `eventIndex` are kept after moving back,
+   * since the logs keep their text past the end until it changes
+   */
+  std::vector<Keyframe> keyframes;
+
+  /**
+   * Number of events between each keyframe
+   */
+  const std::size_t keyframeInterval{10'000u};
+
+  /**
+   * Index of the lines in `events`, for searching.
+   * Only valid once `searchIndexReady` is set
+   */
+  LogSearchIndex searchIndex;
+  bool searchIndexReady{false};
+
+  /**
+   * The index being built for `events`, if any
+   */
+  std::future<LogSearchIndex> pendingIndex;
+
+  /**
+   * Set to stop building `pendingIndex` early
+   */
+  std::atomic<bool> cancelIndexing{false};
+
+  /**
+   * Incremented each time indexing is stopped,
+   * so an index which was being built is not used
+   */
+  unsigned int indexGeneration{0u};
+
+  /**
+   * The most lines shown for a search
+   */
+  const std::size_t maxSearchHits{1'000u};
+
+  /**
+   * Build `searchIndex` for `events` on another thread.
+   * `indexBuilt()` is called once it is done
+   */
+  void startIndexing();
+
+  /**
+   * Stop building the search index, if it is being built,
+   * and wait for it to stop
+   */
+  void stopIndexing();
+
+  /**
+   * Take the index from `pendingIndex`, if it is done,
+   * and allow searching
+   */
+  void indexBuilt();
+
+  /**
+   * Show the lines matching the text in the search box
+   */
+  void search();
 
   void handleEvent(const parser::StreamAppendEvent &e);
-  void handleEvent(const undo::StreamAppendEvent &e);
+
+  /**
+   * Undo `e`, the event before `eventIndex`
+   *
+   * @param e
+   * The event to undo
+   */
+  void undoEvent(const parser::StreamAppendEvent &e);
   void streamSelected(unsigned int id);
-  int printToUnifiedLog(LogStreamPair &pair, const QString &value);
+  void printToUnifiedLog(const LogStreamPair &pair, parser::nanoseconds time, const QString &value);
+
+  /**
+   * Redraw the shown log after it has changed,
+   * keeping the newest lines in view
+   */
+  void logChanged();
 
   void timeAdvanced(parser::nanoseconds time);
   void timeRewound(parser::nanoseconds time);
 
+  /**
+   * Snapshot the current end of every log
+   *
+   * @param time
+   * The time all events up to `eventIndex` were applied at
+   */
+  void recordKeyframe(parser::nanoseconds time);
+
+  /**
+   * Finds the latest keyframe at or before `time`
+   *
+   * @param time
+   * The time to search for
+   *
+   * @return
+   * An iterator to the keyframe, or `keyframes.end()` if there is none
+   */
+  [[nodiscard]] std::vector<Keyframe>::iterator findKeyframe(parser::nanoseconds time);
+
+  /**
+   * Move the end of every log to `keyframe`, which may be before or after
+   * the current event, then apply the events up to `time`
+   *
+   * @param keyframe
+   * The keyframe to restore. Must be at or before `time`
+   *
+   * @param time
+   * The time to play forward to after restoring
+   */
+  void restoreKeyframe(std::vector<Keyframe>::iterator keyframe, parser::nanoseconds time);
+
 public:
   explicit ScenarioLogWidget(QWidget *parent = nullptr);
+  ~ScenarioLogWidget() override;
 
   void addStream(const parser::LogStream &stream);
-  void enqueueEvents(const std::vector<parser::LogEvent> &e);
+  /**
+   * Take ownership of events for the logs
+   *
+   * @param e
+   * The events to add, sorted by time
+   */
+  void enqueueEvents(std::vector<parser::LogEvent> &&e);
   void timeChanged(parser::nanoseconds time, parser::nanoseconds increment);
   void reset();
+
+signals:
+  /**
+   * Signal emitted when the user chooses a search result,
+   * to move the scenario to the time it was logged
+   *
+   * @param time
+   * The time the line was logged
+   */
+  void seekRequested(parser::nanoseconds time);
 };
 
 } // namespace netsimulyzer
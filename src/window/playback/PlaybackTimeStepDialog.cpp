@@ -17,6 +17,12 @@ void PlaybackTimeStepDialog::dialogueButtonClicked(QAbstractButton *button) {
 
   switch (ui.buttonBox->standardButton(button)) {
   case QDialogButtonBox::Ok:
+    if (ui.checkRealTime->isChecked() != initialRealTime) {
+      settings.set(SettingsManager::Key::PlaybackRealTime, ui.checkRealTime->isChecked());
+      emit realTimeChanged(ui.checkRealTime->isChecked());
+      accept();
+    }
+
     if (spinnerValue != initialTimeStep || unit != static_cast<int>(initialUnit)) {
       switch (SettingsManager::TimeUnitFromInt(unit)) {
       case SettingsManager::TimeUnit::Nanoseconds:
@@ -37,6 +43,7 @@ void PlaybackTimeStepDialog::dialogueButtonClicked(QAbstractButton *button) {
   default:
     ui.spinTimestep->setValue(initialTimeStep);
     ui.comboUnit->setCurrentIndex(ui.comboUnit->findData(static_cast<int>(initialUnit)));
+    ui.checkRealTime->setChecked(initialRealTime);
     reject();
     break;
   }
@@ -64,6 +71,7 @@ QString PlaybackTimeStepDialog::suffixFromUnit(int unit) {
 void PlaybackTimeStepDialog::showEvent(QShowEvent *event) {
   initialTimeStep = ui.spinTimestep->value();
   initialUnit = SettingsManager::TimeUnitFromInt(ui.comboUnit->currentData().toInt());
+  initialRealTime = ui.checkRealTime->isChecked();
   QDialog::showEvent(event);
 }
 
@@ -73,6 +81,7 @@ PlaybackTimeStepDialog::PlaybackTimeStepDialog(QWidget *parent) : QDialog(parent
   ui.comboUnit->addItem("ns", static_cast<int>(SettingsManager::TimeUnit::Nanoseconds));
   ui.comboUnit->addItem("µs", static_cast<int>(SettingsManager::TimeUnit::Microseconds));
   ui.comboUnit->addItem("ms", static_cast<int>(SettingsManager::TimeUnit::Milliseconds));
+  ui.checkRealTime->setChecked(settings.get<bool>(SettingsManager::Key::PlaybackRealTime).value());
 
   QObject::connect(ui.buttonBox, &QDialogButtonBox::clicked, this, &PlaybackTimeStepDialog::dialogueButtonClicked);
 
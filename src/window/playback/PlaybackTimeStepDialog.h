@@ -14,6 +14,7 @@ class PlaybackTimeStepDialog : public QDialog {
   SettingsManager settings;
   int initialTimeStep{10};
   SettingsManager::TimeUnit initialUnit;
+  bool initialRealTime{false};
   Ui::PlaybackTimeStepDialog ui{};
 
   void dialogueButtonClicked(QAbstractButton *button);
@@ -28,6 +29,7 @@ public:
 
 signals:
   void timeStepChanged(parser::nanoseconds value, int unit);
+  void realTimeChanged(bool value);
 };
 
 } // namespace netsimulyzer
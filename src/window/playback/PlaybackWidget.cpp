@@ -59,15 +59,18 @@ parser::nanoseconds ceilTime(parser::nanoseconds time, netsimulyzer::SettingsMan
 namespace netsimulyzer {
 
 void PlaybackWidget::updateButtonSpeed(parser::nanoseconds step, SettingsManager::TimeUnit unit) {
+  timeStep = step;
+  const auto suffix = realTime ? QStringLiteral("/s") : QString{};
+
   switch (unit) {
   case SettingsManager::TimeUnit::Nanoseconds:
-    ui.buttonPlaybackSpeed->setText(QStringLiteral("%1%2").arg(step).arg("ns"));
+    ui.buttonPlaybackSpeed->setText(QStringLiteral("%1%2").arg(step).arg("ns") + suffix);
     break;
   case SettingsManager::TimeUnit::Microseconds:
-    ui.buttonPlaybackSpeed->setText(QStringLiteral("%1%2").arg(toMicroseconds(step)).arg("µs"));
+    ui.buttonPlaybackSpeed->setText(QStringLiteral("%1%2").arg(toMicroseconds(step)).arg("µs") + suffix);
     break;
   case SettingsManager::TimeUnit::Milliseconds:
-    ui.buttonPlaybackSpeed->setText(QStringLiteral("%1%2").arg(toMilliseconds(step)).arg("ms"));
+    ui.buttonPlaybackSpeed->setText(QStringLiteral("%1%2").arg(toMilliseconds(step)).arg("ms") + suffix);
     break;
   }
 }
@@ -103,6 +106,7 @@ PlaybackWidget::PlaybackWidget(QWidget *parent) : QWidget(parent) {
 
   // Pull the system fixed width font and use it for the numeric time
   ui.labelTime->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  ui.labelRate->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
 
   QObject::connect(ui.buttonPlayPause, &QPushButton::pressed, [this]() {
     playing = !playing;
@@ -154,6 +158,12 @@ PlaybackWidget::PlaybackWidget(QWidget *parent) : QWidget(parent) {
                      setGranularity(newUnit);
                      emit timeStepChanged(newValue, unit);
                    });
+
+  QObject::connect(&timeStepDialog, &PlaybackTimeStepDialog::realTimeChanged, [this](bool value) {
+    realTime = value;
+    updateButtonSpeed(timeStep, currentUnit);
+    emit realTimeChanged(value);
+  });
 }
 
 void PlaybackWidget::setMaxTime(parser::nanoseconds value) {
@@ -227,6 +237,11 @@ void PlaybackWidget::enableControls() {
   ui.buttonJump->setEnabled(true);
 }
 
+void PlaybackWidget::setPlaybackRate(double achieved, double target) {
+  ui.labelRate->setText(
+      QStringLiteral("%1 / %2 s/s").arg(achieved, 0, 'f', 3).arg(target, 0, 'f', 3));
+}
+
 bool PlaybackWidget::isPlaying() const {
   return playing;
 }
@@ -57,6 +57,19 @@ private:
       settings.get<SettingsManager::TimeUnit>(SettingsManager::Key::PlaybackTimeStepUnit).value();
   QString formattedMaxTime{"0.000"};
   bool playing{false};
+
+  /**
+   * If the time step is applied each second of real time,
+   * rather than each frame
+   */
+  bool realTime = settings.get<bool>(SettingsManager::Key::PlaybackRealTime).value();
+
+  /**
+   * The last time step set, kept to relabel the speed button
+   * when `realTime` changes
+   */
+  parser::nanoseconds timeStep{0LL};
+
   const QIcon playIcon = style()->standardIcon(QStyle::SP_MediaPlay);
   const QIcon resetIcon = style()->standardIcon(QStyle::SP_MediaSkipBackward);
   const QIcon pauseIcon = style()->standardIcon(QStyle::SP_MediaPause);
@@ -84,6 +97,17 @@ public:
   void reset();
   void enableControls();
 
+  /**
+   * Show the playback rate
+   *
+   * @param achieved
+   * The rate actually played at, in simulated seconds per second of real time
+   *
+   * @param target
+   * The rate playback is trying to reach, in the same units
+   */
+  void setPlaybackRate(double achieved, double target);
+
   [[nodiscard]] bool isPlaying() const;
   void setPlaying();
   void setPaused();
@@ -93,6 +117,7 @@ signals:
   void pause();
   void timeSet(parser::nanoseconds time);
   void timeStepChanged(parser::nanoseconds value, int unit);
+  void realTimeChanged(bool value);
 };
 
 } // namespace netsimulyzer
@@ -43,6 +43,7 @@
 #include <QDateTime>
 #include <QOpenGLVersionFunctionsFactory>
 #include <QFileDialog>
+#include <QFontDatabase>
 #include <QKeyEvent>
 #include <QMenu>
 #include <QMessageBox>
@@ -61,8 +62,15 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <ios>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <model.h>
 #include <qopengl.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #ifndef NDEBUG
@@ -77,6 +85,45 @@ static void logGlDebugMessage(const QOpenGLDebugMessage &message) {
 
 namespace netsimulyzer {
 
+namespace {
+
+/**
+ * @return
+ * The bounds of `model` after its position, rotation & scale are applied
+ */
+Aabb worldBounds(const Model &model) {
+  const auto bounds = model.getBounds();
+  return Aabb{bounds.min, bounds.max}.transformed(model.getModelMatrix());
+}
+
+/**
+ * @return
+ * The box containing every point of `link`
+ */
+Aabb wiredLinkBounds(const WiredLink &link) {
+  const auto &positions = link.getPositions();
+  if (positions.empty())
+    return {};
+
+  Aabb bounds{positions.front(), positions.front()};
+  for (const auto &position : positions) {
+    bounds = Aabb::merge(bounds, {position, position});
+  }
+
+  return bounds;
+}
+
+/**
+ * Remove repeated IDs from `ids`.
+ * A Node with several events in the same frame is only listed once
+ */
+void removeDuplicates(QVector<unsigned int> &ids) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+} // namespace
+
 void SceneWidget::handleEvents() {
   // Flag to indicate the selected Node has been updated
   // Use a flag instead of emitting a signal from the
@@ -97,18 +144,20 @@ void SceneWidget::handleEvents() {
     if (arg.time > simulationTime)
       return false;
 
-    if constexpr (std::is_same_v<T, parser::MoveEvent> || std::is_same_v<T, parser::NodeModelChangeEvent> ||
+    if constexpr (std::is_same_v<T, parser::MoveEvent> || std::is_same_v<T, SceneEventStore::NodeModelChange> ||
                   std::is_same_v<T, parser::NodeOrientationChangeEvent> ||
                   std::is_same_v<T, parser::NodeColorChangeEvent> || std::is_same_v<T, parser::TransmitEvent> ||
                   std::is_same_v<T, parser::TransmitEndEvent>) {
       auto node = nodes.find(arg.nodeId);
-      if (node == nodes.end())
-        return false;
+      if (node == nodes.end()) {
+        std::cerr << "Node event references Node which does not exist: ID [" << arg.nodeId << "] discarding event\n";
+        return true;
+      }
 
-      if constexpr (std::is_same_v<T, parser::NodeModelChangeEvent>)
-        undoEvents.emplace_back(node->second.handle(arg, models));
+      if constexpr (std::is_same_v<T, SceneEventStore::NodeModelChange>)
+        node->second.handle(arg, models);
       else
-        undoEvents.emplace_back(node->second.handle(arg));
+        node->second.handle(arg);
 
       updatedNodes.push_back(arg.nodeId);
 
@@ -116,13 +165,16 @@ void SceneWidget::handleEvents() {
     } else if constexpr (std::is_same_v<T, parser::DecorationMoveEvent> ||
                          std::is_same_v<T, parser::DecorationOrientationChangeEvent>) {
       auto decoration = decorations.find(arg.decorationId);
-      if (decoration == decorations.end())
-        return false;
-      undoEvents.emplace_back(decoration->second.handle(arg));
+      if (decoration == decorations.end()) {
+        std::cerr << "Decoration event references Decoration which does not exist: ID [" << arg.decorationId
+                  << "] discarding event\n";
+        return true;
+      }
+      decoration->second.handle(arg);
+      refitDecoration(arg.decorationId);
       return true;
     } else if constexpr (std::is_same_v<T, parser::LogicalLinkCreate>) {
       logicalLinks.insert_or_assign(arg.model.id, LogicalLink{arg.model, linkCylinderInfo});
-      undoEvents.emplace_back(undo::LogicalLinkCreate{arg});
       return true;
     } else if constexpr (std::is_same_v<T, parser::LogicalLinkUpdate>) {
       auto link = logicalLinks.find(arg.id);
@@ -132,15 +184,20 @@ void SceneWidget::handleEvents() {
         return true;
       }
 
-      undoEvents.emplace_back(link->second.handle(arg));
+      link->second.handle(arg);
       return true;
     }
 
     return false;
   };
 
-  while (!events.empty() && std::visit(handleEvent, events.front())) {
-    events.pop_front();
+  while (eventIndex < events.size() && events.visit(eventIndex, handleEvent)) {
+    eventIndex++;
+  }
+
+  removeDuplicates(updatedNodes);
+  for (const auto id : updatedNodes) {
+    refitNode(id);
   }
 
   if (!updatedNodes.empty())
@@ -148,13 +205,23 @@ void SceneWidget::handleEvents() {
 }
 
 void SceneWidget::handleUndoEvents() {
+  // The initial keyframe is only missing when there are no events
+  if (keyframes.empty())
+    return;
+
   // Flag to indicate the selected Node has been updated
   // Use a flag instead of emitting a signal from the
   // handler, just in case the Node is updated several times
   // this event period
   QVector<unsigned int> updatedNodes;
 
-  auto handleUndoEvent = [this, &updatedNodes](auto &&arg) -> bool {
+  // The state of everything before the first event,
+  // for properties no earlier event has changed
+  const auto &initial = keyframes.front();
+
+  // Returns true after undoing the event before `eventIndex`
+  // false otherwise
+  auto undoEvent = [this, &updatedNodes, &initial](auto &&arg) -> bool {
     // Strip off qualifiers, etc
     // so T holds just the type
     // so we can more easily match it
@@ -163,67 +230,370 @@ void SceneWidget::handleUndoEvents() {
     // All events have a time
     // Make sure we don't handle one
     // Before it was originally applied
-    if (simulationTime > arg.event.time)
+    if (simulationTime > arg.time)
       return false;
 
-    if constexpr (std::is_same_v<T, undo::MoveEvent> || std::is_same_v<T, undo::NodeModelChangeEvent> ||
-                  std::is_same_v<T, undo::NodeOrientationChangeEvent> || std::is_same_v<T, undo::TransmitEvent> ||
-                  std::is_same_v<T, undo::TransmitEndEvent> || std::is_same_v<T, undo::NodeColorChangeEvent>) {
-      auto node = nodes.find(arg.event.nodeId);
-      if (node == nodes.end())
-        return false;
+    // The event which set the value we are returning to,
+    // unset if it is still the initial value
+    const auto previous = events.previousChange(eventIndex - 1u);
 
-      if constexpr (std::is_same_v<T, undo::NodeModelChangeEvent>)
-        node->second.handle(arg, models);
-      else
-        node->second.handle(arg);
+    if constexpr (std::is_same_v<T, parser::MoveEvent> || std::is_same_v<T, SceneEventStore::NodeModelChange> ||
+                  std::is_same_v<T, parser::NodeOrientationChangeEvent> ||
+                  std::is_same_v<T, parser::NodeColorChangeEvent> || std::is_same_v<T, parser::TransmitEvent> ||
+                  std::is_same_v<T, parser::TransmitEndEvent>) {
+      auto node = nodes.find(arg.nodeId);
+      const auto initialState = initial.nodes.find(arg.nodeId);
 
-      updatedNodes.push_back(node->second.getNs3Model().id);
+      // Events for missing Nodes are discarded when they're handled,
+      // so there is nothing to undo
+      if (node == nodes.end() || initialState == initial.nodes.end())
+        return true;
+      const auto &state = initialState->second;
+
+      if constexpr (std::is_same_v<T, parser::MoveEvent>) {
+        node->second.undoMove(previous ? events.get<T>(*previous).targetPosition : state.position);
+      } else if constexpr (std::is_same_v<T, SceneEventStore::NodeModelChange>) {
+        if (previous)
+          node->second.undoModelChange(events.get<T>(*previous).model, models);
+        else
+          node->second.undoModelChange(keyframeModels[state.model], models);
+      } else if constexpr (std::is_same_v<T, parser::NodeOrientationChangeEvent>) {
+        auto orientation = state.orientation;
+        if (previous) {
+          const auto &target = events.get<T>(*previous).targetOrientation;
+          orientation = glm::vec3(target[0], target[2], -target[1]);
+        }
+
+        node->second.undoOrientationChange(orientation);
+      } else if constexpr (std::is_same_v<T, parser::NodeColorChangeEvent>) {
+        auto color = arg.type == parser::NodeColorChangeEvent::ColorType::Base ? state.baseColor : state.highlightColor;
+        if (previous) {
+          const auto target = events.get<T>(*previous).targetColor;
+          color = target ? std::optional{toRenderColor(target.value())} : std::nullopt;
+        }
+
+        node->second.undoColorChange(arg.type, color);
+      } else if constexpr (std::is_same_v<T, parser::TransmitEvent>) {
+        node->second.undoTransmit(arg);
+      } else if constexpr (std::is_same_v<T, parser::TransmitEndEvent>) {
+        node->second.undoTransmitEnd(arg);
+      }
 
-      events.emplace_front(arg.event);
+      updatedNodes.push_back(arg.nodeId);
       return true;
-    }
+    } else if constexpr (std::is_same_v<T, parser::DecorationMoveEvent> ||
+                         std::is_same_v<T, parser::DecorationOrientationChangeEvent>) {
+      auto decoration = decorations.find(arg.decorationId);
+      const auto initialState = initial.decorations.find(arg.decorationId);
 
-    if constexpr (std::is_same_v<T, undo::DecorationMoveEvent> ||
-                  std::is_same_v<T, undo::DecorationOrientationChangeEvent>) {
-      auto decoration = decorations.find(arg.event.decorationId);
-      if (decoration == decorations.end())
-        return false;
-      decoration->second.handle(arg);
+      // Events for missing Decorations are discarded when they're handled,
+      // so there is nothing to undo
+      if (decoration == decorations.end() || initialState == initial.decorations.end())
+        return true;
+      const auto &state = initialState->second;
+
+      if constexpr (std::is_same_v<T, parser::DecorationMoveEvent>) {
+        decoration->second.undoMove(previous ? toRenderCoordinate(events.get<T>(*previous).targetPosition)
+                                             : state.position);
+      } else {
+        auto orientation = state.orientation;
+        if (previous) {
+          const auto &target = events.get<T>(*previous).targetOrientation;
+          orientation = glm::vec3(target[0], target[2], -target[1]);
+        }
+
+        decoration->second.undoOrientationChange(orientation);
+      }
+      refitDecoration(arg.decorationId);
 
-      events.emplace_front(arg.event);
       return true;
-    }
+    } else if constexpr (std::is_same_v<T, parser::LogicalLinkCreate> ||
+                         std::is_same_v<T, parser::LogicalLinkUpdate>) {
+      std::optional<parser::LogicalLink> state;
+      if (previous) {
+        // Links may be changed by either a create or update
+        state = events.visit(*previous, [](auto &&e) -> parser::LogicalLink {
+          using Previous = std::decay_t<decltype(e)>;
+
+          if constexpr (std::is_same_v<Previous, parser::LogicalLinkCreate>)
+            return e.model;
+          else if constexpr (std::is_same_v<Previous, parser::LogicalLinkUpdate>)
+            return parser::LogicalLink{e.id, e.nodes, e.color, e.active, e.diameter};
+          else
+            return {};
+        });
+      } else {
+        const auto id = [&arg]() {
+          if constexpr (std::is_same_v<T, parser::LogicalLinkCreate>)
+            return arg.model.id;
+          else
+            return arg.id;
+        }();
+
+        const auto initialLink = initial.logicalLinks.find(id);
+        if (initialLink != initial.logicalLinks.end())
+          state = initialLink->second;
+      }
 
-    if constexpr (std::is_same_v<T, undo::LogicalLinkCreate>) {
-      logicalLinks.erase(arg.event.model.id);
-      events.emplace_front(arg.event);
-      return true;
-    }
-    if constexpr (std::is_same_v<T, undo::LogicalLinkUpdate>) {
-      auto link = logicalLinks.find(arg.event.id);
-      if (link == logicalLinks.end()) {
-        std::cerr << "Logical link update undo event references Logical Link which does not exist: ID [" << arg.event.id
-                  << "] discarding event\n";
-        return true;
+      if constexpr (std::is_same_v<T, parser::LogicalLinkCreate>) {
+        // Return to the link this one replaced, if there was one
+        if (state)
+          logicalLinks.insert_or_assign(arg.model.id, LogicalLink{state.value(), linkCylinderInfo});
+        else
+          logicalLinks.erase(arg.model.id);
+      } else {
+        auto link = logicalLinks.find(arg.id);
+
+        // Updates for missing links are discarded when they're handled,
+        // so there is nothing to undo
+        if (link != logicalLinks.end() && state)
+          link->second.undoUpdate(state.value());
       }
 
-      link->second.handle(arg);
-      events.emplace_front(arg.event);
       return true;
     }
 
     return false;
   };
 
-  while (!undoEvents.empty() && std::visit(handleUndoEvent, undoEvents.back())) {
-    undoEvents.pop_back();
+  while (eventIndex > 0u && events.visit(eventIndex - 1u, undoEvent)) {
+    eventIndex--;
+  }
+
+  removeDuplicates(updatedNodes);
+  for (const auto id : updatedNodes) {
+    refitNode(id);
   }
 
   if (!updatedNodes.isEmpty())
     emit nodesUpdated(updatedNodes);
 }
 
+void SceneWidget::buildKeyframes() {
+  keyframes.clear();
+  keyframeModels.clear();
+
+  // Keep the number of keyframes bounded for very large scenarios
+  keyframeInterval = std::max<std::size_t>(10'000u, events.size() / 500u);
+
+  // Few distinct models are used, so a search is cheaper than hashing each path
+  auto internModel = [this](std::string_view model) {
+    const auto iter = std::find(keyframeModels.begin(), keyframeModels.end(), model);
+    if (iter != keyframeModels.end())
+      return static_cast<std::size_t>(iter - keyframeModels.begin());
+
+    keyframeModels.emplace_back(model);
+    return keyframeModels.size() - 1u;
+  };
+
+  // The initial keyframe is the scene before any events,
+  // so it is always at or before any time we may seek to
+  keyframe::SceneKeyframe current;
+  current.time = std::numeric_limits<parser::nanoseconds>::min();
+  current.eventIndex = 0u;
+
+  for (const auto &[id, node] : nodes) {
+    const auto &model = node.getModel();
+
+    keyframe::NodeState state;
+    state.position = node.getNs3Model().position;
+    state.orientation = model.getRotate();
+    state.baseColor = model.getBaseColor();
+    state.highlightColor = model.getHighlightColor();
+    state.model = internModel(node.getNs3Model().model);
+    current.nodes.try_emplace(id, state);
+  }
+
+  for (const auto &[id, decoration] : decorations) {
+    const auto &model = decoration.getModel();
+    current.decorations.try_emplace(id, keyframe::DecorationState{model.getPosition(), model.getRotate()});
+  }
+
+  for (const auto &[id, link] : logicalLinks) {
+    current.logicalLinks.try_emplace(id, link.getModel());
+  }
+
+  keyframes.emplace_back(current);
+
+  // What changed since the last keyframe,
+  // so most keyframes only need to hold those
+  std::unordered_set<unsigned int> changedNodes;
+  std::unordered_set<unsigned int> changedDecorations;
+  std::unordered_set<parser::LogicalLink::LinkId> changedLinks;
+
+  // Mirrors the event handlers in `Node`, `Decoration` & `LogicalLink`
+  // without touching any of the rendered objects
+  auto apply = [&current, &internModel, &changedNodes, &changedDecorations, &changedLinks](auto &&e) {
+    using T = std::decay_t<decltype(e)>;
+
+    if constexpr (std::is_same_v<T, parser::DecorationMoveEvent> ||
+                  std::is_same_v<T, parser::DecorationOrientationChangeEvent>) {
+      auto decoration = current.decorations.find(e.decorationId);
+      if (decoration == current.decorations.end())
+        return;
+      changedDecorations.insert(e.decorationId);
+
+      if constexpr (std::is_same_v<T, parser::DecorationMoveEvent>)
+        decoration->second.position = toRenderCoordinate(e.targetPosition);
+      else
+        decoration->second.orientation =
+            glm::vec3(e.targetOrientation[0], e.targetOrientation[2], -e.targetOrientation[1]);
+    } else if constexpr (std::is_same_v<T, parser::LogicalLinkCreate>) {
+      current.logicalLinks.insert_or_assign(e.model.id, e.model);
+      changedLinks.insert(e.model.id);
+    } else if constexpr (std::is_same_v<T, parser::LogicalLinkUpdate>) {
+      auto link = current.logicalLinks.find(e.id);
+      if (link == current.logicalLinks.end())
+        return;
+      changedLinks.insert(e.id);
+
+      link->second.nodes = e.nodes;
+      link->second.active = e.active;
+      link->second.color = e.color;
+      link->second.diameter = e.diameter;
+    } else {
+      // Everything else is a Node event
+      auto node = current.nodes.find(e.nodeId);
+      if (node == current.nodes.end())
+        return;
+      changedNodes.insert(e.nodeId);
+      auto &state = node->second;
+
+      if constexpr (std::is_same_v<T, parser::MoveEvent>) {
+        state.position = e.targetPosition;
+      } else if constexpr (std::is_same_v<T, SceneEventStore::NodeModelChange>) {
+        state.model = internModel(e.model);
+      } else if constexpr (std::is_same_v<T, parser::NodeOrientationChangeEvent>) {
+        state.orientation = glm::vec3(e.targetOrientation[0], e.targetOrientation[2], -e.targetOrientation[1]);
+      } else if constexpr (std::is_same_v<T, parser::NodeColorChangeEvent>) {
+        std::optional<glm::vec3> color;
+        if (e.targetColor)
+          color = toRenderColor(e.targetColor.value());
+
+        if (e.type == parser::NodeColorChangeEvent::ColorType::Base)
+          state.baseColor = color;
+        else
+          state.highlightColor = color;
+      } else if constexpr (std::is_same_v<T, parser::TransmitEvent>) {
+        state.transmit = e;
+      } else if constexpr (std::is_same_v<T, parser::TransmitEndEvent>) {
+        state.transmit.reset();
+      }
+    }
+  };
+
+  for (std::size_t i = 0u; i < events.size(); i++) {
+    events.visit(i, apply);
+
+    if ((i + 1u) % keyframeInterval != 0u)
+      continue;
+
+    current.time = events.time(i);
+    current.eventIndex = i + 1u;
+
+    if (keyframes.size() % completeKeyframeInterval == 0u) {
+      keyframes.emplace_back(current);
+    } else {
+      keyframe::SceneKeyframe changes;
+      changes.complete = false;
+      changes.time = current.time;
+      changes.eventIndex = current.eventIndex;
+
+      for (const auto id : changedNodes)
+        changes.nodes.try_emplace(id, current.nodes.at(id));
+
+      for (const auto id : changedDecorations)
+        changes.decorations.try_emplace(id, current.decorations.at(id));
+
+      for (const auto id : changedLinks)
+        changes.logicalLinks.try_emplace(id, current.logicalLinks.at(id));
+
+      keyframes.emplace_back(std::move(changes));
+    }
+
+    changedNodes.clear();
+    changedDecorations.clear();
+    changedLinks.clear();
+  }
+}
+
+std::vector<keyframe::SceneKeyframe>::const_iterator SceneWidget::findKeyframe(parser::nanoseconds time) const {
+  auto iter = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+                               [](parser::nanoseconds value, const keyframe::SceneKeyframe &keyframe) {
+                                 return value < keyframe.time;
+                               });
+
+  if (iter == keyframes.begin())
+    return keyframes.end();
+
+  return iter - 1;
+}
+
+void SceneWidget::restoreKeyframe(std::vector<keyframe::SceneKeyframe>::const_iterator keyframe) {
+  // Keyframes which only hold changes are applied
+  // over the complete one before them. The first keyframe is always complete
+  auto complete = keyframe;
+  while (!complete->complete)
+    complete--;
+
+  auto state = *complete;
+  for (auto iter = complete + 1; iter <= keyframe; iter++)
+    state.apply(*iter);
+
+  QVector<unsigned int> updatedNodes;
+
+  for (const auto &[id, nodeState] : state.nodes) {
+    auto node = nodes.find(id);
+    if (node == nodes.end())
+      continue;
+
+    node->second.restore(nodeState, keyframeModels[nodeState.model], models);
+    refitNode(id);
+    updatedNodes.push_back(id);
+  }
+
+  for (const auto &[id, decorationState] : state.decorations) {
+    auto decoration = decorations.find(id);
+    if (decoration == decorations.end())
+      continue;
+
+    decoration->second.restore(decorationState);
+    refitDecoration(id);
+  }
+
+  logicalLinks.clear();
+  for (const auto &[id, link] : state.logicalLinks) {
+    logicalLinks.insert_or_assign(id, LogicalLink{link, linkCylinderInfo});
+  }
+
+  eventIndex = state.eventIndex;
+
+  if (!updatedNodes.isEmpty())
+    emit nodesUpdated(updatedNodes);
+
+  // Play the remaining events up to the current time
+  handleEvents();
+}
+
+bool SceneWidget::seekKeyframe() {
+  const auto keyframe = findKeyframe(simulationTime);
+  if (keyframe == keyframes.end())
+    return false;
+
+  // Only jump forward if we would skip at least a full interval of events
+  if (keyframe->eventIndex > eventIndex) {
+    if (keyframe->eventIndex - eventIndex < keyframeInterval)
+      return false;
+  }
+  // When going back, restoring costs up to an interval of events
+  // to play forward, so only do so when we're further away than that
+  else if (eventIndex - keyframe->eventIndex < keyframeInterval * 2u)
+    return false;
+
+  restoreKeyframe(keyframe);
+  return true;
+}
+
 float SceneWidget::getCameraAutoscale() const {
   // Scale camera movement so we may cross the whole simulation
   // In about 20 real life seconds
@@ -269,6 +639,257 @@ void SceneWidget::applyAutoscaleCameraSpeed() {
   arcCamera.moveSpeedSizeScale = 1.0f;
 }
 
+void SceneWidget::renderPicking() {
+  pickingFbo->bind(GL_FRAMEBUFFER);
+  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // Only the nodes drawn last frame may be clicked
+  for (const auto node : visibleNodes) {
+    if (!node->visible())
+      continue;
+    renderer.queue(*node, false);
+  }
+  renderer.renderPickingNodes();
+
+  glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+  pickingStale = false;
+}
+
+std::optional<unsigned int> SceneWidget::pickNode(const QPointF &position) {
+  if (boundsPicking)
+    return pickNodeBounds(position);
+
+  // We need a current OpenGL context to read from
+  // the picking framebuffer
+  makeCurrent();
+
+  // Draw at most once per frame,
+  // no matter how many times we are asked
+  if (pickingStale)
+    renderPicking();
+
+  // OpenGL starts from the bottom left,
+  // Qt Starts at the top left,
+  // so adjust the Y coordinate accordingly
+  const auto pixel = pickingFbo->read(static_cast<int>(position.x()), height() - static_cast<int>(position.y()));
+  pickingFbo->unbind(GL_READ_FRAMEBUFFER, defaultFramebufferObject());
+  doneCurrent();
+
+  if (!pixel.object || pixel.type != 1u)
+    return {};
+  return pixel.id;
+}
+
+std::optional<unsigned int> SceneWidget::pickNodeBounds(const QPointF &position) const {
+  const auto inverseViewProjection = glm::inverse(projection * viewMatrix());
+
+  // Widget coordinates to normalized device coordinates,
+  // flipped since Qt starts at the top left
+  const auto x = static_cast<float>(position.x() / width() * 2.0 - 1.0);
+  const auto y = static_cast<float>(1.0 - position.y() / height() * 2.0);
+
+  // Cast from the near plane to the far plane
+  auto nearPoint = inverseViewProjection * glm::vec4{x, y, -1.0f, 1.0f};
+  auto farPoint = inverseViewProjection * glm::vec4{x, y, 1.0f, 1.0f};
+  const auto origin = glm::vec3{nearPoint} / nearPoint.w;
+  const auto direction = glm::vec3{farPoint} / farPoint.w - origin;
+
+  std::optional<unsigned int> closest;
+  auto closestDistance = std::numeric_limits<float>::max();
+  nodeBvh.query(origin, direction, [this, &origin, &direction, &closest, &closestDistance](unsigned int id) {
+    const auto node = nodes.find(id);
+    if (node == nodes.end() || !node->second.visible())
+      return;
+
+    const auto distance = node->second.getModel().intersect(origin, direction);
+    if (distance && distance.value() < closestDistance) {
+      closestDistance = distance.value();
+      closest = id;
+    }
+  });
+
+  return closest;
+}
+
+glm::mat4 SceneWidget::viewMatrix() const {
+  if (cameraType == SettingsManager::CameraType::FirstPerson)
+    return camera.view_matrix();
+  return arcCamera.viewMatrix();
+}
+
+void SceneWidget::refitNode(unsigned int nodeId) {
+  const auto node = nodes.find(nodeId);
+  if (node == nodes.end())
+    return;
+
+  const auto bounds = worldBounds(node->second.getModel());
+  const auto proxy = nodeProxies.find(nodeId);
+  if (proxy == nodeProxies.end())
+    nodeProxies.try_emplace(nodeId, nodeBvh.insert(bounds, nodeId));
+  else
+    nodeBvh.move(proxy->second, bounds);
+
+  // Wired links are drawn to the Node, so they move with it
+  const auto links = wiredLinksByNode.find(nodeId);
+  if (links == wiredLinksByNode.end())
+    return;
+
+  for (const auto index : links->second) {
+    wiredLinkBvh.move(wiredLinkProxies[index], wiredLinkBounds(wiredLinks[index]));
+  }
+}
+
+void SceneWidget::refitDecoration(unsigned int decorationId) {
+  const auto decoration = decorations.find(decorationId);
+  if (decoration == decorations.end())
+    return;
+
+  const auto bounds = worldBounds(decoration->second.getModel());
+  const auto proxy = decorationProxies.find(decorationId);
+  if (proxy == decorationProxies.end())
+    decorationProxies.try_emplace(decorationId, decorationBvh.insert(bounds, decorationId));
+  else
+    decorationBvh.move(proxy->second, bounds);
+}
+
+void SceneWidget::cull(const Frustum &frustum) {
+  visibleNodes.clear();
+  visibleDecorations.clear();
+  visibleBuildings.clear();
+  visibleAreas.clear();
+  visibleWiredLinks.clear();
+  cullingStats.query = {};
+
+  nodeBvh.query(
+      frustum,
+      [this](unsigned int id) {
+        const auto node = nodes.find(id);
+        if (node != nodes.end())
+          visibleNodes.push_back(&node->second);
+      },
+      cullingStats.query);
+
+  decorationBvh.query(
+      frustum,
+      [this](unsigned int id) {
+        const auto decoration = decorations.find(id);
+        if (decoration != decorations.end())
+          visibleDecorations.push_back(&decoration->second);
+      },
+      cullingStats.query);
+
+  buildingBvh.query(
+      frustum,
+      [this](unsigned int index) {
+        visibleBuildings.push_back(&buildings[index]);
+      },
+      cullingStats.query);
+
+  areaBvh.query(
+      frustum,
+      [this](unsigned int index) {
+        visibleAreas.push_back(&areas[index]);
+      },
+      cullingStats.query);
+
+  // Back in the order they were allocated, so buildings & areas
+  // next to each other in the batches are drawn as one range
+  std::sort(visibleBuildings.begin(), visibleBuildings.end());
+  std::sort(visibleAreas.begin(), visibleAreas.end());
+
+  wiredLinkBvh.query(
+      frustum,
+      [this](unsigned int index) {
+        visibleWiredLinks.push_back(&wiredLinks[index]);
+      },
+      cullingStats.query);
+
+  cullingStats.nodes = {visibleNodes.size(), nodes.size()};
+  cullingStats.decorations = {visibleDecorations.size(), decorations.size()};
+  cullingStats.buildings = {visibleBuildings.size(), buildings.size()};
+  cullingStats.areas = {visibleAreas.size(), areas.size()};
+  cullingStats.wiredLinks = {visibleWiredLinks.size(), wiredLinks.size()};
+}
+
+void SceneWidget::queueLabels(const glm::mat4 &viewProjection) {
+  labelCandidates.clear();
+  cullingStats.labels = {};
+
+  using LabelRenderMode = SettingsManager::LabelRenderMode;
+  if (renderLabels == LabelRenderMode::Never)
+    return;
+
+  const auto halfWidth = static_cast<float>(width()) / 2.0f;
+  const auto halfHeight = static_cast<float>(height()) / 2.0f;
+
+  for (const auto visibleNode : visibleNodes) {
+    const auto &node = *visibleNode;
+    if (!node.visible())
+      continue;
+
+    if (renderLabels == LabelRenderMode::EnabledOnly && !node.getNs3Model().labelEnabled)
+      continue;
+    cullingStats.labels.total++;
+
+    const auto anchor = node.getTop() + labelOffset;
+    const auto clip = viewProjection * glm::vec4{anchor, 1.0f};
+
+    // Behind the camera
+    if (clip.w <= 0.0f)
+      continue;
+
+    // Labels always face the camera,
+    // so their size on the screen only depends on their distance
+    const glm::vec2 pixelsPerUnit{projection[0][0] * halfWidth / clip.w * labelScale,
+                                  projection[1][1] * halfHeight / clip.w * labelScale};
+    const auto &bounds = node.getBannerRenderInfo().backgroundBounds;
+    if ((bounds.w - bounds.y) * pixelsPerUnit.y < minLabelHeight)
+      continue;
+
+    const glm::vec2 screenAnchor{(clip.x / clip.w + 1.0f) * halfWidth, (clip.y / clip.w + 1.0f) * halfHeight};
+    labelCandidates.push_back({&node, anchor, clip.w, screenAnchor + glm::vec2{bounds.x, bounds.y} * pixelsPerUnit,
+                               screenAnchor + glm::vec2{bounds.z, bounds.w} * pixelsPerUnit});
+  }
+
+  // Nearer labels take priority when they overlap
+  std::sort(labelCandidates.begin(), labelCandidates.end(),
+            [](const LabelCandidate &left, const LabelCandidate &right) {
+              return left.depth < right.depth;
+            });
+
+  labelGrid.reset(width(), height());
+  for (const auto &candidate : labelCandidates) {
+    if (!labelGrid.tryPlace(candidate.screenMin, candidate.screenMax))
+      continue;
+
+    renderer.queueLabel(candidate.node->getBannerRenderInfo(), candidate.anchor);
+    cullingStats.labels.visible++;
+  }
+}
+
+void SceneWidget::updateCullingStats() {
+  if (cullingStatsLabel.isHidden())
+    return;
+
+  const auto line = [](const QString &name, const CullCount &count) {
+    return QStringLiteral("%1%2 / %3\n").arg(name, -15).arg(count.visible, 7).arg(count.total);
+  };
+
+  auto text = QStringLiteral("Culling        visible / total\n");
+  text += line("Nodes", cullingStats.nodes);
+  text += line("Decorations", cullingStats.decorations);
+  text += line("Buildings", cullingStats.buildings);
+  text += line("Areas", cullingStats.areas);
+  text += line("Wired links", cullingStats.wiredLinks);
+  text += line("Logical links", cullingStats.logicalLinks);
+  text += line("Labels", cullingStats.labels);
+  text += QStringLiteral("BVH boxes tested: %1").arg(cullingStats.query.visited);
+
+  cullingStatsLabel.setText(text);
+  cullingStatsLabel.adjustSize();
+}
+
 void SceneWidget::initializeGL() {
   if (!initializeOpenGLFunctions()) {
     std::cerr << "Failed OpenGL functions\n";
@@ -335,15 +956,39 @@ void SceneWidget::initializeGL() {
   pickingFbo = std::make_unique<PickingFramebuffer>(openGl, width(), height());
   pickingFbo->unbind(GL_FRAMEBUFFER, defaultFramebufferObject());
 
-  // Cheap hack to get Qt to repaint at a reasonable rate
-  // Seems to only work with the old connect syntax
-  QObject::connect(&timer, SIGNAL(timeout()), this, SLOT(update()));
-  timer.start(1000 / 60); // roughly 60 times per second
+  // Only started while animating, see the end of `paintGL()`
+  QObject::connect(&timer, &QTimer::timeout, this, [this]() {
+    update();
+  });
+  timer.setInterval(1000 / targetFrameRate);
 
   frameTimer.start();
 }
 
 void SceneWidget::paintGL() {
+  // Swap in the models read since the last frame for their placeholders
+  const auto loadedModels = models.uploadLoaded();
+  for (const auto &loaded : loadedModels) {
+    for (auto &[_, node] : nodes) {
+      node.modelLoaded(loaded);
+    }
+
+    for (auto &[_, decoration] : decorations) {
+      decoration.modelLoaded(loaded);
+    }
+  }
+
+  // The placeholders had the bounds of the fallback model
+  if (!loadedModels.empty()) {
+    for (const auto &[id, _] : nodes) {
+      refitNode(id);
+    }
+
+    for (const auto &[id, _] : decorations) {
+      refitDecoration(id);
+    }
+  }
+
   if (playMode == PlayMode::Play) {
     if (timeStep > 0LL)
       handleEvents();
@@ -351,44 +996,44 @@ void SceneWidget::paintGL() {
       handleUndoEvents();
   }
 
-  // Picking
-  pickingFbo->bind(GL_FRAMEBUFFER);
-  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  for (auto &[key, node] : nodes) {
-    if (!node.visible())
-      continue;
-    renderer.renderPickingNode(node.getNs3Model().id, node.getModel());
-  }
-
-  glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
-  // end Picking
+  // The picking framebuffer is only drawn when read
+  pickingStale = true;
 
+  // If we were idle, the last frame was drawn before
+  // a key was pressed, so there is no movement to catch up on
+  const auto frameTime = timer.isActive() ? static_cast<float>(frameTimer.elapsed()) : 0.0f;
   switch (cameraType) {
   case SettingsManager::CameraType::FirstPerson:
-    camera.move(static_cast<float>(frameTimer.elapsed()));
+    camera.move(frameTime);
     renderer.use(camera);
     break;
   case SettingsManager::CameraType::ArcBall:
-    arcCamera.move(static_cast<float>(frameTimer.elapsed()));
+    arcCamera.move(frameTime);
     renderer.use(arcCamera);
     break;
   }
 
+  const auto viewProjection = projection * viewMatrix();
+  const Frustum frustum{viewProjection};
+  cull(frustum);
+
   glClearColor(clearColorGl[0], clearColorGl[1], clearColorGl[2], 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   renderer.endTransparent();
   if (renderSkybox)
     renderer.render(*skyBox);
 
-  for (auto &[key, node] : nodes) {
+  for (const auto node : visibleNodes) {
+    if (!node->visible())
+      continue;
+    renderer.queue(*node, selectedNode.has_value() && node->getNs3Model().id == selectedNode.value());
+  }
+  renderer.renderNodes();
+
+  // Trails reach past the bounds of their Node, so they are not culled
+  for (const auto &[_, node] : nodes) {
     if (!node.visible())
       continue;
-    if (selectedNode.has_value())
-      renderer.render(node, key == selectedNode.value());
-    else
-      renderer.render(node, false);
 
     using MotionTrailRenderMode = SettingsManager::MotionTrailRenderMode;
     if (renderMotionTrails == MotionTrailRenderMode::Always ||
@@ -396,6 +1041,7 @@ void SceneWidget::paintGL() {
       renderer.renderTrail(node.getTrailBuffer(), node.getTrailColor());
   }
 
+  cullingStats.logicalLinks = {};
   for (auto &[_, logicalLink] : logicalLinks) {
     const auto &model = logicalLink.getModel();
 
@@ -418,6 +1064,14 @@ void SceneWidget::paintGL() {
     const auto &node1 = node1It->second;
     const auto &node2 = node2It->second;
 
+    // Logical links follow their Nodes every frame,
+    // so test them directly rather than keeping them in a tree
+    cullingStats.logicalLinks.total++;
+    const auto linkBounds = Aabb::fromPoints(node1.getCenter(), node2.getCenter()).expanded(model.diameter);
+    if (!frustum.intersects(linkBounds))
+      continue;
+    cullingStats.logicalLinks.visible++;
+
     // TODO: find a way to make a component-wise offset
     // TODO: Cache offset and calculate on location/scale change
     const auto offset = std::max(node1.getModel().getLinkOffset(), node2.getModel().getLinkOffset());
@@ -426,29 +1080,29 @@ void SceneWidget::paintGL() {
     renderer.render(logicalLink);
   }
 
-  for (auto &[key, decoration] : decorations) {
-    renderer.render(decoration.getModel());
+  for (const auto decoration : visibleDecorations) {
+    renderer.render(decoration->getModel());
   }
 
   if (renderFloor)
     renderer.render(*floor);
 
-  renderer.render(areas);
+  renderer.render(visibleAreas);
 
   if (buildingRenderMode == SettingsManager::BuildingRenderMode::Opaque)
-    renderer.render(buildings);
+    renderer.render(visibleBuildings);
   // else in the transparent section
 
   if (renderBuildingOutlines) {
     // Black outlines for opaque buildings
     // White for transparent
     if (buildingRenderMode == SettingsManager::BuildingRenderMode::Opaque)
-      renderer.renderOutlines(buildings, glm::vec3{0.0f, 0.0f, 0.0f});
+      renderer.renderOutlines(visibleBuildings, glm::vec3{0.0f, 0.0f, 0.0f});
     else
-      renderer.renderOutlines(buildings, glm::vec3{1.0f, 1.0f, 1.0f});
+      renderer.renderOutlines(visibleBuildings, glm::vec3{1.0f, 1.0f, 1.0f});
   }
 
-  renderer.render(wiredLinks);
+  renderer.render(visibleWiredLinks);
 
   // Keep this next to `startTransparent()`
   // has it's own transparency implementation
@@ -459,25 +1113,16 @@ void SceneWidget::paintGL() {
 
   // Other condition in opaque section
   if (buildingRenderMode == SettingsManager::BuildingRenderMode::Transparent)
-    renderer.render(buildings);
+    renderer.render(visibleBuildings);
 
-  for (const auto &[_, node] : nodes) {
+  for (const auto visibleNode : visibleNodes) {
+    const auto &node = *visibleNode;
     if (!node.visible())
       continue;
 
     const auto &nodeModel = node.getModel();
     renderer.renderTransparent(nodeModel);
 
-    // Name Banner
-    using LabelRenderMode = SettingsManager::LabelRenderMode;
-    if (renderLabels == LabelRenderMode::Always ||
-        (renderLabels == LabelRenderMode::EnabledOnly && node.getNs3Model().labelEnabled))
-      renderer.renderFont(node.getBannerRenderInfo(), node.getTop(), labelScale);
-    // `renderFont` ends with us in light transparent mode,
-    // so make sure we're back in dark mode, since other transparent
-    // items assume that mode
-    renderer.startTransparentDark();
-
     const auto &transmit = node.getTransmitInfo();
     if (transmit.isTransmitting && transmit.startTime <= simulationTime &&
         transmit.startTime + transmit.duration >= simulationTime) {
@@ -490,21 +1135,72 @@ void SceneWidget::paintGL() {
     }
   }
 
+  // Name Banners
+  queueLabels(viewProjection);
+  renderer.renderLabels(labelScale);
+
+  // `renderLabels` may end with us in light transparent mode,
+  // so make sure we're back in dark mode, since other transparent
+  // items assume that mode
   renderer.startTransparentDark();
-  for (auto &[key, decoration] : decorations) {
-    renderer.renderTransparent(decoration.getModel());
+  for (const auto decoration : visibleDecorations) {
+    renderer.renderTransparent(decoration->getModel());
   }
   renderer.endTransparent();
   frameTimer.restart();
+  updateCullingStats();
+
+  if (playMode == PlayMode::Play)
+    advancePlayback();
+
+  // Keep drawing while the scene changes by itself,
+  // otherwise wait for the next change to `update()`
+  if (!isAnimating())
+    timer.stop();
+  else if (!timer.isActive())
+    timer.start();
+}
+
+bool SceneWidget::isAnimating() const {
+  return playMode == PlayMode::Play || camera.isMoving() || arcCamera.isMoving() || models.isLoading();
+}
+
+double SceneWidget::targetPlaybackRate() const {
+  const auto perSecond = realTimePlayback ? timeStep : timeStep * targetFrameRate;
+  return static_cast<double>(perSecond) / 1'000'000'000.0;
+}
+
+void SceneWidget::advancePlayback() {
+  auto increment = timeStep;
+  if (realTimePlayback) {
+    // Scale the step by the real time this frame took,
+    // events up to the new time are all applied next frame
+    const auto elapsed = std::min(static_cast<parser::nanoseconds>(playbackClock.nsecsElapsed()), maxFrameCatchUp);
+    playbackClock.restart();
+
+    const auto exactIncrement =
+        static_cast<double>(timeStep) * static_cast<double>(elapsed) / 1'000'000'000.0 + incrementRemainder;
+    increment = static_cast<parser::nanoseconds>(exactIncrement);
+    incrementRemainder = exactIncrement - static_cast<double>(increment);
+  }
+
+  rateAdvanced += increment;
+  const auto rateElapsed = rateClock.nsecsElapsed();
+  if (rateElapsed >= rateInterval) {
+    emit playbackRateChanged(static_cast<double>(rateAdvanced) / static_cast<double>(rateElapsed),
+                             targetPlaybackRate());
+    rateAdvanced = 0LL;
+    rateClock.restart();
+  }
 
-  if (playMode == PlayMode::Paused)
+  if (increment == 0LL)
     return;
 
-  simulationTime += timeStep;
-  emit timeChanged(simulationTime, timeStep);
+  simulationTime += increment;
+  emit timeChanged(simulationTime, increment);
 
-  const auto pastEnd = timeStep > 0LL && simulationTime >= config.endTime;
-  const auto pastBeginning = timeStep < 0LL && simulationTime < 0LL;
+  const auto pastEnd = increment > 0LL && simulationTime >= config.endTime;
+  const auto pastBeginning = increment < 0LL && simulationTime < 0LL;
   if ((pastEnd || pastBeginning) && playMode == PlayMode::Play) {
     pause();
 
@@ -522,18 +1218,21 @@ void SceneWidget::resizeGL(int w, int h) {
   updatePerspective();
   glViewport(0, 0, w, h);
   pickingFbo->resize(w, h);
+  pickingStale = true;
 }
 
 void SceneWidget::keyPressEvent(QKeyEvent *event) {
   QWidget::keyPressEvent(event);
   camera.handle_keypress(event->key());
   arcCamera.handleKeyPress(event->key());
+  update();
 }
 
 void SceneWidget::keyReleaseEvent(QKeyEvent *event) {
   QWidget::keyReleaseEvent(event);
   camera.handle_keyrelease(event->key());
   arcCamera.handleKeyRelease(event->key());
+  update();
 }
 
 void SceneWidget::mousePressEvent(QMouseEvent *event) {
@@ -617,6 +1316,7 @@ void SceneWidget::wheelEvent(QWheelEvent *event) {
     delta = numDegrees.y();
 
   arcCamera.wheel(delta);
+  update();
   QOpenGLWidget::wheelEvent(event);
 }
 
@@ -624,15 +1324,7 @@ void SceneWidget::mouseMoveEvent(QMouseEvent *event) {
   QWidget::mouseMoveEvent(event);
 
   if (clickAction == ClickAction::None) {
-    makeCurrent();
-    // OpenGL starts from the bottom left,
-    // Qt Starts at the top left,
-    // so adjust the Y coordinate accordingly
-    const auto itemUnderCursor = pickingFbo->read(event->position().x(), height() - event->position().y());
-    pickingFbo->unbind(GL_READ_FRAMEBUFFER, defaultFramebufferObject());
-    doneCurrent();
-
-    if (itemUnderCursor.object && itemUnderCursor.type == 1u)
+    if (pickNode(event->position()))
       setCursor(Qt::PointingHandCursor);
     else if (cursor().shape() == Qt::PointingHandCursor)
       unsetCursor();
@@ -652,26 +1344,18 @@ void SceneWidget::mouseMoveEvent(QMouseEvent *event) {
   } else /* ArcBall */ {
     arcCamera.mouseMove(dx, dy);
   }
+  update();
 
   QCursor::setPos(mapToGlobal(initialCursorPosition.toPoint()));
 }
 
 void SceneWidget::contextMenuEvent(QContextMenuEvent *event) {
-  // We need a current OpenGL context to read from
-  // the picking framebuffer
-  makeCurrent();
-
-  // OpenGL starts from the bottom left,
-  // Qt Starts at the top left,
-  // so adjust the Y coordinate accordingly
-  const auto selected = pickingFbo->read(event->x(), height() - event->y());
-  pickingFbo->unbind(GL_READ_FRAMEBUFFER, defaultFramebufferObject());
-  doneCurrent();
+  const auto selected = pickNode(event->pos());
 
   QMenu menu;
-  if (selected.object) {
+  if (selected) {
     menu.addAction("Describe", [this, &selected]() {
-      emit spawnNodeDetailWidget(selected.id);
+      emit spawnNodeDetailWidget(selected.value());
     });
   }
 
@@ -714,6 +1398,12 @@ SceneWidget::SceneWidget(QWidget *parent, const Qt::WindowFlags &f) : QOpenGLWid
   setResourcePath(resourceDirSetting.value());
 
   applyAutoscaleCameraSpeed();
+
+  // Drawn by Qt over the scene
+  cullingStatsLabel.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  cullingStatsLabel.setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: white; padding: 4px; }");
+  cullingStatsLabel.move(8, 8);
+  cullingStatsLabel.hide();
 }
 
 SceneWidget::~SceneWidget() {
@@ -746,23 +1436,44 @@ void SceneWidget::setConfiguration(parser::GlobalConfiguration configuration) {
   const auto speedScale = getCameraAutoscale();
   camera.setMoveSpeedSizeScale(speedScale);
   arcCamera.moveSpeedSizeScale = speedScale;
+  update();
 }
 
 void SceneWidget::reset() {
   areas.clear();
   buildings.clear();
+  renderer.resetStaticGeometry();
   nodes.clear();
   decorations.clear();
   wiredLinks.clear();
   logicalLinks.clear();
   events.clear();
-  undoEvents.clear();
+  eventIndex = 0u;
+  keyframes.clear();
+  keyframeModels.clear();
   selectedNode.reset();
+
+  nodeBvh.clear();
+  decorationBvh.clear();
+  buildingBvh.clear();
+  areaBvh.clear();
+  wiredLinkBvh.clear();
+  nodeProxies.clear();
+  decorationProxies.clear();
+  wiredLinkProxies.clear();
+  wiredLinksByNode.clear();
+  visibleNodes.clear();
+  visibleDecorations.clear();
+  visibleBuildings.clear();
+  visibleAreas.clear();
+  visibleWiredLinks.clear();
+
   fontManager.reset();
   simulationTime = 0.0;
 
   camera.setMoveSpeedSizeScale(1.0f);
   arcCamera.moveSpeedSizeScale = 1.0f;
+  update();
 }
 
 void SceneWidget::add(const std::vector<parser::Area> &areaModels, const std::vector<parser::Building> &buildingModels,
@@ -777,23 +1488,38 @@ void SceneWidget::add(const std::vector<parser::Area> &areaModels, const std::ve
   areas.reserve(areaModels.size());
   for (const auto &area : areaModels) {
     areas.emplace_back(renderer.allocate(area), area);
+
+    if (area.points.empty())
+      continue;
+
+    // Borders are drawn outside the points
+    const auto first = toRenderCoordinate(area.points.front());
+    Aabb bounds{first, first};
+    for (const auto &point : area.points) {
+      const auto converted = toRenderCoordinate(point);
+      bounds = Aabb::merge(bounds, {converted, converted});
+    }
+    areaBvh.insert(bounds.expanded(0.5f), static_cast<unsigned int>(areas.size() - 1u));
   }
 
   buildings.reserve(buildingModels.size());
   for (const auto &building : buildingModels) {
     buildings.emplace_back(renderer.allocate(building), building);
+    buildingBvh.insert(Aabb::fromPoints(toRenderCoordinate(building.min), toRenderCoordinate(building.max)),
+                       static_cast<unsigned int>(buildings.size() - 1u));
   }
 
   decorations.reserve(decorationModels.size());
   for (const auto &decoration : decorationModels) {
-    decorations.try_emplace(decoration.id, Model{models.load(decoration.model)}, decoration);
+    decorations.try_emplace(decoration.id, Model{models.request(decoration.model)}, decoration);
+    refitDecoration(decoration.id);
   }
 
   nodes.reserve(nodeModels.size());
   const auto functions = QOpenGLVersionFunctionsFactory::get<QOpenGLFunctions_3_3_Core>(context());
   const auto trailLength = settings.get<int>(SettingsManager::Key::RenderMotionTrailLength).value();
   for (const auto &node : nodeModels) {
-    nodes.try_emplace(node.id, Model{models.load(node.model)}, node,
+    nodes.try_emplace(node.id, Model{models.request(node.model)}, node,
                       renderer.allocateTrailBuffer(functions, trailLength), fontManager.allocate(node.name));
   }
 
@@ -816,8 +1542,20 @@ void SceneWidget::add(const std::vector<parser::Area> &areaModels, const std::ve
       node->second.addWiredLink(&newLink);
     }
 
-    if (ignoreLink)
+    if (ignoreLink) {
       wiredLinks.erase(wiredLinks.end() - 1);
+      continue;
+    }
+
+    const auto index = wiredLinks.size() - 1u;
+    wiredLinkProxies.emplace_back(wiredLinkBvh.insert(wiredLinkBounds(newLink), static_cast<unsigned int>(index)));
+    for (const auto nodeId : link.nodes) {
+      wiredLinksByNode[nodeId].emplace_back(index);
+    }
+  }
+
+  for (const auto &[id, _] : nodes) {
+    refitNode(id);
   }
 
   logicalLinks.reserve(parserLogicalLinks.size());
@@ -836,6 +1574,7 @@ void SceneWidget::add(const std::vector<parser::Area> &areaModels, const std::ve
   }
 
   doneCurrent();
+  update();
 }
 
 void SceneWidget::previewModel(const std::string &modelPath) {
@@ -862,6 +1601,7 @@ void SceneWidget::previewModel(const std::string &modelPath) {
   }
 
   decorations.try_emplace(0u, previewedModel, parser::Decoration{});
+  refitDecoration(0u);
 
   // Put the camera slightly away from the loaded model
   // accounting for how large the model is
@@ -875,6 +1615,7 @@ void SceneWidget::previewModel(const std::string &modelPath) {
   camera.setPosition(position);
   camera.resetRotation();
   doneCurrent();
+  update();
 }
 
 void SceneWidget::focusNode(uint32_t nodeId) {
@@ -904,6 +1645,7 @@ void SceneWidget::focusNode(uint32_t nodeId) {
   } else {
     arcCamera.target = node.getModel().getPosition();
   }
+  update();
 }
 
 const Node &SceneWidget::getNode(unsigned int nodeId) {
@@ -917,8 +1659,17 @@ const Node &SceneWidget::getNode(unsigned int nodeId) {
   return iter->second;
 }
 
-void SceneWidget::enqueueEvents(const std::vector<parser::SceneEvent> &e) {
-  events.insert(events.end(), e.begin(), e.end());
+void SceneWidget::enqueueEvents(std::vector<parser::SceneEvent> &&e) {
+  events.append(std::move(e));
+
+  // Read the models Nodes change to ahead of time,
+  // so they are usually ready by the time they are shown
+  for (const auto &model : events.getModels()) {
+    models.prefetch(model);
+  }
+
+  buildKeyframes();
+  update();
 }
 
 void SceneWidget::resetCamera() {
@@ -928,6 +1679,7 @@ void SceneWidget::resetCamera() {
   } else {
     arcCamera.reset();
   }
+  update();
 }
 
 Camera &SceneWidget::getCamera() {
@@ -946,8 +1698,10 @@ void SceneWidget::updatePerspective() {
   else
     fov = arcCamera.fieldOfView;
 
-  renderer.setPerspective(
-      glm::perspective(glm::radians(fov), static_cast<float>(width()) / static_cast<float>(height()), 0.1f, 1000.0f));
+  projection =
+      glm::perspective(glm::radians(fov), static_cast<float>(width()) / static_cast<float>(height()), 0.1f, 1000.0f);
+  renderer.setPerspective(projection);
+  update();
 }
 
 void SceneWidget::setResourcePath(const QString &value) {
@@ -957,6 +1711,11 @@ void SceneWidget::setResourcePath(const QString &value) {
 
 void SceneWidget::play() {
   playMode = PlayMode::Play;
+  playbackClock.start();
+  incrementRemainder = 0.0;
+  rateClock.start();
+  rateAdvanced = 0LL;
+  update();
 
   emit playing();
 }
@@ -965,6 +1724,7 @@ void SceneWidget::pause() {
   playMode = PlayMode::Paused;
 
   emit paused();
+  emit playbackRateChanged(0.0, targetPlaybackRate());
 }
 
 void SceneWidget::setTime(parser::nanoseconds value) {
@@ -973,10 +1733,13 @@ void SceneWidget::setTime(parser::nanoseconds value) {
   simulationTime = value;
   const auto diff = simulationTime - oldTime;
 
-  if (diff > 0LL)
-    handleEvents();
-  else
-    handleUndoEvents();
+  if (!seekKeyframe()) {
+    if (diff > 0LL)
+      handleEvents();
+    else
+      handleUndoEvents();
+  }
+  update();
 
   emit timeChanged(simulationTime, diff);
 }
@@ -985,20 +1748,31 @@ void SceneWidget::setTimeStep(parser::nanoseconds value) {
   timeStep = value;
 }
 
+void SceneWidget::setRealTimePlayback(bool value) {
+  realTimePlayback = value;
+
+  // Do not count the time spent in the other mode
+  playbackClock.start();
+  incrementRemainder = 0.0;
+}
+
 QSize SceneWidget::sizeHint() const {
   return {640, 480};
 }
 
 void SceneWidget::setCameraType(const SettingsManager::CameraType value) {
   cameraType = value;
+  update();
 }
 
 void SceneWidget::setSkyboxRenderState(bool enable) {
   renderSkybox = enable;
+  update();
 }
 
 void SceneWidget::setFloorRenderState(bool enable) {
   renderFloor = enable;
+  update();
 }
 
 void SceneWidget::setClearColor(const QColor &value) {
@@ -1007,36 +1781,48 @@ void SceneWidget::setClearColor(const QColor &value) {
   clearColorGl[0] = static_cast<float>(clearColor.redF());
   clearColorGl[1] = static_cast<float>(clearColor.greenF());
   clearColorGl[2] = static_cast<float>(clearColor.blueF());
+  update();
 }
 
 void SceneWidget::setBuildingRenderMode(SettingsManager::BuildingRenderMode mode) {
   buildingRenderMode = mode;
+  update();
 }
 
 void SceneWidget::setBuildingRenderOutlines(bool enable) {
   renderBuildingOutlines = enable;
+  update();
 }
 
 void SceneWidget::setRenderGrid(bool enable) {
   renderGrid = enable;
+  update();
 }
 void SceneWidget::changeGridStepSize(int stepSize) {
   makeCurrent();
   // Keep the same square size, but change the grid step
   renderer.resize(*coordinateGrid, coordinateGrid->getRenderInfo().squareSize, stepSize);
   doneCurrent();
+  update();
 }
 
 void SceneWidget::setRenderTrails(SettingsManager::MotionTrailRenderMode value) {
   renderMotionTrails = value;
+  update();
 }
 
 void SceneWidget::setRenderLabels(SettingsManager::LabelRenderMode value) {
   renderLabels = value;
+  update();
 }
 
 void SceneWidget::setLabelScale(float value) {
   labelScale = value;
+  update();
+}
+
+void SceneWidget::setBoundsPicking(bool enable) {
+  boundsPicking = enable;
 }
 
 void SceneWidget::setCameraMoveSpeed(const float value) {
@@ -1057,10 +1843,18 @@ void SceneWidget::setSelectedNode(unsigned int nodeId) {
   }
 
   selectedNode = nodeId;
+  update();
 }
 
 void SceneWidget::clearSelectedNode() {
   selectedNode.reset();
+  update();
+}
+
+void SceneWidget::setShowCullingStats(bool show) {
+  cullingStatsLabel.setVisible(show);
+  updateCullingStats();
+  update();
 }
 
 } // namespace netsimulyzer
@@ -47,11 +47,15 @@
 #include "../../render/shader/Shader.h"
 #include "../../render/texture/TextureCache.h"
 #include "../../settings/SettingsManager.h"
-#include "../../util/undo-events.h"
+#include "../../util/keyframe.h"
+#include "../../util/scene-event-store.h"
 #include "src/group/link/LogicalLink.h"
 #include "src/group/link/WiredLink.h"
 #include "src/render/camera/ArcCamera.h"
+#include "src/render/culling/BoundingVolumeHierarchy.h"
+#include "src/render/culling/Frustum.h"
 #include "src/render/font/FontManager.h"
+#include "src/render/font/LabelGrid.h"
 #include "src/render/framebuffer/PickingFramebuffer.h"
 #include "src/render/helper/CoordinateGrid.h"
 #include "src/render/helper/SkyBox.h"
@@ -59,6 +63,7 @@
 #include <QElapsedTimer>
 #include <QFile>
 #include <QKeyEvent>
+#include <QLabel>
 #include <QMainWindow>
 #include <QMouseEvent>
 #include <QOpenGLDebugLogger>
@@ -67,7 +72,6 @@
 #include <QOpenGLWidget>
 #include <QTimer>
 #include <array>
-#include <deque>
 #include <glm/glm.hpp>
 #include <iostream>
 #include <memory>
@@ -95,6 +99,11 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
   ModelCache models{textures};
   FontManager fontManager{textures};
   Renderer renderer{models, textures, fontManager};
+
+  /**
+   * Requests a frame at `targetFrameRate` while the scene is animating.
+   * Stopped while idle, so changes `update()` the widget themselves
+   */
   QTimer timer{this};
   QElapsedTimer frameTimer;
   SettingsManager::LabelRenderMode renderLabels =
@@ -102,6 +111,7 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
   float labelScale = settings.get<float>(SettingsManager::Key::RenderLabelScale).value();
   bool renderSkybox = settings.get<bool>(SettingsManager::Key::RenderSkybox).value();
   bool renderFloor = settings.get<bool>(SettingsManager::Key::RenderFloor).value();
+  bool boundsPicking = settings.get<bool>(SettingsManager::Key::RenderBoundsPicking).value();
   bool renderGrid = settings.get<bool>(SettingsManager::Key::RenderGrid).value();
   bool renderBuildingOutlines = settings.get<bool>(SettingsManager::Key::RenderBuildingOutlines).value();
   SettingsManager::MotionTrailRenderMode renderMotionTrails =
@@ -115,6 +125,18 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
 
   std::unique_ptr<PickingFramebuffer> pickingFbo;
 
+  /**
+   * Flag indicating the scene has been drawn since
+   * `pickingFbo` was last rendered, so it must be redrawn
+   * before it is read
+   */
+  bool pickingStale{true};
+
+  /**
+   * The projection matrix last given to the `renderer`
+   */
+  glm::mat4 projection{1.0f};
+
   DirectionalLight mainLight;
   std::unique_ptr<SkyBox> skyBox;
   std::unique_ptr<Floor> floor;
@@ -128,11 +150,78 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
 
   /**
    * Amount of time to advance/rewind `simulationTime`
-   * per frame.
+   * per frame, or per second with `realTimePlayback`
    */
   parser::nanoseconds timeStep =
       settings.get<parser::nanoseconds>(SettingsManager::Key::PlaybackTimeStepPreference).value();
 
+  /**
+   * The rate `update()` is requested at while animating
+   */
+  const int targetFrameRate{60};
+
+  /**
+   * Advance by `timeStep` each second of real time,
+   * rather than each frame, so slow frames do not slow playback
+   */
+  bool realTimePlayback = settings.get<bool>(SettingsManager::Key::PlaybackRealTime).value();
+
+  /**
+   * Real time since the time was last advanced with `realTimePlayback`
+   */
+  QElapsedTimer playbackClock;
+
+  /**
+   * The most real time a single frame may advance by with `realTimePlayback`,
+   * so a long stall (e.g. a modal dialog) does not skip ahead
+   */
+  const parser::nanoseconds maxFrameCatchUp{1'000'000'000LL};
+
+  /**
+   * The part of an increment with `realTimePlayback` smaller than 1ns,
+   * carried to the next frame so small rates still advance
+   */
+  double incrementRemainder{0.0};
+
+  /**
+   * Real time since the achieved rate was last reported
+   */
+  QElapsedTimer rateClock;
+
+  /**
+   * Simulation time advanced since `rateClock` was started
+   */
+  parser::nanoseconds rateAdvanced{0LL};
+
+  /**
+   * Real time between `playbackRateChanged()` signals
+   */
+  const parser::nanoseconds rateInterval{500'000'000LL};
+
+  /**
+   * Get the rate playback is trying to reach
+   *
+   * @return
+   * The target, in simulated seconds per second of real time
+   */
+  [[nodiscard]] double targetPlaybackRate() const;
+
+  /**
+   * Advance `simulationTime` for a frame of playback,
+   * and report the achieved rate when due
+   */
+  void advancePlayback();
+
+  /**
+   * Check if the scene changes without any input,
+   * and so should be redrawn every frame
+   *
+   * @return
+   * True while playing, moving the camera with the keyboard,
+   * or waiting on models to load
+   */
+  [[nodiscard]] bool isAnimating() const;
+
   parser::nanoseconds simulationTime{};
 
   std::vector<Area> areas;
@@ -144,9 +233,157 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
 
   std::optional<unsigned int> selectedNode;
 
+  /**
+   * Visible & total counts of one kind of item
+   * after culling, for the debug overlay
+   */
+  struct CullCount {
+    std::size_t visible{0u};
+    std::size_t total{0u};
+  };
+
+  /**
+   * Results of the last `cull()`
+   */
+  struct CullingStats {
+    CullCount nodes;
+    CullCount decorations;
+    CullCount buildings;
+    CullCount areas;
+    CullCount wiredLinks;
+    CullCount logicalLinks;
+
+    /**
+     * Labels drawn, out of those which would have been
+     * without the distance & overlap checks
+     */
+    CullCount labels;
+    BoundingVolumeHierarchy::QueryStats query;
+  };
+
+  /**
+   * Trees of the bounds of the items in the scene, for culling against the view.
+   * Nodes & decorations are keyed by ID,
+   * buildings, areas & wired links by their index in their vector.
+   * Items which move are refit as they are changed by events
+   */
+  BoundingVolumeHierarchy nodeBvh{1.0f};
+  BoundingVolumeHierarchy decorationBvh{1.0f};
+  BoundingVolumeHierarchy buildingBvh;
+  BoundingVolumeHierarchy areaBvh;
+  BoundingVolumeHierarchy wiredLinkBvh{1.0f};
+
+  std::unordered_map<unsigned int, BoundingVolumeHierarchy::ProxyId> nodeProxies;
+  std::unordered_map<unsigned int, BoundingVolumeHierarchy::ProxyId> decorationProxies;
+
+  /**
+   * Proxies of the wired links, in the order of `wiredLinks`
+   */
+  std::vector<BoundingVolumeHierarchy::ProxyId> wiredLinkProxies;
+
+  /**
+   * Indices in `wiredLinks` of the links attached to each Node, by Node ID
+   */
+  std::unordered_map<unsigned int, std::vector<std::size_t>> wiredLinksByNode;
+
+  /**
+   * The items found by the last `cull()`.
+   * Kept between frames, so culling does not allocate
+   */
+  std::vector<Node *> visibleNodes;
+  std::vector<Decoration *> visibleDecorations;
+  std::vector<const Building *> visibleBuildings;
+  std::vector<const Area *> visibleAreas;
+  std::vector<const WiredLink *> visibleWiredLinks;
+
+  CullingStats cullingStats;
+
+  /**
+   * A label which passed the distance check,
+   * waiting to be placed on the `labelGrid`
+   */
+  struct LabelCandidate {
+    const Node *node;
+
+    /**
+     * The bottom-center of the label, in world coordinates
+     */
+    glm::vec3 anchor;
+
+    /**
+     * Distance of `anchor` from the camera, along the view direction
+     */
+    float depth;
+
+    /**
+     * The corners of the label on the screen, in pixels
+     */
+    glm::vec2 screenMin;
+    glm::vec2 screenMax;
+  };
+
+  /**
+   * Labels which may be drawn this frame.
+   * Kept between frames, so finding them does not allocate
+   */
+  std::vector<LabelCandidate> labelCandidates;
+
+  /**
+   * Screen-space grid of the labels placed this frame,
+   * so overlapping labels are dropped
+   */
+  LabelGrid labelGrid;
+
+  // TODO: Maybe make this configurable?
+  /**
+   * Offset of labels from the top of their Node
+   */
+  const glm::vec3 labelOffset{0.0f, 2.0f, 0.0f};
+
+  /**
+   * Labels shorter than this on the screen, in pixels,
+   * are too far away to read and are not drawn
+   */
+  const float minLabelHeight{6.0f};
+
+  /**
+   * Overlay showing `cullingStats`, hidden by default
+   */
+  QLabel cullingStatsLabel{this};
+
   PlayMode playMode = PlayMode::Paused;
-  std::deque<parser::SceneEvent> events;
-  std::deque<undo::SceneUndoEvent> undoEvents;
+  SceneEventStore events;
+
+  /**
+   * Index of the next event in `events` to apply.
+   * Events before this index have been applied.
+   * Undoing an event only moves this back, the state
+   * before the event is found from the earlier events
+   */
+  std::size_t eventIndex{0u};
+
+  /**
+   * Snapshots of the scene taken every `keyframeInterval` events,
+   * sorted by time. Built when the events are enqueued.
+   * Only every `completeKeyframeInterval`th keyframe holds the whole scene,
+   * the rest hold what changed since the one before them
+   */
+  std::vector<keyframe::SceneKeyframe> keyframes;
+
+  /**
+   * Model paths referenced by `keyframes`
+   */
+  std::vector<std::string> keyframeModels;
+
+  /**
+   * Number of events between each keyframe
+   */
+  std::size_t keyframeInterval{10'000u};
+
+  /**
+   * Number of keyframes between each complete keyframe
+   */
+  const std::size_t completeKeyframeInterval{16u};
 
 #ifndef NDEBUG
   QOpenGLDebugLogger glLogger{this};
@@ -155,6 +392,44 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
   void handleEvents();
   void handleUndoEvents();
 
+  /**
+   * Build `keyframes` from the current scene state
+   * and the full list of `events`.
+   * Should be called before any events are applied
+   */
+  void buildKeyframes();
+
+  /**
+   * Finds the latest keyframe at or before `time`
+   *
+   * @param time
+   * The time to search for
+   *
+   * @return
+   * An iterator to the keyframe, or `keyframes.end()` if there is none
+   */
+  [[nodiscard]] std::vector<keyframe::SceneKeyframe>::const_iterator findKeyframe(parser::nanoseconds time) const;
+
+  /**
+   * Replace the scene state with the one at `keyframe`,
+   * then apply the events between the keyframe and `simulationTime`
+   *
+   * @param keyframe
+   * The keyframe to restore. Should be at or before `simulationTime`
+   */
+  void restoreKeyframe(std::vector<keyframe::SceneKeyframe>::const_iterator keyframe);
+
+  /**
+   * Seek to `simulationTime` from the nearest keyframe,
+   * if doing so is cheaper than applying/undoing events
+   * from the current position
+   *
+   * @return
+   * True if a keyframe was restored,
+   * false if the caller should handle the events itself
+   */
+  bool seekKeyframe();
+
   /**
    * Calculate the autoscale multiplier for
    * the camera to cross the scenario in a
@@ -166,6 +441,86 @@ class SceneWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core {
   float getCameraAutoscale() const;
   void applyAutoscaleCameraSpeed();
 
+  /**
+   * Draw the IDs of the visible nodes into `pickingFbo`.
+   * The OpenGL context must be current
+   */
+  void renderPicking();
+
+  /**
+   * Finds the node drawn at `position`,
+   * rendering the picking framebuffer first if it is stale.
+   * Uses `pickNodeBounds()` instead when bounding box picking is enabled
+   *
+   * @param position
+   * The position in the widget, from the top left
+   *
+   * @return
+   * The ID of the node, unset if there is none
+   */
+  std::optional<unsigned int> pickNode(const QPointF &position);
+
+  /**
+   * Finds the closest node whose bounding box is under `position`,
+   * without drawing anything.
+   * Cheaper than `pickNode()`, but less precise
+   *
+   * @param position
+   * The position in the widget, from the top left
+   *
+   * @return
+   * The ID of the node, unset if there is none
+   */
+  [[nodiscard]] std::optional<unsigned int> pickNodeBounds(const QPointF &position) const;
+
+  /**
+   * @return
+   * The view matrix of the camera in use
+   */
+  [[nodiscard]] glm::mat4 viewMatrix() const;
+
+  /**
+   * Update the bounds of a Node, and the wired links attached to it,
+   * in the culling trees. Adds the Node if it is not tracked yet
+   *
+   * @param nodeId
+   * The ID of the Node which changed
+   */
+  void refitNode(unsigned int nodeId);
+
+  /**
+   * Update the bounds of a Decoration in the culling trees.
+   * Adds the Decoration if it is not tracked yet
+   *
+   * @param decorationId
+   * The ID of the Decoration which changed
+   */
+  void refitDecoration(unsigned int decorationId);
+
+  /**
+   * Find the items inside `frustum`,
+   * filling the visible lists & `cullingStats`
+   *
+   * @param frustum
+   * The volume visible to the camera
+   */
+  void cull(const Frustum &frustum);
+
+  /**
+   * Queue the labels of the visible Nodes with the `renderer`.
+   * Labels too small to read are skipped, then the rest are placed
+   * nearest first, skipping any overlapping a label already placed
+   *
+   * @param viewProjection
+   * The projection matrix multiplied by the view matrix for this frame
+   */
+  void queueLabels(const glm::mat4 &viewProjection);
+
+  /**
+   * Show `cullingStats` in the overlay, if it is visible
+   */
+  void updateCullingStats();
+
 protected:
   void initializeGL() override;
   void paintGL() override;
@@ -219,7 +574,14 @@ public:
    */
   const Node &getNode(unsigned int nodeId);
 
-  void enqueueEvents(const std::vector<parser::SceneEvent> &e);
+  /**
+   * Take ownership of events to be shown in the scene.
+   * Keyframes are rebuilt afterwards
+   *
+   * @param e
+   * The events to add, sorted by time
+   */
+  void enqueueEvents(std::vector<parser::SceneEvent> &&e);
   void resetCamera();
 
   /**
@@ -258,6 +620,15 @@ public:
    */
   void setTime(parser::nanoseconds value);
   void setTimeStep(parser::nanoseconds value);
+
+  /**
+   * Choose how the time step is applied during playback
+   *
+   * @param value
+   * True to advance by the time step each second of real time,
+   * False to advance by it each rendered frame
+   */
+  void setRealTimePlayback(bool value);
   QSize sizeHint() const override;
 
   /**
@@ -349,16 +720,47 @@ public:
    */
   void setLabelScale(float value);
 
+  /**
+   * Change how Nodes under the cursor are found
+   *
+   * @param enable
+   * If true, Nodes are picked by their bounding boxes,
+   * if false, by drawing the picking framebuffer
+   */
+  void setBoundsPicking(bool enable);
+
   void setCameraMoveSpeed(float value);
   void setAutoscaleCameraMoveSpeed(bool value);
 
   void setSelectedNode(unsigned int nodeId);
   void clearSelectedNode();
 
+  /**
+   * Show or hide the overlay with the number
+   * of items drawn after culling
+   *
+   * @param show
+   * True to show the overlay, False to hide it
+   */
+  void setShowCullingStats(bool show);
+
 signals:
   void timeChanged(parser::nanoseconds simulationTime, parser::nanoseconds increment);
   void paused();
   void playing();
+
+  /**
+   * Signal emitted periodically during playback,
+   * and once playback stops
+   *
+   * @param achieved
+   * The rate actually played at, in simulated seconds per second of real time.
+   * 0 once paused
+   *
+   * @param target
+   * The rate playback is trying to reach, in the same units
+   */
+  void playbackRateChanged(double achieved, double target);
   void selectedItemUpdated();
   void nodeSelected(unsigned int nodeId);
   void spawnNodeDetailWidget(unsigned int nodeId);
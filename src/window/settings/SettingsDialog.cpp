@@ -58,6 +58,7 @@ void SettingsDialog::loadSettings() {
   const auto chartDropdownSortOrder =
       settings.get<SettingsManager::ChartDropdownSortOrder>(Key::ChartDropdownSortOrder).value();
   ui.comboSortOrder->setCurrentIndex(ui.comboSortOrder->findData(static_cast<int>(chartDropdownSortOrder)));
+  ui.spinReplotBudget->setValue(settings.get<int>(Key::ChartReplotBudget).value());
 
   ui.checkBoxBuildingOutlines->setChecked(settings.get<bool>(Key::RenderBuildingOutlines).value());
 
@@ -88,6 +89,7 @@ void SettingsDialog::loadSettings() {
   ui.comboLabelRender->setCurrentIndex(ui.comboLabelRender->findData(static_cast<int>(labelRenderMode)));
 
   ui.sliderLabelScale->setValue(static_cast<int>(settings.get<float>(Key::RenderLabelScale).value() * labelScaleScale));
+  ui.checkBoxBoundsPicking->setChecked(settings.get<bool>(Key::RenderBoundsPicking).value());
 
   ui.keyPlay->setKeySequence(*settings.get<int>(Key::SceneKeyPlay));
 
@@ -194,6 +196,7 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent) {
   QObject::connect(ui.buttonResetDown, &QPushButton::clicked, ui.keyDown, &SingleKeySequenceEdit::setDefault);
 
   QObject::connect(ui.buttonResetSortOrder, &QPushButton::clicked, this, &SettingsDialog::defaultChartSortOrder);
+  QObject::connect(ui.buttonResetReplotBudget, &QPushButton::clicked, this, &SettingsDialog::defaultChartReplotBudget);
 
   QObject::connect(ui.buttonResetSkybox, &QPushButton::clicked, this, &SettingsDialog::defaultEnableSkybox);
   QObject::connect(ui.buttonResetFloor, &QPushButton::clicked, this, &SettingsDialog::defaultEnableFloor);
@@ -211,6 +214,7 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent) {
   QObject::connect(ui.buttonResetTrailLength, &QPushButton::clicked, this, &SettingsDialog::defaultTrailsLength);
   QObject::connect(ui.buttonResetShowLabels, &QPushButton::clicked, this, &SettingsDialog::defaultShowLabels);
   QObject::connect(ui.buttonResetLabelScale, &QPushButton::clicked, this, &SettingsDialog::defaultLabelScale);
+  QObject::connect(ui.buttonResetBoundsPicking, &QPushButton::clicked, this, &SettingsDialog::defaultBoundsPicking);
 
   QObject::connect(ui.buttonResetPlay, &QPushButton::clicked, ui.keyPlay, &SingleKeySequenceEdit::setDefault);
   QObject::connect(ui.buttonResetTimeStep, &QPushButton::clicked, this, &SettingsDialog::defaultTimeStep);
@@ -260,6 +264,7 @@ void SettingsDialog::dialogueButtonClicked(QAbstractButton *button) {
     ui.buttonResetDown->click();
 
     ui.buttonResetSortOrder->click();
+    ui.buttonResetReplotBudget->click();
 
     ui.buttonResetSkybox->click();
     ui.buttonResetFloor->click();
@@ -273,6 +278,7 @@ void SettingsDialog::dialogueButtonClicked(QAbstractButton *button) {
     ui.buttonResetGridSize->click();
     ui.buttonResetTrails->click();
     ui.buttonResetTrailLength->click();
+    ui.buttonResetBoundsPicking->click();
 
     ui.buttonResetPlay->click();
     ui.buttonResetTimeStep->click();
@@ -372,6 +378,12 @@ void SettingsDialog::dialogueButtonClicked(QAbstractButton *button) {
       emit chartSortOrderChanged(static_cast<int>(chartSortOrder));
     }
 
+    const auto replotBudget = ui.spinReplotBudget->value();
+    if (replotBudget != settings.get<int>(Key::ChartReplotBudget).value()) {
+      settings.set(Key::ChartReplotBudget, replotBudget);
+      emit chartReplotBudgetChanged(replotBudget);
+    }
+
     // Graphics
 
     const auto samples = ui.comboSamples->currentData().toInt();
@@ -469,6 +481,12 @@ void SettingsDialog::dialogueButtonClicked(QAbstractButton *button) {
       emit labelScaleChanged(labelScale);
     }
 
+    const auto boundsPicking = ui.checkBoxBoundsPicking->isChecked();
+    if (boundsPicking != settings.get<bool>(Key::RenderBoundsPicking)) {
+      settings.set(Key::RenderBoundsPicking, boundsPicking);
+      emit boundsPickingChanged(boundsPicking);
+    }
+
     // Playback
 
     const auto playKey = ui.keyPlay->key();
@@ -557,6 +575,10 @@ void SettingsDialog::defaultChartSortOrder() {
   ui.comboSortOrder->setCurrentIndex(ui.comboSortOrder->findData(defaultValue));
 }
 
+void SettingsDialog::defaultChartReplotBudget() {
+  ui.spinReplotBudget->setValue(settings.getDefault<int>(SettingsManager::Key::ChartReplotBudget));
+}
+
 void SettingsDialog::defaultBackgroundColor() {
   const auto defaultValue = static_cast<int>(
       settings.getDefault<SettingsManager::BackgroundColor>(SettingsManager::Key::RenderBackgroundColor));
@@ -625,6 +647,10 @@ void SettingsDialog::defaultLabelScale() {
       static_cast<int>(settings.getDefault<float>(SettingsManager::Key::RenderLabelScale) * labelScaleScale));
 }
 
+void SettingsDialog::defaultBoundsPicking() {
+  ui.checkBoxBoundsPicking->setChecked(settings.getDefault<bool>(SettingsManager::Key::RenderBoundsPicking));
+}
+
 void SettingsDialog::defaultGridStep() {
   const auto step = settings.getDefault<int>(SettingsManager::Key::RenderGridStep);
   ui.comboGridSize->setCurrentIndex(ui.comboGridSize->findData(step));
@@ -131,6 +131,11 @@ class SettingsDialog : public QDialog {
    */
   void defaultChartSortOrder();
 
+  /**
+   * Set the Chart Replot Budget input to the default value
+   */
+  void defaultChartReplotBudget();
+
   /**
    * Set the Samples input to the default value
    */
@@ -205,6 +210,11 @@ class SettingsDialog : public QDialog {
    */
   void defaultLabelScale();
 
+  /**
+   * Set the Bounding Box Picking checkbox to the default value
+   */
+  void defaultBoundsPicking();
+
   /**
    * Sets the grid step size spinner to its default value
    */
@@ -349,6 +359,14 @@ signals:
    */
   void chartSortOrderChanged(int value);
 
+  /**
+   * Signal emitted when the user changes the Chart replot budget.
+   *
+   * @param value
+   * The time, in milliseconds, each chart may spend replotting per frame
+   */
+  void chartReplotBudgetChanged(int value);
+
   /**
    * Signal emitted when the user changes the
    * Skybox render state
@@ -458,6 +476,16 @@ signals:
    */
   void labelScaleChanged(float value);
 
+  /**
+   * Signal emitted when the user changes
+   * how Nodes under the cursor are found
+   *
+   * @param enable
+   * If true, Nodes are picked by their bounding boxes,
+   * if false, by drawing the picking framebuffer
+   */
+  void boundsPickingChanged(bool enable);
+
   /**
    * Signal emitted when the user saves a new Play/Pause Key
    *